@@ -45,6 +45,7 @@ class ScytheRecipe(ScytheFeatures, ConanFile):
 		"src/*",
 		"include/*",
 		"examples/*",
+		"tools/*",
 		"tests/*"
 	]
 
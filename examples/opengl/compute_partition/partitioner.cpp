@@ -2,6 +2,8 @@
 
 #include "partition_shaders.h"
 
+#include <scythe/opengl/opengl_profiler.h>
+
 static constexpr uint32_t kScanBlock = 1024u; // == local_size_x в scan/add (branching B)
 static constexpr uint32_t kFlatGroup = 256u;  // == local_size_x в flags/scatter
 
@@ -48,47 +50,59 @@ void Partitioner::Partition(uint32_t count, uint32_t source_indices_buffer, uint
 	const unsigned int D = static_cast<unsigned int>(level_sizes_.size()) - 1u; // число scan-уровней
 
 	// --- 1. Флаг непрозрачности -> buf[0] ---
-	glUseProgram(flags_program_.id());
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, source_colors_buffer);
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, level_bufs_[0]);
-	glUniform1ui(locFlagsCount, count);
-	glDispatchCompute(::DivUp(count, kFlatGroup), 1, 1);
-	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	{
+		SCYTHE_GPU_PROFILE_SCOPE("Partition::Flags");
+		glUseProgram(flags_program_.id());
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, source_colors_buffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, level_bufs_[0]);
+		glUniform1ui(locFlagsCount, count);
+		glDispatchCompute(::DivUp(count, kFlatGroup), 1, 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	}
 
 	// --- 2. Down-sweep: block-exclusive-scan на каждом уровне (in place) ---
-	glUseProgram(scan_program_.id());
-	for (unsigned int l = 0; l < D; ++l)
 	{
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, level_bufs_[l]);     // Data
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, level_bufs_[l + 1]); // Sums
-		glUniform1ui(locScanCount, level_sizes_[l]);
-		glDispatchCompute(::DivUp(level_sizes_[l], kScanBlock), 1, 1);
-		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+		SCYTHE_GPU_PROFILE_SCOPE("Partition::Scan");
+		glUseProgram(scan_program_.id());
+		for (unsigned int l = 0; l < D; ++l)
+		{
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, level_bufs_[l]);     // Data
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, level_bufs_[l + 1]); // Sums
+			glUniform1ui(locScanCount, level_sizes_[l]);
+			glDispatchCompute(::DivUp(level_sizes_[l], kScanBlock), 1, 1);
+			glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+		}
 	}
 	// level_bufs_[D][0] == numOpaque (общий итог)
 
 	// --- 3. Up-sweep: прибавляем глобальные смещения блоков ---
-	glUseProgram(add_program_.id());
-	for (int l = static_cast<int>(D) - 2; l >= 0; --l)
 	{
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, level_bufs_[l]);     // Data
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, level_bufs_[l + 1]); // Parent
-		glUniform1ui(locAddCount, level_sizes_[l]);
-		glDispatchCompute(::DivUp(level_sizes_[l], kScanBlock), 1, 1);
-		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+		SCYTHE_GPU_PROFILE_SCOPE("Partition::Add");
+		glUseProgram(add_program_.id());
+		for (int l = static_cast<int>(D) - 2; l >= 0; --l)
+		{
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, level_bufs_[l]);     // Data
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, level_bufs_[l + 1]); // Parent
+			glUniform1ui(locAddCount, level_sizes_[l]);
+			glDispatchCompute(::DivUp(level_sizes_[l], kScanBlock), 1, 1);
+			glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+		}
 	}
 	// level_bufs_[0][i] == число непрозрачных среди [0, i)
 
 	// --- 4. Scatter в правильном порядке ---
-	glUseProgram(scatter_program_.id());
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, level_bufs_[0]); // prefix
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, level_bufs_[D]); // grand total
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, source_indices_buffer);
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, filtered_indices_buffer);
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, source_colors_buffer);
-	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, filtered_colors_buffer);
-	glUniform1ui(locScatterCount, count);
-	glDispatchCompute(::DivUp(count, kFlatGroup), 1, 1);
+	{
+		SCYTHE_GPU_PROFILE_SCOPE("Partition::Scatter");
+		glUseProgram(scatter_program_.id());
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, level_bufs_[0]); // prefix
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, level_bufs_[D]); // grand total
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, source_indices_buffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, filtered_indices_buffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, source_colors_buffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, filtered_colors_buffer);
+		glUniform1ui(locScatterCount, count);
+		glDispatchCompute(::DivUp(count, kFlatGroup), 1, 1);
+	}
 
 	// Результат идёт дальше как EBO + SSBO -> бит на приёмнике:
 	glMemoryBarrier(GL_ELEMENT_ARRAY_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
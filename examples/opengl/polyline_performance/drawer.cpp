@@ -4,6 +4,8 @@
 
 #include "shaders.h"
 
+#include <scythe/opengl/opengl_profiler.h>
+
 QuadDrawer::QuadDrawer(const Viewport* viewport)
 : viewport_(viewport)
 , render_program_()
@@ -90,6 +92,8 @@ void QuadDrawer::Unload()
 }
 void QuadDrawer::Render()
 {
+	SCYTHE_GPU_PROFILE_SCOPE("QuadDrawer::Render");
+
 	ActivateShader();
 
 	glBindVertexArray(vertex_array_object_);
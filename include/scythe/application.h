@@ -57,6 +57,111 @@ namespace scythe {
 		virtual const float GetDesiredFrameRate() const; //!< average frame rate for application that we desire
 		virtual const bool IsBenchmark() const;
 
+		/**
+		 * @brief      Gets the number of warm-up frames in benchmark mode.
+		 * @details    These frames are run but not included into report.
+		 *
+		 * @return     The number of warm-up frames.
+		 */
+		virtual const int GetBenchmarkWarmupFrames() const;
+
+		/**
+		 * @brief      Gets the number of measured frames in benchmark mode.
+		 *
+		 * @return     The number of measured frames.
+		 */
+		virtual const int GetBenchmarkFrames() const;
+
+		/**
+		 * @brief      Gets the benchmark report filename.
+		 *
+		 * @return     The benchmark report filename.
+		 */
+		virtual const char* GetBenchmarkReportFilename() const;
+
+		/**
+		 * @brief      Gets the profiler trace filename.
+		 * @details    Trace is written on exit when profiler is enabled.
+		 *             Return nullptr to disable export.
+		 *
+		 * @return     The profiler trace filename.
+		 */
+		virtual const char* GetProfileTraceFilename() const;
+
+		/**
+		 * @brief      Determines if performance counters should be sampled.
+		 * @details    Counters (instructions, cycles, cache misses, etc.) are added to benchmark
+		 *             report and to profiler zones. Available on Linux only.
+		 *
+		 * @return     True if performance counters are enabled, False otherwise.
+		 */
+		virtual const bool IsPerfCountersEnabled() const;
+
+		/**
+		 * @brief      Determines if hitch watchdog is enabled.
+		 * @details    Watchdog thread reports when main cycle frame lasts longer than stall time.
+		 *
+		 * @return     True if watchdog is enabled, False otherwise.
+		 */
+		virtual const bool IsWatchdogEnabled() const;
+
+		/**
+		 * @brief      Gets the watchdog stall time.
+		 *
+		 * @return     The frame time in seconds after which frame is reported.
+		 */
+		virtual const float GetWatchdogStallTime() const;
+
+		/**
+		 * @brief      Gets the watchdog report filename.
+		 * @details    Reports are appended to this file.
+		 *
+		 * @return     The watchdog report filename.
+		 */
+		virtual const char* GetWatchdogReportFilename() const;
+
+		/**
+		 * @brief      Gets the initial size of per-frame arena buffer of every thread.
+		 * @see        FrameAllocator
+		 *
+		 * @return     The size in bytes.
+		 */
+		virtual const size_t GetFrameArenaSize() const;
+
+		/**
+		 * @brief      Gets the number of frames that per-frame memory stays valid.
+		 * @details    2 makes memory of the previous frame available during the current one.
+		 *
+		 * @return     The number of frames (1 to 3).
+		 */
+		virtual const uint32_t GetFrameArenaCount() const;
+
+		/**
+		 * @brief      Determines if memory usage report is logged at shutdown.
+		 * @details    Leaks are reported regardless of this value.
+		 * @see        ReportMemoryStatistics
+		 *
+		 * @return     True if memory report enabled, False otherwise.
+		 */
+		virtual const bool IsMemoryReportEnabled() const;
+
+		/**
+		 * @brief      Gets the time per frame for finalizing asynchronously loaded resources.
+		 * @see        ResourceManager::Update
+		 *
+		 * @return     The time in seconds.
+		 */
+		virtual const float GetResourceFinalizeBudget() const;
+
+		/**
+		 * @brief      Gets the memory budget of loaded resources.
+		 * @details    Unused resources are cached within the budget, 0 disables caching.
+		 * @see        ResourceManager::SetMemoryBudget
+		 *
+		 * @return     The size in bytes.
+		 */
+		virtual const size_t GetResourceMemoryBudget() const;
+
 	public:
 		void Show();
 		void Hide();
@@ -76,6 +181,8 @@ namespace scythe {
 
 		void Update();
 		void RunMainCycle();
+		void RunBenchmarkCycle();
+		void RenderFrame();
 
 	protected:
 		GraphicsProvider* graphics_provider_;		//!< graphics provider (should be manually created by user)
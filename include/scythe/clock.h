@@ -1,19 +1,21 @@
 #ifndef __SCYTHE_CLOCK_H__
 #define __SCYTHE_CLOCK_H__
 
-#include <chrono>
+#include "types.h"
 
 namespace scythe {
 
 	/**
 	 * @brief      This class describes a clock.
+	 * @details    Time is measured in integer ticks (nanoseconds), so precision doesn't
+	 *             degrade with uptime. On x86 with invariant TSC ticks are computed from
+	 *             rdtsc calibrated once against steady clock, otherwise steady clock is used.
+	 *             Seconds in float are for API edge only.
 	 */
 	class Clock
 	{
-		typedef std::chrono::high_resolution_clock clock;
-		typedef std::chrono::duration<float> seconds;
-		
 	public:
+		static constexpr uint64_t kTicksPerSecond = 1000000000ull;
 
 		/**
 		 * @brief      Constructs a new instance.
@@ -25,6 +27,13 @@ namespace scythe {
 		 */
 		void MakeStartPoint(); //!< makes current time as a start point
 
+		/**
+		 * @brief      Gets difference between current time and start time in ticks
+		 *
+		 * @return     The time difference in nanoseconds.
+		 */
+		uint64_t GetTicks() const;
+
 		/**
 		 * @brief      Gets difference between current time and start time in seconds
 		 *
@@ -32,9 +41,33 @@ namespace scythe {
 		 */
 		float GetTime() const;
 
+		/**
+		 * @brief      Gets the current monotonic time.
+		 *
+		 * @return     The time in nanoseconds from unspecified point.
+		 */
+		static uint64_t Now() noexcept;
+
+		/**
+		 * @brief      Converts ticks to seconds.
+		 *
+		 * @param[in]  ticks  The ticks
+		 *
+		 * @return     The seconds.
+		 */
+		static float ToSeconds(uint64_t ticks);
+
+		/**
+		 * @brief      Converts seconds to ticks.
+		 *
+		 * @param[in]  seconds  The seconds (negative are clamped to zero)
+		 *
+		 * @return     The ticks.
+		 */
+		static uint64_t FromSeconds(float seconds);
+
 	private:
-		std::chrono::time_point<clock> start_time_;
-		mutable std::chrono::time_point<clock> end_time_;
+		uint64_t start_ticks_;
 	};
 
 } // namespace scythe
@@ -0,0 +1,150 @@
+#ifndef __SCYTHE_FRAME_ALLOCATOR_H__
+#define __SCYTHE_FRAME_ALLOCATOR_H__
+
+#include "singleton.h"
+#include "types.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <new>
+#include <cstddef>
+
+namespace scythe {
+
+	/**
+	 * @brief      This class describes a per-frame linear allocator.
+	 * @details    Memory is allocated by bumping a pointer and is never freed individually.
+	 *             Every thread has its own arena with a buffer per frame, so allocation
+	 *             doesn't lock. Memory allocated during a frame stays valid for frames count
+	 *             frames (the current and the previous one for double buffering) and gets
+	 *             reused after that. Buffer that has overflowed is grown to the size used,
+	 *             so steady state frames don't call malloc. Arena of exited thread is
+	 *             reused by the next new thread. Frames are switched by
+	 *             @ref Application at the beginning of main cycle iteration.
+	 */
+	class FrameAllocator final
+	: private ManagedSingleton<FrameAllocator>
+	{
+		friend class ManagedSingleton<FrameAllocator>;
+		friend class Application;
+
+	public:
+		static constexpr uint32_t kMaxFrames = 3;
+
+		/**
+		 * Make GetInstance be accessible.
+		 */
+		using ManagedSingleton<FrameAllocator>::GetInstance;
+
+		/**
+		 * @brief      Allocates memory in the calling thread arena.
+		 *
+		 * @param[in]  size       The size
+		 * @param[in]  alignment  The alignment (power of two)
+		 *
+		 * @return     Pointer to memory or nullptr on failure.
+		 */
+		void * Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		/**
+		 * @brief      Allocates uninitialized array.
+		 *
+		 * @param[in]  count  The number of elements
+		 *
+		 * @tparam     T      The element type
+		 *
+		 * @return     Pointer to the array or nullptr on failure.
+		 */
+		template <typename T>
+		T * Allocate(size_t count)
+		{
+			return static_cast<T *>(Allocate(count * sizeof(T), alignof(T)));
+		}
+
+		/**
+		 * @brief      Gets the number of frames that memory stays valid.
+		 *
+		 * @return     The frames count.
+		 */
+		uint32_t GetFramesCount() const;
+
+		/**
+		 * @brief      Gets the memory allocated by all threads during the current frame.
+		 *
+		 * @return     The used size in bytes.
+		 */
+		size_t GetUsedSize() const;
+
+		/**
+		 * @brief      Gets the memory reserved by all arenas.
+		 *
+		 * @return     The capacity in bytes.
+		 */
+		size_t GetCapacity() const;
+
+	private:
+		struct ThreadArena;
+
+		FrameAllocator();
+		~FrameAllocator();
+
+		void SetParameters(size_t buffer_size, uint32_t frames_count); //!< should be called before any allocation
+		void BeginFrame(); //!< called by main thread at frame boundary
+
+		ThreadArena * GetThreadArena();
+		void ReleaseThreadArena(ThreadArena * arena); //!< called on thread exit
+
+		mutable std::mutex mutex_;
+		std::vector<ThreadArena *> arenas_;		//!< guarded by mutex
+		std::vector<ThreadArena *> free_arenas_;	//!< arenas of exited threads (guarded by mutex)
+		std::atomic<uint64_t> frame_;
+		size_t buffer_size_;						//!< initial size of thread buffer
+		uint32_t frames_count_;
+		const uint32_t generation_;					//!< distinguishes instances for thread local cache
+	};
+
+	/**
+	 * @brief      STL compatible allocator that uses @ref FrameAllocator.
+	 * @details    Deallocation does nothing, so containers should be reserved beforehand
+	 *             and must not outlive the frames count.
+	 */
+	template <typename T>
+	class FrameStlAllocator
+	{
+	public:
+		typedef T value_type;
+
+		FrameStlAllocator() noexcept = default;
+		template <typename U>
+		FrameStlAllocator(const FrameStlAllocator<U>&) noexcept {}
+
+		T * allocate(size_t n)
+		{
+			void * memory = FrameAllocator::GetInstance()->Allocate(n * sizeof(T), alignof(T));
+			if (memory == nullptr)
+				throw std::bad_alloc();
+			return static_cast<T *>(memory);
+		}
+		void deallocate(T *, size_t) noexcept
+		{
+		}
+	};
+
+	template <typename T, typename U>
+	bool operator ==(const FrameStlAllocator<T>&, const FrameStlAllocator<U>&) noexcept
+	{
+		return true;
+	}
+	template <typename T, typename U>
+	bool operator !=(const FrameStlAllocator<T>&, const FrameStlAllocator<U>&) noexcept
+	{
+		return false;
+	}
+
+	template <typename T>
+	using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+
+} // namespace scythe
+
+#endif
\ No newline at end of file
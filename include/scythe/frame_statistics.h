@@ -0,0 +1,138 @@
+#ifndef __SCYTHE_FRAME_STATISTICS_H__
+#define __SCYTHE_FRAME_STATISTICS_H__
+
+#include "types.h"
+
+namespace scythe {
+
+	/**
+	 * @brief      Frame times summary.
+	 */
+	struct FrameTimeSummary
+	{
+		float p50;					//!< median frame time in seconds
+		float p95;					//!< 95th percentile frame time in seconds
+		float p99;					//!< 99th percentile frame time in seconds
+		float max;					//!< maximum frame time in seconds
+		float average;				//!< average frame time in seconds
+		uint32_t frames;			//!< number of frames in window
+		uint32_t hitches;			//!< number of hitches in window
+		uint64_t total_frames;		//!< number of frames since reset
+		uint64_t total_hitches;		//!< number of hitches since reset
+	};
+
+	/**
+	 * @brief      Frame statistics dump callback.
+	 *
+	 * @param[in]  summary    The summary
+	 * @param      user_data  The user data
+	 */
+	typedef void (*FrameStatisticsCallback)(const FrameTimeSummary& summary, void* user_data);
+
+	/**
+	 * @brief      This class describes frame times statistics.
+	 * @details    Frame times are stored in log-linear histogram (HDR-like): each
+	 *             power of two microseconds range is divided into kSubBuckets linear buckets,
+	 *             so relative error is within 1/kSubBuckets. Percentiles are computed over
+	 *             rolling window of last kWindowFrames frames, the histogram of the window
+	 *             is updated incrementally. All memory is fixed, so adding frame doesn't allocate.
+	 */
+	class FrameStatistics final
+	{
+	public:
+		static constexpr uint32_t kSubBucketBits = 4;
+		static constexpr uint32_t kSubBuckets = 1u << kSubBucketBits;
+		static constexpr uint32_t kMaxValueBits = 25;				//!< max tracked value is ~33 seconds
+		static constexpr uint32_t kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBuckets;
+		static constexpr uint32_t kWindowFrames = 1024;
+
+		FrameStatistics();
+
+		/**
+		 * @brief      Adds frame time.
+		 *
+		 * @param[in]  frame_time  The frame time in seconds
+		 */
+		void AddFrame(float frame_time);
+
+		/**
+		 * @brief      Clears all collected data.
+		 */
+		void Reset();
+
+		/**
+		 * @brief      Sets the hitch threshold.
+		 *
+		 * @param[in]  threshold  The frame time in seconds exceeding which frame is considered a hitch
+		 */
+		void SetHitchThreshold(float threshold);
+
+		/**
+		 * @brief      Gets the hitch threshold.
+		 *
+		 * @return     The hitch threshold in seconds.
+		 */
+		float GetHitchThreshold() const;
+
+		/**
+		 * @brief      Sets the dump callback.
+		 *
+		 * @param[in]  callback   The callback (nullptr to disable dumps)
+		 * @param      user_data  The user data
+		 * @param[in]  period     The dump period in seconds
+		 */
+		void SetDumpCallback(FrameStatisticsCallback callback, void* user_data, float period);
+
+		/**
+		 * @brief      Gets the frame time percentile over the window.
+		 *
+		 * @param[in]  percentile  The percentile in range [0, 100]
+		 *
+		 * @return     The frame time in seconds (upper bound of the bucket).
+		 */
+		float GetPercentile(float percentile) const;
+
+		/**
+		 * @brief      Gets the maximum frame time over the window.
+		 *
+		 * @return     The maximum frame time in seconds.
+		 */
+		float GetMaxFrameTime() const;
+
+		/**
+		 * @brief      Gets the number of hitches since reset.
+		 *
+		 * @return     The hitch count.
+		 */
+		uint64_t GetHitchCount() const;
+
+		/**
+		 * @brief      Gets the summary over the window.
+		 *
+		 * @param      summary  The summary
+		 */
+		void GetSummary(FrameTimeSummary* summary) const;
+
+	private:
+		static uint32_t GetBucketIndex(uint32_t value);
+		static uint32_t GetBucketUpperValue(uint32_t index);
+
+		uint32_t buckets_[kBucketCount];		//!< histogram of window frames
+		uint32_t window_[kWindowFrames];		//!< ring of window frame times in microseconds
+		uint32_t window_head_;
+		uint32_t window_count_;
+		uint32_t window_hitches_;
+		uint64_t window_sum_;					//!< sum of window frame times in microseconds
+		uint64_t total_frames_;
+		uint64_t total_hitches_;
+		uint32_t hitch_threshold_;				//!< in microseconds
+
+		FrameStatisticsCallback dump_callback_;
+		void* dump_user_data_;
+		float dump_period_;
+		float dump_time_;						//!< time since last dump
+	};
+
+} // namespace scythe
+
+#endif
\ No newline at end of file
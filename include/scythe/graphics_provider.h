@@ -6,6 +6,9 @@
 
 namespace scythe {
 
+	// Forward declarations
+	class Application;
+
 	/**
 	 * @brief      This class describes a graphics provider.
 	 * @details    Note that its a base class that should be created and 
@@ -14,6 +17,8 @@ namespace scythe {
 	 *             ```cpp
 	 *             graphics_provider_ = new scythe::GraphicsProvider(this);
 	 *             ```
+	 *             Base class itself doesn't use any graphics API, so it can be used 
+	 *             as a null provider for headless applications.
 	 */
 	class GraphicsProvider
 	: public NonCopyable
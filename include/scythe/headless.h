@@ -0,0 +1,37 @@
+#ifndef __SCYTHE_HEADLESS_H__
+#define __SCYTHE_HEADLESS_H__
+
+#ifndef SCYTHE_HEADLESS
+# error "Headless platform should be enabled to use this header"
+#endif
+
+#include "keyboard.h"
+#include "mouse.h"
+
+namespace scythe::headless {
+
+	/**
+	 * Synthetic events for headless platform.
+	 *
+	 * Events are queued and dispatched to application controllers on the next
+	 * platform events polling in the main loop, exactly like native window events.
+	 * Functions are thread safe, so tests may drive application from another thread.
+	 * Events pushed before application run are ignored.
+	 */
+
+	void PushKeyDown(KeyboardKey key, KeyModifiers modifiers = KeyModifiers());
+	void PushKeyUp(KeyboardKey key, KeyModifiers modifiers = KeyModifiers());
+	void PushChar(KeyCode code);
+
+	void PushMouseDown(MouseButton button);
+	void PushMouseUp(MouseButton button);
+	void PushMouseMove(float x, float y); //!< x=[0,w]; y=[0,h]
+	void PushScroll(float delta_x, float delta_y);
+
+	void PushResize(int width, int height);
+	void PushFocus(bool active);
+	void PushClose(); //!< terminates application
+
+} // namespace scythe::headless
+
+#endif
\ No newline at end of file
@@ -1,16 +1,420 @@
 #ifndef __SCYTHE_LOG_H__
 #define __SCYTHE_LOG_H__
 
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "types.h"
+#include "string_id.h"
+
 namespace scythe {
 
+	/**
+	 * @brief      Log message level.
+	 */
+	enum class LogLevel
+	{
+		kDebug,
+		kInfo,
+		kWarning,
+		kError,
+		kCount
+	};
+
+	/**
+	 * @brief      Function that formats message from packed arguments.
+	 *
+	 * @param      buffer  The output buffer
+	 * @param[in]  size    The output buffer size
+	 * @param[in]  format  The printf-like format
+	 * @param[in]  data    The packed arguments
+	 *
+	 * @return     The number of characters like snprintf.
+	 */
+	typedef int (*LogFormatFunc)(char* buffer, size_t size, const char* format, const void* data);
+
+	constexpr size_t kMaxLogArgumentsSize = 1024; //!< maximum size of packed arguments of message
+
+	/**
+	 * @brief      Describes format of binary log message. Created at compile time by SCYTHE_LOG_BINARY.
+	 */
+	struct LogFormatInfo
+	{
+		StringID id;				//!< compile time hash of the format
+		const char* format;
+		const char* signature;		//!< type codes of arguments (see GetLogTypeCode)
+		LogFormatFunc func;			//!< used when binary log file is not set
+	};
+
+	// Binary log file layout (native byte order):
+	// header: magic (8 bytes), version (uint32), pointer size (uint32)
+	// format record: type (uint8), id (uint32), format length (uint16), signature length (uint16), format, signature
+	// message record: type (uint8), id (uint32), level (uint8), timestamp in ns (uint64), data size (uint16), data
+	constexpr char kBinaryLogMagic[8] = {'S', 'C', 'Y', 'B', 'L', 'O', 'G', '\0'};
+	constexpr uint32_t kBinaryLogVersion = 1;
+
+	/**
+	 * @brief      Binary log record type.
+	 */
+	enum class BinaryLogRecord : uint8_t
+	{
+		kFormat = 1,
+		kMessage = 2
+	};
+
+	/**
+	 * @brief      Sets the minimum level of messages to output.
+	 *
+	 * @param[in]  level  The level
+	 */
+	void SetLogLevel(LogLevel level) noexcept;
+
+	/**
+	 * @brief      Gets the minimum level of messages to output.
+	 *
+	 * @return     The level.
+	 */
+	LogLevel GetLogLevel() noexcept;
+
+	/**
+	 * @brief      Sets the maximum rate of messages with the same format per thread.
+	 * @details    Exceeding messages are dropped, their count is reported with the next message.
+	 *
+	 * @param[in]  messages_per_second  The messages per second (0 disables limit)
+	 */
+	void SetLogRateLimit(uint32_t messages_per_second) noexcept;
+
+	/**
+	 * @brief      Sets the file to duplicate output to.
+	 *
+	 * @param[in]  filename  The filename (nullptr to close file)
+	 *
+	 * @return     True on success and false otherwise.
+	 */
+	bool SetLogFile(const char* filename) noexcept;
+
+	/**
+	 * @brief      Sets the file for binary messages.
+	 * @details    Binary messages are formatted as text while file is not set.
+	 *             The file is converted to text by log_decoder tool.
+	 *
+	 * @param[in]  filename  The filename (nullptr to close file)
+	 *
+	 * @return     True on success and false otherwise.
+	 */
+	bool SetBinaryLogFile(const char* filename) noexcept;
+
+	/**
+	 * @brief      Waits until all messages logged before the call are written.
+	 */
+	void FlushLog() noexcept;
+
+	/**
+	 * @brief      Checks level and rate limit of the message. Used by Log.
+	 *
+	 * @param[in]  level   The level
+	 * @param[in]  format  The format
+	 *
+	 * @return     True if message should be logged and false otherwise.
+	 */
+	bool IsLogAllowed(LogLevel level, const char* format) noexcept;
+
+	/**
+	 * @brief      Puts message into the calling thread queue. Used by Log.
+	 *
+	 * @param[in]  level   The level
+	 * @param[in]  format  The format (should have static storage duration)
+	 * @param[in]  func    The format function
+	 * @param[in]  data    The packed arguments
+	 * @param[in]  size    The packed arguments size
+	 */
+	void LogWrite(LogLevel level, const char* format, LogFormatFunc func, const void* data, size_t size) noexcept;
+
+	/**
+	 * @brief      Puts binary message into the calling thread queue. Used by LogBinary.
+	 *
+	 * @param[in]  level   The level
+	 * @param[in]  info    The format information (should have static storage duration)
+	 * @param[in]  data    The packed arguments
+	 * @param[in]  size    The packed arguments size
+	 */
+	void LogWriteBinary(LogLevel level, const LogFormatInfo* info, const void* data, size_t size) noexcept;
+
+	/**
+	 * @brief      Describes how log argument is packed.
+	 * @details    Trivially copyable values are copied as is.
+	 */
+	template <typename T>
+	struct LogArgument
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Log argument should be trivially copyable");
+		static_assert(!std::is_same<T, wchar_t*>::value && !std::is_same<T, const wchar_t*>::value,
+			"Wide strings are not supported by log");
+
+		typedef T StoredType;
+		static constexpr size_t kFixedSize = sizeof(T);
+
+		static void Write(char*& out, size_t& /*string_budget*/, const T& value) noexcept
+		{
+			std::memcpy(out, &value, sizeof(T));
+			out += sizeof(T);
+		}
+		static T Read(const char*& data) noexcept
+		{
+			T value;
+			std::memcpy(&value, data, sizeof(T));
+			data += sizeof(T);
+			return value;
+		}
+	};
+
+	/**
+	 * @brief      Strings are copied, since they may not live until formatting.
+	 */
+	template <>
+	struct LogArgument<const char*>
+	{
+		typedef const char* StoredType;
+		static constexpr size_t kFixedSize = sizeof(uint32_t) + 1; // length and terminating zero
+
+		static void Write(char*& out, size_t& string_budget, const char* value) noexcept
+		{
+			if (value == nullptr)
+				value = "(null)";
+			uint32_t length = static_cast<uint32_t>(std::strlen(value));
+			if (length > string_budget)
+				length = static_cast<uint32_t>(string_budget);
+			string_budget -= length;
+			std::memcpy(out, &length, sizeof(length));
+			out += sizeof(length);
+			std::memcpy(out, value, length);
+			out += length;
+			*out++ = '\0';
+		}
+		static const char* Read(const char*& data) noexcept
+		{
+			uint32_t length;
+			std::memcpy(&length, data, sizeof(length));
+			const char* value = data + sizeof(length);
+			data += sizeof(length) + length + 1;
+			return value;
+		}
+	};
+	template <>
+	struct LogArgument<char*> : public LogArgument<const char*>
+	{
+	};
+
+	/**
+	 * @brief      Packs arguments into buffer.
+	 *
+	 * @param      buffer  The buffer of kMaxLogArgumentsSize bytes
+	 * @param[in]  args    The arguments
+	 *
+	 * @return     The packed size.
+	 */
+	template <typename... Args>
+	size_t LogPack(char* buffer, const Args&... args) noexcept
+	{
+		constexpr size_t kFixedSize = (size_t(0) + ... + LogArgument<std::decay_t<Args>>::kFixedSize);
+		static_assert(kFixedSize <= kMaxLogArgumentsSize, "Too many log arguments");
+		size_t string_budget = kMaxLogArgumentsSize - kFixedSize;
+		char* out = buffer;
+		(LogArgument<std::decay_t<Args>>::Write(out, string_budget, args), ...);
+		return static_cast<size_t>(out - buffer);
+	}
+
+	template <typename Tuple, size_t... I>
+	int LogFormatTuple(char* buffer, size_t size, const char* format, const Tuple& values, std::index_sequence<I...>) noexcept
+	{
+		// Trailing zero is ignored, it just makes call valid for messages without arguments
+		return std::snprintf(buffer, size, format, std::get<I>(values)..., 0);
+	}
+
+	/**
+	 * @brief      Formats message from packed arguments. Called by log thread.
+	 */
+	template <typename... Args>
+	int LogFormat(char* buffer, size_t size, const char* format, const void* data) noexcept
+	{
+		const char* in = static_cast<const char*>(data);
+		// Braced initialization guarantees left to right order of reading
+		std::tuple<typename LogArgument<Args>::StoredType...> values{ LogArgument<Args>::Read(in)... };
+		(void)in; // messages without arguments
+		return LogFormatTuple(buffer, size, format, values, std::index_sequence_for<Args...>{});
+	}
+
+	/**
+	 * @brief      Gets the type code of binary log argument.
+	 * @details    Codes follow Python struct module: b/B, h/H, i/I, q/Q for signed and unsigned
+	 *             integers of 1, 2, 4, 8 bytes, f and d for floating point, p for pointer,
+	 *             s for string. Zero means type isn't supported.
+	 *
+	 * @tparam     T     The argument type
+	 *
+	 * @return     The type code.
+	 */
+	template <typename T>
+	constexpr char GetLogTypeCode() noexcept
+	{
+		if constexpr (std::is_same<T, const char*>::value || std::is_same<T, char*>::value)
+			return 's';
+		else if constexpr (std::is_pointer<T>::value || std::is_null_pointer<T>::value)
+			return 'p';
+		else if constexpr (std::is_enum<T>::value)
+			return GetLogTypeCode<std::underlying_type_t<T>>();
+		else if constexpr (std::is_integral<T>::value)
+		{
+			constexpr bool kSigned = std::is_signed<T>::value;
+			switch (sizeof(T))
+			{
+			case 1: return kSigned ? 'b' : 'B';
+			case 2: return kSigned ? 'h' : 'H';
+			case 4: return kSigned ? 'i' : 'I';
+			case 8: return kSigned ? 'q' : 'Q';
+			default: return '\0';
+			}
+		}
+		else if constexpr (std::is_floating_point<T>::value)
+			return (sizeof(T) == 4) ? 'f' : (sizeof(T) == 8) ? 'd' : '\0';
+		else
+			return '\0';
+	}
+
+	/**
+	 * @brief      Type codes of arguments.
+	 */
+	template <typename... Args>
+	struct LogSignature
+	{
+		static constexpr char value[] = { GetLogTypeCode<Args>()..., '\0' };
+	};
+
+	/**
+	 * @brief      List of argument types. Used by SCYTHE_LOG_BINARY.
+	 */
+	template <typename... Args>
+	struct LogTypeList
+	{
+		static constexpr LogFormatInfo MakeFormatInfo(StringID id, const char* format) noexcept
+		{
+			return LogFormatInfo{ id, format, LogSignature<Args...>::value, &LogFormat<Args...> };
+		}
+	};
+
+	// Used in unevaluated context only
+	template <typename... Args>
+	LogTypeList<std::decay_t<Args>...> LogArgumentTypes(const Args&... args) noexcept;
+
+	/**
+	 * @brief          Outputs message.
+	 * @details        Arguments are just copied on the calling thread, formatting and output
+	 *                 are done by log thread.
+	 *
+	 * @param[in]      level      The level
+	 * @param[in]      format     The printf-like format (should have static storage duration)
+	 * @param[in,opt]  args       Additional arguments
+	 */
+	template <typename... Args>
+	void Log(LogLevel level, const char* format, const Args&... args) noexcept
+	{
+		if (!IsLogAllowed(level, format))
+			return;
+		if constexpr (sizeof...(Args) == 0)
+			LogWrite(level, format, &LogFormat<>, nullptr, 0);
+		else
+		{
+			char buffer[kMaxLogArgumentsSize];
+			const size_t size = LogPack(buffer, args...);
+			LogWrite(level, format, &LogFormat<std::decay_t<Args>...>, buffer, size);
+		}
+	}
+
+	/**
+	 * @brief          Outputs debug message.
+	 *
+	 * @param[in]      format     The printf-like formatted message
+	 * @param[in,opt]  args       Additional arguments
+	 */
+	template <typename... Args>
+	void Debug(const char* format, const Args&... args) noexcept
+	{
+		Log(LogLevel::kDebug, format, args...);
+	}
+
+	/**
+	 * @brief          Outputs info message.
+	 *
+	 * @param[in]      format     The printf-like formatted message
+	 * @param[in,opt]  args       Additional arguments
+	 */
+	template <typename... Args>
+	void Info(const char* format, const Args&... args) noexcept
+	{
+		Log(LogLevel::kInfo, format, args...);
+	}
+
+	/**
+	 * @brief          Outputs warning message.
+	 *
+	 * @param[in]      format     The printf-like formatted message
+	 * @param[in,opt]  args       Additional arguments
+	 */
+	template <typename... Args>
+	void Warning(const char* format, const Args&... args) noexcept
+	{
+		Log(LogLevel::kWarning, format, args...);
+	}
+
 	/**
 	 * @brief          Outputs error message.
 	 *
 	 * @param[in]      format     The printf-like formatted message
-	 * @param[in,opt]  <unnamed>  Additional arguments
+	 * @param[in,opt]  args       Additional arguments
+	 */
+	template <typename... Args>
+	void Error(const char* format, const Args&... args) noexcept
+	{
+		Log(LogLevel::kError, format, args...);
+	}
+
+	/**
+	 * @brief          Outputs binary message. Use SCYTHE_LOG_BINARY instead.
+	 * @details        Only format identifier and raw arguments are written, there is
+	 *                 no rate limit.
+	 *
+	 * @param[in]      level      The level
+	 * @param[in]      info       The format information
+	 * @param[in,opt]  args       Additional arguments
 	 */
-	void Error(const char* format, ...) noexcept;
+	template <typename... Args>
+	void LogBinary(LogLevel level, const LogFormatInfo* info, const Args&... args) noexcept
+	{
+		static_assert(((GetLogTypeCode<std::decay_t<Args>>() != '\0') && ...), "Unsupported binary log argument type");
+		if (static_cast<int>(level) < static_cast<int>(GetLogLevel()))
+			return;
+		if constexpr (sizeof...(Args) == 0)
+			LogWriteBinary(level, info, nullptr, 0);
+		else
+		{
+			char buffer[kMaxLogArgumentsSize];
+			const size_t size = LogPack(buffer, args...);
+			LogWriteBinary(level, info, buffer, size);
+		}
+	}
 
 } // namespace scythe
 
+// Format should be a string literal, its identifier and argument types are resolved at compile time
+#define SCYTHE_LOG_BINARY(level, format, ...) \
+	do { \
+		static constexpr ::scythe::LogFormatInfo scythe_log_format_info = \
+			decltype(::scythe::LogArgumentTypes(__VA_ARGS__))::MakeFormatInfo( \
+				std::integral_constant<::scythe::StringID, ConstexprStringId(format)>::value, format); \
+		::scythe::LogBinary(level, &scythe_log_format_info, ##__VA_ARGS__); \
+	} while (false)
+
 #endif // __SCYTHE_LOG_H__
\ No newline at end of file
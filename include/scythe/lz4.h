@@ -0,0 +1,43 @@
+#ifndef __SCYTHE_LZ4_H__
+#define __SCYTHE_LZ4_H__
+
+#include "types.h"
+
+namespace scythe {
+
+	/**
+	 * @brief      Gets the maximum size of LZ4 block compressed data.
+	 *
+	 * @param[in]  size  The source size
+	 *
+	 * @return     The maximum compressed size.
+	 */
+	size_t Lz4CompressBound(size_t size);
+
+	/**
+	 * @brief      Compresses data into a single LZ4 block (raw block format without frame).
+	 *
+	 * @param[in]  source         The source
+	 * @param[in]  source_size    The source size
+	 * @param      destination    The destination
+	 * @param[in]  capacity       The destination capacity
+	 *
+	 * @return     The compressed size or 0 if destination is too small.
+	 */
+	size_t Lz4Compress(const void* source, size_t source_size, void* destination, size_t capacity);
+
+	/**
+	 * @brief      Decompresses a single LZ4 block. Malformed input is detected.
+	 *
+	 * @param[in]  source            The source
+	 * @param[in]  source_size       The source size
+	 * @param      destination       The destination
+	 * @param[in]  destination_size  The exact decompressed size
+	 *
+	 * @return     True on success and false otherwise.
+	 */
+	bool Lz4Decompress(const void* source, size_t source_size, void* destination, size_t destination_size);
+
+} // namespace scythe
+
+#endif
\ No newline at end of file
@@ -0,0 +1,163 @@
+#ifndef __SCYTHE_MEMORY_TRACKER_H__
+#define __SCYTHE_MEMORY_TRACKER_H__
+
+#include "types.h"
+
+#include <new>
+#include <cstddef>
+
+namespace scythe {
+
+	/**
+	 * @brief      Subsystem that owns allocated memory.
+	 */
+	enum class MemoryTag
+	{
+		kGeneral,
+		kResource,
+		kTime,
+		kFrame,
+		kLog,
+		kProfiler,
+		kHeap,			//!< thread heaps
+		kCount
+	};
+
+	/**
+	 * @brief      Describes memory statistics of a single tag.
+	 */
+	struct MemoryStatistics
+	{
+		size_t current;			//!< bytes in use
+		size_t peak;			//!< maximum bytes in use
+		size_t count;			//!< number of live allocations
+		size_t frame_count;		//!< number of allocations during the last complete frame
+		size_t budget;			//!< bytes limit (0 means unlimited)
+	};
+
+	/**
+	 * @brief      Allocates memory and accounts it to the tag.
+	 *
+	 * @param[in]  size       The size
+	 * @param[in]  tag        The tag
+	 * @param[in]  alignment  The alignment (power of two)
+	 *
+	 * @return     Pointer to memory or nullptr on failure.
+	 */
+	void * TaggedAllocate(size_t size, MemoryTag tag, size_t alignment = alignof(std::max_align_t));
+
+	/**
+	 * @brief      Frees memory allocated by @ref TaggedAllocate.
+	 *
+	 * @param      memory  The memory
+	 */
+	void TaggedFree(void * memory);
+
+	/**
+	 * @brief      Accounts memory allocated elsewhere to the tag. Lock free.
+	 *
+	 * @param[in]  tag   The tag
+	 * @param[in]  size  The size
+	 */
+	void TrackAllocation(MemoryTag tag, size_t size);
+
+	/**
+	 * @brief      Accounts memory freed elsewhere to the tag. Lock free.
+	 *
+	 * @param[in]  tag   The tag
+	 * @param[in]  size  The size
+	 */
+	void TrackDeallocation(MemoryTag tag, size_t size);
+
+	/**
+	 * @brief      Sets the memory budget of the tag.
+	 * @details    Exceeded budget is reported by a warning at frame boundary.
+	 *
+	 * @param[in]  tag     The tag
+	 * @param[in]  budget  The budget in bytes (0 means unlimited)
+	 */
+	void SetMemoryBudget(MemoryTag tag, size_t budget);
+
+	/**
+	 * @brief      Gets the memory statistics of the tag.
+	 *
+	 * @param[in]  tag   The tag
+	 *
+	 * @return     The memory statistics.
+	 */
+	MemoryStatistics GetMemoryStatistics(MemoryTag tag);
+
+	/**
+	 * @brief      Gets the memory tag name.
+	 *
+	 * @param[in]  tag   The tag
+	 *
+	 * @return     The memory tag name.
+	 */
+	const char * GetMemoryTagName(MemoryTag tag);
+
+	/**
+	 * @brief      Completes per frame allocation counts and warns about exceeded budgets.
+	 *             Called by @ref Application at frame boundary.
+	 */
+	void UpdateMemoryStatistics();
+
+	/**
+	 * @brief      Logs current and peak usage of every tag.
+	 */
+	void ReportMemoryStatistics();
+
+	/**
+	 * @brief      Logs memory that is still in use.
+	 * @details    Tags of process lifetime systems (log, profiler, thread heaps) are skipped.
+	 *
+	 * @return     Number of leaked allocations.
+	 */
+	size_t ReportMemoryLeaks();
+
+	/**
+	 * @brief      STL compatible allocator that accounts memory to the tag.
+	 */
+	template <typename T, MemoryTag Tag>
+	class TaggedStlAllocator
+	{
+	public:
+		typedef T value_type;
+
+		template <typename U>
+		struct rebind
+		{
+			typedef TaggedStlAllocator<U, Tag> other;
+		};
+
+		TaggedStlAllocator() noexcept = default;
+		template <typename U>
+		TaggedStlAllocator(const TaggedStlAllocator<U, Tag>&) noexcept {}
+
+		T * allocate(size_t n)
+		{
+			void * memory = TaggedAllocate(n * sizeof(T), Tag, alignof(T));
+			if (memory == nullptr)
+				throw std::bad_alloc();
+			return static_cast<T *>(memory);
+		}
+		void deallocate(T * pointer, size_t) noexcept
+		{
+			TaggedFree(pointer);
+		}
+	};
+
+	template <typename T, typename U, MemoryTag Tag>
+	bool operator ==(const TaggedStlAllocator<T, Tag>&, const TaggedStlAllocator<U, Tag>&) noexcept
+	{
+		return true;
+	}
+	template <typename T, typename U, MemoryTag Tag>
+	bool operator !=(const TaggedStlAllocator<T, Tag>&, const TaggedStlAllocator<U, Tag>&) noexcept
+	{
+		return false;
+	}
+
+} // namespace scythe
+
+#endif
\ No newline at end of file
@@ -7,7 +7,7 @@
 # error "OpenGL should be enabled to use this header"
 #endif
 
-#ifdef SCYTHE_TARGET_WINDOWS
+#if defined(SCYTHE_TARGET_WINDOWS) || defined(SCYTHE_TARGET_UNIX)
 # include <glad/gl.h>
 #elif defined(SCYTHE_TARGET_MAC)
 # include <OpenGL/gl3.h>
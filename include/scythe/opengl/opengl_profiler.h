@@ -0,0 +1,124 @@
+#ifndef __SCYTHE_OPENGL_PROFILER_H__
+#define __SCYTHE_OPENGL_PROFILER_H__
+
+#ifndef SCYTHE_USE_OPENGL
+# error "OpenGL should be enabled to use this header"
+#endif
+
+#include "../profiler.h"
+
+#ifdef SCYTHE_USE_PROFILER
+
+namespace scythe {
+
+	/**
+	 * @brief      This class describes a GPU profiler based on OpenGL timestamp queries.
+	 * @details    Zone boundaries are marked with GL_TIMESTAMP queries taken from a pool
+	 *             of several frames. Results are read back without waiting: a frame is
+	 *             collected once all its queries become available, and dropped if it's
+	 *             not ready when its queries have to be reused. GPU time is calibrated
+	 *             against CPU profiler clock, so zones get into the same trace on "GPU" track.
+	 *             Initialization and frame collection are done by OpenGL graphics provider.
+	 *             Shouldn't be used directly, use SCYTHE_GPU_PROFILE_SCOPE macro instead.
+	 */
+	class OpenGLProfiler final
+	: public Singleton<OpenGLProfiler>
+	{
+		friend class Singleton<OpenGLProfiler>;
+
+	public:
+		static constexpr uint32_t kFramesInFlight = 4;			//!< number of frames in query pool
+		static constexpr uint32_t kMaxZonesPerFrame = 128;		//!< maximum number of zones per frame
+		static constexpr uint32_t kMaxDepth = 16;				//!< maximum zones nesting depth
+		static constexpr uint32_t kCalibrationPeriod = 256;		//!< number of frames between clock calibrations
+
+		/**
+		 * @brief      Initializes the object. Should be called with current context.
+		 *
+		 * @return     True on success and false otherwise.
+		 */
+		bool Initialize();
+
+		/**
+		 * @brief      Deinitializes the object. Should be called with current context.
+		 */
+		void Deinitialize();
+
+		/**
+		 * @brief      Begins GPU zone.
+		 *
+		 * @param[in]  id    The zone name identifier
+		 */
+		void BeginZone(StringID id);
+
+		/**
+		 * @brief      Ends the last begun GPU zone.
+		 */
+		void EndZone();
+
+		/**
+		 * @brief      Finishes the current frame and collects results of the previous ones.
+		 */
+		void EndFrame();
+
+	private:
+		struct Zone
+		{
+			StringID name;
+			uint32_t depth;
+		};
+		struct Frame
+		{
+			uint32_t queries[kMaxZonesPerFrame * 2];	//!< begin and end query for each zone
+			Zone zones[kMaxZonesPerFrame];
+			uint32_t num_zones;
+			bool pending;								//!< frame has been finished but not collected
+		};
+
+		OpenGLProfiler();
+		~OpenGLProfiler();
+
+		void Calibrate();
+		bool Collect(Frame& frame);
+
+		Profiler::ThreadData* track_;
+		Frame frames_[kFramesInFlight];
+		uint32_t frame_index_;						//!< index of the frame being recorded
+		uint32_t stack_[kMaxDepth];					//!< indices of active zones
+		uint32_t depth_;
+		uint32_t overflow_;							//!< number of zones that haven't been recorded
+		uint32_t frames_since_calibration_;
+		int64_t clock_offset_;						//!< CPU minus GPU time in nanoseconds
+		bool initialized_;
+	};
+
+	/**
+	 * @brief      GPU zone that lasts until the end of scope.
+	 */
+	class OpenGLProfileScope final
+	: public NonCopyable
+	{
+	public:
+		explicit OpenGLProfileScope(StringID id)
+		{
+			OpenGLProfiler::GetInstance()->BeginZone(id);
+		}
+		~OpenGLProfileScope()
+		{
+			OpenGLProfiler::GetInstance()->EndZone();
+		}
+	};
+
+} // namespace scythe
+
+#define SCYTHE_GPU_PROFILE_SCOPE(name) \
+	static const ::scythe::ProfileZoneName SCYTHE_MACRO_CONCAT(scythe_gpu_profile_name_, __LINE__)(SCYTHE_PROFILE_ID(name), name); \
+	const ::scythe::OpenGLProfileScope SCYTHE_MACRO_CONCAT(scythe_gpu_profile_scope_, __LINE__)(SCYTHE_PROFILE_ID(name))
+
+#else // SCYTHE_USE_PROFILER
+
+#define SCYTHE_GPU_PROFILE_SCOPE(name)
+
+#endif // SCYTHE_USE_PROFILER
+
+#endif
\ No newline at end of file
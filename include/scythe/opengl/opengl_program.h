@@ -8,6 +8,7 @@
 #include <cstddef>
 
 #include "opengl_include.h"
+#include "../package.h"
 
 namespace scythe {
 
@@ -64,6 +65,26 @@ namespace scythe {
 		 */
 		bool Create(const ComputeShadersInfo& info, bool use_files);
 
+		/**
+		 * @brief      Creates render program from package blobs without copying.
+		 *
+		 * @param[in]  info     Shader blob names.
+		 * @param[in]  package  The package.
+		 *
+		 * @return     True on success and false otherwise.
+		 */
+		bool Create(const RenderShadersInfo& info, const Package& package);
+
+		/**
+		 * @brief      Creates compute program from package blobs without copying.
+		 *
+		 * @param[in]  info     Shader blob names.
+		 * @param[in]  package  The package.
+		 *
+		 * @return     True on success and false otherwise.
+		 */
+		bool Create(const ComputeShadersInfo& info, const Package& package);
+
 		/**
 		 * @brief      Destroys the object.
 		 */
@@ -77,6 +98,9 @@ namespace scythe {
 		GLuint id() const;
 
 	private:
+		bool Create(const RenderShadersInfo& info, bool use_files, const Package* package);
+		bool Create(const ComputeShadersInfo& info, bool use_files, const Package* package);
+
 		static constexpr std::size_t kNumShaders = 3u;
 		GLuint id_ = 0u;
 	};
@@ -0,0 +1,166 @@
+#ifndef __SCYTHE_PACKAGE_H__
+#define __SCYTHE_PACKAGE_H__
+
+#include "non_copyable.h"
+#include "string_id.h"
+#include "types.h"
+#include "thread_pool.h"
+
+namespace scythe {
+
+	constexpr uint32_t kPackageMagic = 0x4B415053;		//!< "SPAK"
+	constexpr uint32_t kPackageVersion = 2;
+	constexpr uint32_t kPackageAlignment = 16;			//!< default alignment of blobs
+	constexpr uint32_t kPackageBlockSize = 1u << 16;	//!< default size of compression block
+
+	/**
+	 * Package entry flags.
+	 */
+	enum PackageEntryFlags : uint32_t
+	{
+		kPackageEntryCompressed = 1,	//!< blob is split into independently LZ4 compressed blocks
+	};
+
+	/**
+	 * @brief      Header at the beginning of package file, followed by the table of contents.
+	 * @details    All values are stored in little endian byte order.
+	 */
+	struct PackageHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t entries_count;
+		uint32_t alignment;			//!< alignment of blobs offsets
+		uint32_t block_size;		//!< uncompressed size of compression block
+		uint32_t reserved;
+	};
+
+	/**
+	 * @brief      Entry of package table of contents. Entries are sorted by string identifier.
+	 * @details    Compressed blob starts with table of blocks ends (uint32_t per block, relative to
+	 *             the first block), followed by blocks. Block of the same compressed and uncompressed
+	 *             size is stored as is.
+	 */
+	struct PackageEntry
+	{
+		StringID string_id;			//!< CRC32 of the blob name
+		uint32_t flags;				//!< combination of PackageEntryFlags
+		uint64_t offset;			//!< offset from the beginning of file
+		uint64_t size;				//!< uncompressed size
+		uint64_t stored_size;		//!< size in file
+	};
+
+	static_assert(sizeof(PackageHeader) == 24, "Package header layout is fixed");
+	static_assert(sizeof(PackageEntry) == 32, "Package entry layout is fixed");
+
+	/**
+	 * @brief      Read-only view of package blob memory.
+	 */
+	struct PackageSpan
+	{
+		const uint8_t* data;		//!< nullptr if blob isn't found
+		size_t size;
+	};
+
+	/**
+	 * @brief      This class describes a read-only package of blobs.
+	 * @details    The whole file is memory mapped, so blobs are accessed without copying and
+	 *             loaded from disk by page faults. Opened package is safe to read from any thread,
+	 *             so resource loading functions may use it directly.
+	 *             Compressed blobs are read into user buffers, their blocks may be decompressed
+	 *             by several threads at once.
+	 */
+	class Package final
+	: public NonCopyable
+	{
+	public:
+		Package();
+		~Package();
+
+		/**
+		 * @brief      Opens package file.
+		 *
+		 * @param[in]  filename  The filename
+		 *
+		 * @return     True on success and false otherwise.
+		 */
+		bool Open(const char* filename);
+
+		/**
+		 * @brief      Closes package. All spans become invalid.
+		 */
+		void Close();
+
+		/**
+		 * @brief      Determines if package is open.
+		 *
+		 * @return     True if open, False otherwise.
+		 */
+		bool IsOpen() const;
+
+		/**
+		 * @brief      Finds uncompressed blob by its string identifier.
+		 *
+		 * @param[in]  string_id  The string identifier
+		 *
+		 * @return     The blob span or empty span if blob isn't found or is compressed.
+		 */
+		PackageSpan Find(StringID string_id) const;
+
+		/**
+		 * @brief      Finds entry by its string identifier.
+		 *
+		 * @param[in]  string_id  The string identifier
+		 *
+		 * @return     The entry or nullptr if blob isn't found.
+		 */
+		const PackageEntry* FindEntry(StringID string_id) const;
+
+		/**
+		 * @brief      Reads a range of blob into preallocated buffer, decompressing if needed.
+		 * @details    Blob may be streamed by sequential reads, ranges aligned to block size
+		 *             are decompressed without extra copying. Calling thread takes part in
+		 *             decompression, so it's safe to call from the pool threads.
+		 *
+		 * @param[in]  entry        The entry
+		 * @param[in]  offset       The offset in uncompressed blob
+		 * @param      destination  The destination
+		 * @param[in]  size         The size to read
+		 * @param      pool         The pool to decompress blocks in parallel or nullptr
+		 *
+		 * @return     True on success and false otherwise.
+		 */
+		bool Read(const PackageEntry& entry, uint64_t offset, void* destination, size_t size, ThreadPool* pool = nullptr) const;
+
+		/**
+		 * @brief      Gets the entries count.
+		 *
+		 * @return     The entries count.
+		 */
+		uint32_t GetEntriesCount() const;
+
+		/**
+		 * @brief      Gets the entry by index.
+		 *
+		 * @param[in]  index  The index
+		 *
+		 * @return     The entry.
+		 */
+		const PackageEntry& GetEntry(uint32_t index) const;
+
+	private:
+		void Unmap();
+		bool ValidateBlocks(const PackageEntry& entry) const;
+		bool ReadBlock(const PackageEntry& entry, uint64_t block, uint64_t offset, uint64_t end, uint8_t* destination) const;
+
+		const uint8_t* data_;
+		size_t size_;
+		const PackageEntry* entries_;
+		uint32_t entries_count_;
+		uint32_t block_size_;
+		void* mapping_;				//!< platform specific mapping handle
+	};
+
+} // namespace scythe
+
+#endif
\ No newline at end of file
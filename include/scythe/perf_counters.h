@@ -0,0 +1,113 @@
+#ifndef __SCYTHE_PERF_COUNTERS_H__
+#define __SCYTHE_PERF_COUNTERS_H__
+
+#include "types.h"
+#include "non_copyable.h"
+
+namespace scythe {
+
+	/**
+	 * @brief      Performance counter kind.
+	 */
+	enum class PerfCounter
+	{
+		// Hardware counters
+		kInstructions,
+		kCycles,
+		kCacheMisses,
+		kBranchMisses,
+		// Software counters
+		kTaskClock,				//!< CPU time of the thread in nanoseconds
+		kPageFaults,
+		kContextSwitches,
+		kCount
+	};
+
+	/**
+	 * @brief      Performance counters values.
+	 */
+	struct PerfCounterValues
+	{
+		uint64_t values[static_cast<int>(PerfCounter::kCount)];
+	};
+
+	/**
+	 * @brief      This class describes performance counters of the calling thread.
+	 * @details    Uses perf_event_open on Linux. Hardware counters are often not
+	 *             permitted (perf_event_paranoid, virtual machines without PMU), then
+	 *             only software ones are available. All opened counters form a single
+	 *             group, so sampling takes one system call. There are no counters on
+	 *             other platforms.
+	 */
+	class PerfCounters final
+	: public NonCopyable
+	{
+	public:
+		static constexpr int kNumCounters = static_cast<int>(PerfCounter::kCount);
+
+		PerfCounters();
+		~PerfCounters();
+
+		/**
+		 * @brief      Opens counters for the calling thread.
+		 *
+		 * @return     True if at least one counter is available and false otherwise.
+		 */
+		bool Open();
+
+		/**
+		 * @brief      Closes counters.
+		 */
+		void Close();
+
+		/**
+		 * @brief      Determines if counter is available.
+		 *
+		 * @param[in]  counter  The counter
+		 *
+		 * @return     True if available, False otherwise.
+		 */
+		bool IsAvailable(PerfCounter counter) const;
+
+		/**
+		 * @brief      Determines if any counter is available.
+		 *
+		 * @return     True if opened, False otherwise.
+		 */
+		bool IsOpened() const;
+
+		/**
+		 * @brief      Reads current values of counters. Unavailable counters are zero.
+		 *
+		 * @param      values  The values
+		 */
+		void Read(PerfCounterValues* values) const;
+
+		/**
+		 * @brief      Gets the counter name.
+		 *
+		 * @param[in]  counter  The counter
+		 *
+		 * @return     The name.
+		 */
+		static const char* GetName(PerfCounter counter);
+
+		/**
+		 * @brief      Calculates difference between two samples.
+		 *
+		 * @param[in]  end     The end values
+		 * @param[in]  start   The start values
+		 * @param      result  The result
+		 */
+		static void Subtract(const PerfCounterValues& end, const PerfCounterValues& start, PerfCounterValues* result);
+
+	private:
+		int group_fd_;							//!< group leader file descriptor
+		int fds_[kNumCounters];
+		int indices_[kNumCounters];				//!< index of the counter in group read data
+		int num_opened_;
+	};
+
+} // namespace scythe
+
+#endif
\ No newline at end of file
@@ -0,0 +1,160 @@
+#ifndef __SCYTHE_POOL_ALLOCATOR_H__
+#define __SCYTHE_POOL_ALLOCATOR_H__
+
+#include "non_copyable.h"
+#include "memory_tracker.h"
+#include "types.h"
+
+#include <mutex>
+#include <vector>
+#include <new>
+#include <cstddef>
+
+namespace scythe {
+
+	/**
+	 * @brief      This class describes a fixed-size objects pool allocator.
+	 * @details    Memory is reserved by blocks of slots, so objects of one kind are contiguous
+	 *             and allocation is a free list pop. Every thread keeps a small cache of free
+	 *             slots, so the shared free list is locked once per batch only. Memory isn't
+	 *             returned to the system until the pool is destroyed. Live objects are accounted
+	 *             to the memory tag. In debug builds freed slots are poisoned and checked
+	 *             on reuse to catch writes after free.
+	 */
+	class PoolAllocator final
+	: public NonCopyable
+	{
+	public:
+		/**
+		 * @brief      Constructs a new instance.
+		 *
+		 * @param[in]  object_size        The object size
+		 * @param[in]  alignment          The object alignment (power of two)
+		 * @param[in]  objects_per_block  The number of objects per memory block
+		 * @param[in]  tag                The memory tag
+		 */
+		PoolAllocator(size_t object_size, size_t alignment = alignof(std::max_align_t), size_t objects_per_block = 256,
+			MemoryTag tag = MemoryTag::kGeneral);
+		~PoolAllocator();
+
+		/**
+		 * @brief      Allocates memory for a single object.
+		 *
+		 * @return     Pointer to memory or nullptr on failure.
+		 */
+		void * Allocate();
+
+		/**
+		 * @brief      Frees memory previously allocated by this pool.
+		 *
+		 * @param      memory  The memory
+		 */
+		void Free(void * memory);
+
+		/**
+		 * @brief      Gets the slot size.
+		 *
+		 * @return     The slot size in bytes.
+		 */
+		size_t GetSlotSize() const;
+
+		/**
+		 * @brief      Gets the number of slots reserved by the pool.
+		 *
+		 * @return     The capacity in objects.
+		 */
+		size_t GetCapacity() const;
+
+	private:
+		struct ThreadCache;
+
+		ThreadCache * GetThreadCache();
+		void ReleaseThreadCache(ThreadCache * cache); //!< called on thread exit
+		bool Refill(ThreadCache * cache);
+		void Flush(ThreadCache * cache, uint32_t count);
+		bool AllocateBlock(); //!< should be called under mutex
+		void Poison(void * memory);
+		void CheckPoison(void * memory);
+
+		mutable std::mutex mutex_;
+		std::vector<void *> blocks_;				//!< guarded by mutex
+		std::vector<ThreadCache *> caches_;		//!< guarded by mutex
+		std::vector<ThreadCache *> free_caches_;	//!< caches of exited threads (guarded by mutex)
+		void * free_list_;							//!< shared free list (guarded by mutex)
+		size_t slot_size_;
+		size_t alignment_;
+		size_t objects_per_block_;
+		MemoryTag tag_;
+		const uint32_t id_;						//!< distinguishes instances for thread local cache
+	};
+
+	/**
+	 * @brief      Gets the process wide pool of the specified slot size.
+	 * @details    Pool is never destroyed, so it may be used by static objects.
+	 *
+	 * @tparam     Size       The object size
+	 * @tparam     Alignment  The object alignment
+	 * @tparam     Tag        The memory tag
+	 *
+	 * @return     The pool.
+	 */
+	template <size_t Size, size_t Alignment, MemoryTag Tag>
+	PoolAllocator * GetSharedPool()
+	{
+		static PoolAllocator * pool = new PoolAllocator(Size, Alignment, 256, Tag);
+		return pool;
+	}
+
+	/**
+	 * @brief      STL compatible allocator that uses @ref PoolAllocator for single objects.
+	 * @details    Intended for node based containers: nodes come from shared pool
+	 *             and arrays (like buckets) are allocated with @ref TaggedAllocate.
+	 */
+	template <typename T, MemoryTag Tag = MemoryTag::kGeneral>
+	class PoolStlAllocator
+	{
+	public:
+		typedef T value_type;
+
+		template <typename U>
+		struct rebind
+		{
+			typedef PoolStlAllocator<U, Tag> other;
+		};
+
+		PoolStlAllocator() noexcept = default;
+		template <typename U>
+		PoolStlAllocator(const PoolStlAllocator<U, Tag>&) noexcept {}
+
+		T * allocate(size_t n)
+		{
+			void * memory = (n == 1)
+				? GetSharedPool<sizeof(T), alignof(T), Tag>()->Allocate()
+				: TaggedAllocate(n * sizeof(T), Tag, alignof(T));
+			if (memory == nullptr)
+				throw std::bad_alloc();
+			return static_cast<T *>(memory);
+		}
+		void deallocate(T * pointer, size_t n) noexcept
+		{
+			if (n == 1)
+				GetSharedPool<sizeof(T), alignof(T), Tag>()->Free(pointer);
+			else
+				TaggedFree(pointer);
+		}
+	};
+
+	template <typename T, typename U, MemoryTag Tag>
+	bool operator ==(const PoolStlAllocator<T, Tag>&, const PoolStlAllocator<U, Tag>&) noexcept
+	{
+		return true;
+	}
+	template <typename T, typename U, MemoryTag Tag>
+	bool operator !=(const PoolStlAllocator<T, Tag>&, const PoolStlAllocator<U, Tag>&) noexcept
+	{
+		return false;
+	}
+
+} // namespace scythe
+
+#endif
\ No newline at end of file
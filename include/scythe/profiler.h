@@ -0,0 +1,202 @@
+#ifndef __SCYTHE_PROFILER_H__
+#define __SCYTHE_PROFILER_H__
+
+#include "defines.h"
+#include "string_id.h"
+
+#ifdef SCYTHE_USE_PROFILER
+
+#include <type_traits>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+#include <string>
+#include <atomic>
+
+#include "types.h"
+#include "singleton.h"
+
+namespace scythe {
+
+	/**
+	 * @brief      This class describes a hierarchical CPU profiler.
+	 * @details    Each thread writes completed zones into its own ring buffer,
+	 *             so recording doesn't take any locks. Old events are overwritten
+	 *             when buffer is full. Collected events may be exported into Chrome
+	 *             trace JSON format (chrome://tracing, ui.perfetto.dev).
+	 *             Shouldn't be used directly, use SCYTHE_PROFILE_* macros instead.
+	 */
+	class Profiler final
+	: public Singleton<Profiler>
+	{
+		friend class Singleton<Profiler>;
+
+	public:
+		static constexpr uint32_t kEventsPerThread = 1u << 16;	//!< ring buffer capacity (power of two)
+		static constexpr uint32_t kMaxDepth = 64;				//!< maximum zones nesting depth
+
+		struct ThreadData;
+
+		/**
+		 * @brief      Gets the current timestamp.
+		 *
+		 * @return     The timestamp in nanoseconds.
+		 */
+		static uint64_t GetTimestamp();
+
+		/**
+		 * @brief      Registers zone name for export. Should be called once per call site.
+		 *
+		 * @param[in]  id    The name identifier
+		 * @param[in]  name  The name (should have static storage duration)
+		 */
+		void RegisterName(StringID id, const char* name);
+
+		/**
+		 * @brief      Begins zone on the current thread.
+		 *
+		 * @param[in]  id    The zone name identifier
+		 */
+		void BeginZone(StringID id);
+
+		/**
+		 * @brief      Ends the last begun zone on the current thread.
+		 */
+		void EndZone();
+
+		/**
+		 * @brief      Sets the current thread name for export.
+		 *
+		 * @param[in]  name  The name
+		 */
+		void SetThreadName(const char* name);
+
+		/**
+		 * @brief      Enables or disables sampling of performance counters in zones.
+		 * @details    Counters are opened for every thread on its next zone. Sampling
+		 *             takes a system call at every zone boundary, so it's disabled by default.
+		 *
+		 * @param[in]  enabled  The enabled flag
+		 */
+		void SetPerfCountersEnabled(bool enabled);
+
+		/**
+		 * @brief      Creates a track for events that are not recorded via zones (GPU timings, etc.).
+		 * @details    Events on a track should be added from a single thread.
+		 *
+		 * @param[in]  name  The track name
+		 *
+		 * @return     The track.
+		 */
+		ThreadData* CreateTrack(const char* name);
+
+		/**
+		 * @brief      Adds completed event to the track.
+		 *
+		 * @param      track  The track
+		 * @param[in]  id     The name identifier
+		 * @param[in]  depth  The nesting depth
+		 * @param[in]  start  The start timestamp in nanoseconds
+		 * @param[in]  end    The end timestamp in nanoseconds
+		 */
+		void AddEvent(ThreadData* track, StringID id, uint32_t depth, uint64_t start, uint64_t end);
+
+		/**
+		 * @brief      Gets the current thread data.
+		 *
+		 * @return     The current thread data.
+		 */
+		ThreadData* GetThreadData();
+
+		/**
+		 * @brief      Gets the active zones stack of the thread.
+		 * @details    May be called from any thread, so stack may be changed during reading.
+		 *
+		 * @param[in]  thread     The thread data
+		 * @param      ids        The zone name identifiers from outermost to innermost
+		 * @param[in]  max_count  The maximum count of identifiers
+		 *
+		 * @return     The number of stored identifiers.
+		 */
+		uint32_t GetZoneStack(const ThreadData* thread, StringID* ids, uint32_t max_count);
+
+		/**
+		 * @brief      Gets the registered zone name.
+		 *
+		 * @param[in]  id    The name identifier
+		 *
+		 * @return     The name or nullptr if not registered.
+		 */
+		const char* GetName(StringID id);
+
+		/**
+		 * @brief      Exports all collected events into Chrome trace JSON file.
+		 *
+		 * @param[in]  filename  The filename
+		 *
+		 * @return     True on success and false otherwise.
+		 */
+		bool ExportChromeTrace(const char* filename);
+
+	private:
+		Profiler();
+		~Profiler();
+
+		ThreadData* CreateThreadData();
+
+		std::mutex threads_mutex_;
+		std::vector<ThreadData*> threads_;						//!< all threads ever recorded (guarded by mutex)
+		std::mutex names_mutex_;
+		std::unordered_map<StringID, const char*> names_;		//!< zone names (guarded by mutex)
+		uint64_t start_time_;									//!< timestamp of profiler creation
+		std::atomic<bool> perf_counters_enabled_;
+	};
+
+	/**
+	 * @brief      Registers zone name on construction.
+	 */
+	struct ProfileZoneName
+	{
+		ProfileZoneName(StringID id, const char* name)
+		{
+			Profiler::GetInstance()->RegisterName(id, name);
+		}
+	};
+
+	/**
+	 * @brief      Zone that lasts until the end of scope.
+	 */
+	class ProfileScope final
+	: public NonCopyable
+	{
+	public:
+		explicit ProfileScope(StringID id)
+		{
+			Profiler::GetInstance()->BeginZone(id);
+		}
+		~ProfileScope()
+		{
+			Profiler::GetInstance()->EndZone();
+		}
+	};
+
+} // namespace scythe
+
+// Name identifier is computed at compile time
+#define SCYTHE_PROFILE_ID(name) (std::integral_constant<::scythe::StringID, ConstexprStringId(name)>::value)
+
+#define SCYTHE_PROFILE_SCOPE(name) \
+	static const ::scythe::ProfileZoneName SCYTHE_MACRO_CONCAT(scythe_profile_name_, __LINE__)(SCYTHE_PROFILE_ID(name), name); \
+	const ::scythe::ProfileScope SCYTHE_MACRO_CONCAT(scythe_profile_scope_, __LINE__)(SCYTHE_PROFILE_ID(name))
+
+#define SCYTHE_PROFILE_THREAD(name) \
+	::scythe::Profiler::GetInstance()->SetThreadName(name)
+
+#else // SCYTHE_USE_PROFILER
+
+#define SCYTHE_PROFILE_SCOPE(name)
+#define SCYTHE_PROFILE_THREAD(name)
+
+#endif // SCYTHE_USE_PROFILER
+
+#endif
\ No newline at end of file
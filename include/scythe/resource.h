@@ -1,12 +1,20 @@
 #ifndef __SCYTHE_RESOURCE_H__
 #define __SCYTHE_RESOURCE_H__
 
+#include "types.h"
+
 namespace scythe {
 
 	/**
-	 * Resource identifier definition
+	 * Resource identifier definition.
+	 * Generational handle: slot index in low bits and slot generation in high bits.
 	 */
-	typedef int ResourceID;
+	typedef uint32_t ResourceID;
+
+	/**
+	 * Identifier of not registered resource
+	 */
+	constexpr ResourceID kInvalidResourceID = 0;
 
 	/**
 	 * @brief      This class describes a resource.
@@ -17,6 +25,13 @@ namespace scythe {
 	{
 	public:
 		virtual ~Resource() = default;
+
+		/**
+		 * @brief      Gets the memory size of the resource for budgeting.
+		 *
+		 * @return     The size in bytes.
+		 */
+		virtual size_t GetSize() const { return 0; }
 	};
 
 } // namespace scythe
@@ -2,10 +2,17 @@
 #define __SCYTHE_RESOURCE_MANAGER_H__
 
 #include <unordered_map>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
 
 #include "resource.h"
 #include "singleton.h"
 #include "string_id.h"
+#include "pool_allocator.h"
+#include "thread_pool.h"
 
 namespace scythe {
 
@@ -19,9 +26,60 @@ namespace scythe {
 	 */
 	typedef void (* ResourceUnloadingFunc)(void* /*user_data*/, Resource* /*resource*/);
 
+	/**
+	 * Resource loading task function definition.
+	 * Runs on a worker thread (I/O, decoding) and returns the data for finalization.
+	 */
+	typedef void* (* ResourceLoadingTaskFunc)(void* /*user_data*/, ResourceID /*resource_id*/);
+
+	/**
+	 * Resource finalizing function definition.
+	 * Runs on the main thread (graphics objects creation) and takes ownership of the data.
+	 */
+	typedef Resource* (* ResourceFinalizingFunc)(void* /*user_data*/, ResourceID /*resource_id*/, void* /*data*/);
+
+	/**
+	 * Resource discarding function definition.
+	 * Runs on the main thread to free data of the cancelled loading.
+	 */
+	typedef void (* ResourceDiscardingFunc)(void* /*user_data*/, void* /*data*/);
+
+	/**
+	 * Priority of keeping unused resource in memory.
+	 * Resources of lower priority are evicted first.
+	 */
+	enum class ResidencyPriority
+	{
+		kLow,
+		kNormal,
+		kHigh,
+		kCount
+	};
+
+	/**
+	 * @brief      Describes a resource for bulk registration.
+	 */
+	struct ResourceDescription
+	{
+		StringID string_id;
+		void* user_data;
+		ResourceLoadingFunc loading_func;
+		ResourceUnloadingFunc unloading_func;
+	};
+
 	/**
 	 * @brief      This class describes a resource manager.
 	 * @details    Creates and manages @ref Resource class instances.
+	 *             Resources whose state doesn't match their request counter are kept in
+	 *             pending queues, so processing cost depends on pending work only.
+	 *             Asynchronous resources are loaded by worker threads and finalized on the main
+	 *             thread within a time budget by @ref Update.
+	 *             Resource is loaded after all its dependencies and unloaded before them,
+	 *             so independent resources are loaded in parallel.
+	 *             Resources are stored densely and addressed by generational identifiers,
+	 *             so lookup is a single array access and stale identifiers are detected.
+	 *             With memory budget set unused resources stay cached and are evicted in
+	 *             least recently used order when memory exceeds the budget.
 	 * @see        Resource
 	 */
 	class ResourceManager final
@@ -50,10 +108,49 @@ namespace scythe {
 		 * @param[in]  loading_func    The loading function
 		 * @param[in]  unloading_func  The unloading function
 		 *
-		 * @return     The created resource id.
+		 * @return     The created resource id or kInvalidResourceID if name is already registered.
 		 */
 		ResourceID RegisterResource(StringID string_id, void* user_data, ResourceLoadingFunc loading_func, ResourceUnloadingFunc unloading_func);
 
+		/**
+		 * @brief      Registers multiple resources at once.
+		 *
+		 * @param[in]  descriptions  The resource descriptions
+		 * @param[in]  count         The number of resources
+		 * @param      ids           The created resource ids (kInvalidResourceID for duplicate names)
+		 *
+		 * @return     The number of registered resources.
+		 */
+		size_t RegisterResources(const ResourceDescription* descriptions, size_t count, ResourceID* ids);
+
+		/**
+		 * @brief      Registers a new resource that is loaded asynchronously.
+		 * @details    User data should stay valid while the loading task is in progress.
+		 *
+		 * @param[in]  string_id        The string identifier
+		 * @param      user_data        The user data
+		 * @param[in]  task_func        The loading task function (thread-safe)
+		 * @param[in]  finalizing_func  The finalizing function
+		 * @param[in]  discarding_func  The discarding function
+		 * @param[in]  unloading_func   The unloading function
+		 *
+		 * @return     The created resource id or kInvalidResourceID if name is already registered.
+		 */
+		ResourceID RegisterAsyncResource(StringID string_id, void* user_data, ResourceLoadingTaskFunc task_func,
+			ResourceFinalizingFunc finalizing_func, ResourceDiscardingFunc discarding_func, ResourceUnloadingFunc unloading_func);
+
+		/**
+		 * @brief      Declares that a resource depends on another one.
+		 * @details    Requesting a resource requests all its dependencies transitively.
+		 *             Dependencies are loaded before and unloaded after the resource.
+		 *
+		 * @param[in]  id             The resource identifier
+		 * @param[in]  dependency_id  The dependency identifier
+		 *
+		 * @return     True if succeeded and false if dependency makes a cycle.
+		 */
+		bool AddDependency(ResourceID id, ResourceID dependency_id);
+
 		/**
 		 * @brief      Unregisters previously registered resource
 		 *
@@ -70,24 +167,47 @@ namespace scythe {
 		 */
 		ResourceID GetResourceIdByName(StringID string_id);
 
+		/**
+		 * @brief      Gets the resource identifiers by names.
+		 *
+		 * @param[in]  string_ids  The string identifiers
+		 * @param[in]  count       The number of names
+		 * @param      ids         The resource ids (kInvalidResourceID for not registered names)
+		 *
+		 * @return     The number of found resources.
+		 */
+		size_t GetResourceIdsByNames(const StringID* string_ids, size_t count, ResourceID* ids);
+
 		/**
 		 * @brief      Gets the resource by its identifier.
 		 *
 		 * @param[in]  id    The identifier
 		 *
-		 * @return     The resource.
+		 * @return     The resource or nullptr if it isn't loaded or identifier is stale.
 		 */
 		Resource* GetResource(ResourceID id);
 
+		/**
+		 * @brief      Calls function for every loaded resource.
+		 *
+		 * @param[in]  function  The function with (ResourceID, Resource*) signature
+		 */
+		template <class Function>
+		void ForEachResource(Function function);
+
 		/**
 		 * @brief      Requests loading of a resource with the specified identifier
+		 * @details    Loading task of asynchronous resource is started immediately.
+		 *             Tasks with higher priority are started first.
 		 *
-		 * @param[in]  id    The identifier
+		 * @param[in]  id        The identifier
+		 * @param[in]  priority  The loading priority (asynchronous resources only)
 		 */
-		void RequestLoad(ResourceID id);
+		void RequestLoad(ResourceID id, int priority = 0);
 
 		/**
 		 * @brief      Requests unloading of a resource with the specified identifier
+		 * @details    Unfinished asynchronous loading is cancelled.
 		 *
 		 * @param[in]  id    The identifier
 		 */
@@ -95,16 +215,57 @@ namespace scythe {
 
 		/**
 		 * @brief      Performs loading/unloading routine of all registered resources.
+		 *             Waits for all asynchronous loadings to finish.
 		 */
 		void Perform();
 
 		/**
 		 * @brief      Performs a single step of loading/unloading routine of all registered resources.
+		 *             Doesn't wait for asynchronous loadings.
 		 *
 		 * @return     True if loading is finished and false otherwise.
 		 */
 		bool PerformStep();
 
+		/**
+		 * @brief      Evicts cached resources over the memory budget and finalizes completed
+		 *             asynchronous loadings within the time budget. Should be called once per frame.
+		 */
+		void Update();
+
+		/**
+		 * @brief      Sets the memory budget of loaded resources.
+		 * @details    Unused resources are kept loaded while memory fits the budget.
+		 *             0 disables caching, so unused resources are unloaded immediately.
+		 * @see        Resource::GetSize
+		 *
+		 * @param[in]  size  The size in bytes
+		 */
+		void SetMemoryBudget(size_t size);
+
+		/**
+		 * @brief      Sets the residency priority of a resource.
+		 *
+		 * @param[in]  id        The identifier
+		 * @param[in]  priority  The priority
+		 */
+		void SetResidencyPriority(ResourceID id, ResidencyPriority priority);
+
+		/**
+		 * @brief      Gets the memory size of all loaded resources including cached ones.
+		 *
+		 * @return     The size in bytes.
+		 */
+		size_t GetMemorySize() const;
+
+		/**
+		 * @brief      Sets the time budget of asynchronous loadings finalization per update.
+		 *             At least one loading is finalized per update regardless of budget.
+		 *
+		 * @param[in]  seconds  The time in seconds
+		 */
+		void SetFinalizeBudget(float seconds);
+
 		/**
 		 * @brief      Gets the resources count to process.
 		 *
@@ -114,24 +275,102 @@ namespace scythe {
 
 	private:
 
+		/**
+		 * Action that resource is queued for.
+		 */
+		enum class Pending
+		{
+			kNone,
+			kLoad,
+			kUnload
+		};
+
+		struct LoadJob;
+
+		typedef std::vector<ResourceID, TaggedStlAllocator<ResourceID, MemoryTag::kResource>> DependencyList;
+
 		struct ResourceInfo
 		{
+			ResourceID id;
 			int counter;
+			int priority;
+			Pending pending;
 			StringID string_id;
 			Resource* resource;
 			void* user_data;
 			ResourceLoadingFunc loading_func;
 			ResourceUnloadingFunc unloading_func;
+			ResourceLoadingTaskFunc task_func;			//!< not null for asynchronous resources
+			ResourceFinalizingFunc finalizing_func;
+			ResourceDiscardingFunc discarding_func;
+			LoadJob* job;								//!< loading in progress
+			DependencyList dependencies;				//!< resources that should be loaded before
+			DependencyList dependents;					//!< resources that should be unloaded before
+			size_t size;								//!< size of loaded resource
+			ResidencyPriority residency;
+			bool cached;								//!< unused and kept in the cache list
+			ResourceID cache_prev;
+			ResourceID cache_next;
 		};
-		typedef std::unordered_map<ResourceID, ResourceInfo> Container;
+		/**
+		 * Slot of identifier, refers to either resource or next free slot.
+		 */
+		struct Slot
+		{
+			uint32_t generation;
+			uint32_t index;
+		};
+		typedef std::vector<ResourceInfo, TaggedStlAllocator<ResourceInfo, MemoryTag::kResource>> Container;
+		typedef std::vector<Slot, TaggedStlAllocator<Slot, MemoryTag::kResource>> SlotList;
+		typedef std::pair<const StringID, ResourceID> NameIndexValue;
+		typedef std::unordered_map<StringID, ResourceID, std::hash<StringID>, std::equal_to<StringID>,
+			PoolStlAllocator<NameIndexValue, MemoryTag::kResource>> NameIndex;
 
 		ResourceManager();
 		~ResourceManager();
 
-		Container container_;
-		ResourceID unique_resource_id_;
+		ResourceInfo* Find(ResourceID id);
+		void UpdatePending(ResourceID id, ResourceInfo& info);
+		void UpdatePending(const DependencyList& ids);
+		size_t CountLoaded(const DependencyList& ids);
+		bool DependsOn(ResourceID id, ResourceID dependency_id);
+		bool ProcessPending(std::deque<ResourceID>& queue, Pending action, std::deque<ResourceID>* failed_queue);
+		void StartLoadJob(ResourceID id, ResourceInfo& info);
+		LoadJob* PopCompletedJob(bool wait);
+		void FinishLoadJob(LoadJob* job);
+		void SetLoaded(ResourceInfo& info, Resource* resource);
+		void InsertCached(ResourceInfo& info);
+		void RemoveCached(ResourceInfo& info);
+		void EvictCached(bool all);
+
+		Container container_;					//!< dense, references are invalidated on registration
+		SlotList slots_;
+		uint32_t free_slots_head_;				//!< slots are reused in FIFO order to delay generation wrap
+		uint32_t free_slots_tail_;
+		NameIndex name_index_;
+		std::deque<ResourceID> load_queue_;		//!< may contain stale identifiers
+		std::deque<ResourceID> unload_queue_;	//!< may contain stale identifiers
+		int pending_count_;						//!< number of resources that need processing
+		int jobs_count_;						//!< number of unfinished loading jobs
+		uint64_t finalize_budget_;				//!< in clock ticks
+		size_t memory_budget_;
+		size_t memory_size_;					//!< size of loaded resources
+		ResourceID cache_head_[static_cast<int>(ResidencyPriority::kCount)];	//!< least recently used
+		ResourceID cache_tail_[static_cast<int>(ResidencyPriority::kCount)];
+		std::unique_ptr<ThreadPool> thread_pool_;	//!< created on first asynchronous loading
+		std::deque<LoadJob*> completed_jobs_;	//!< guarded by mutex
+		std::mutex completed_mutex_;
+		std::condition_variable completed_condition_;
 	};
 
+	template <class Function>
+	void ResourceManager::ForEachResource(Function function)
+	{
+		for (ResourceInfo& info : container_)
+			if (info.resource != nullptr)
+				function(info.id, info.resource);
+	}
+
 } // namespace scythe
 
 #endif
\ No newline at end of file
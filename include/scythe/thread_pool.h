@@ -0,0 +1,78 @@
+#ifndef __SCYTHE_THREAD_POOL_H__
+#define __SCYTHE_THREAD_POOL_H__
+
+#include "non_copyable.h"
+#include "types.h"
+
+#include <functional>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace scythe {
+
+	/**
+	 * @brief      This class describes a pool of worker threads executing prioritized tasks.
+	 * @details    Tasks with higher priority are started first, tasks of the same priority
+	 *             are started in submission order. Destructor waits for all submitted tasks.
+	 */
+	class ThreadPool final
+	: public NonCopyable
+	{
+	public:
+		typedef std::function<void()> Task;
+
+		/**
+		 * @brief      Constructs a new instance.
+		 *
+		 * @param[in]  threads_count  The threads count (0 means number of cores minus one)
+		 * @param[in]  name           The thread name for profiler
+		 */
+		explicit ThreadPool(uint32_t threads_count = 0, const char* name = "Worker");
+		~ThreadPool();
+
+		/**
+		 * @brief      Submits a task.
+		 *
+		 * @param[in]  task      The task
+		 * @param[in]  priority  The priority
+		 */
+		void Submit(Task task, int priority = 0);
+
+		/**
+		 * @brief      Gets the threads count.
+		 *
+		 * @return     The threads count.
+		 */
+		uint32_t GetThreadsCount() const;
+
+	private:
+		struct Entry
+		{
+			int priority;
+			uint64_t sequence;
+			Task task;
+
+			bool operator <(const Entry& other) const
+			{
+				// Top of the queue is the highest priority and the earliest submission
+				return (priority != other.priority) ? (priority < other.priority) : (sequence > other.sequence);
+			}
+		};
+
+		void ThreadFunc();
+
+		std::vector<std::thread> threads_;
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		std::priority_queue<Entry> tasks_;		//!< guarded by mutex
+		uint64_t sequence_;						//!< guarded by mutex
+		bool running_;							//!< guarded by mutex
+		const char* name_;
+	};
+
+} // namespace scythe
+
+#endif
\ No newline at end of file
@@ -4,13 +4,18 @@
 #include "singleton.h"
 #include "clock.h"
 #include "timer.h"
+#include "frame_statistics.h"
+#include "pool_allocator.h"
 
 namespace scythe {
 
 	/**
 	 * @brief      This class describes a time manager.
 	 * @details    Creates and manages all @ref Timer class instances. 
-	 *             Also calculates frame rate (FPS).
+	 *             Also calculates frame rate (FPS) and collects frame times statistics.
+	 *             Timers with callbacks are kept in hierarchical timer wheel, so adding,
+	 *             removing and expiring timer takes constant time and per frame cost
+	 *             depends on number of expiring timers only.
 	 * @see        Timer
 	 */
 	class TimeManager final
@@ -18,6 +23,7 @@ namespace scythe {
 	{
 		friend class ManagedSingleton<TimeManager>;
 		friend class Application;
+		friend class Timer;
 
 	public:
 
@@ -36,11 +42,14 @@ namespace scythe {
 		/**
 		 * @brief      Adds a timer.
 		 *
-		 * @param[in]  interval  The timer interval in seconds
+		 * @param[in]  interval   The timer interval in seconds
+		 * @param[in]  callback   The expiration callback (optional)
+		 * @param      user_data  The callback user data
+		 * @param[in]  repeating  Whether timer restarts on expiration
 		 *
 		 * @return     The created timer instance.
 		 */
-		Timer * AddTimer(float interval);
+		Timer * AddTimer(float interval, TimerCallback callback = nullptr, void * user_data = nullptr, bool repeating = false);
 
 		/**
 		 * @brief      Removes a previously created timer.
@@ -56,6 +65,20 @@ namespace scythe {
 		 */
 		float GetTime() const;
 
+		/**
+		 * @brief      Gets the current time in ticks.
+		 *
+		 * @return     The current time in nanoseconds.
+		 */
+		uint64_t GetTicks() const;
+
+		/**
+		 * @brief      Gets the frame time in ticks.
+		 *
+		 * @return     The frame time in nanoseconds.
+		 */
+		uint64_t GetFrameTicks() const;
+
 		/**
 		 * @brief      Gets the real frame time.
 		 * @details    "Real" means this frame time is not a fixed value.
@@ -78,21 +101,48 @@ namespace scythe {
 		 */
 		float GetFrameRate() const;
 
+		/**
+		 * @brief      Gets the frame times statistics.
+		 * @details    Only real (not fixed) frame times are collected.
+		 *
+		 * @return     The frame statistics.
+		 */
+		FrameStatistics& GetFrameStatistics();
+		const FrameStatistics& GetFrameStatistics() const;
+
 	private:
+		static constexpr int kWheelLevels = 4;
+		static constexpr int kWheelBits = 8;
+		static constexpr int kWheelSize = 1 << kWheelBits;
+
 		TimeManager();
 		~TimeManager();
 
 		void SetFixedFrameTime(float fixed_frame_time);
 		void Update();
+		void UpdateFixed(); //!< advances time by fixed frame time (deterministic)
+		void Advance(uint64_t frame_ticks);
+
+		uint64_t GetTimerTicks() const;
+		void UpdateSchedule(Timer * timer); //!< called when timer state changes
+		void Schedule(Timer * timer);
+		void Unschedule(Timer * timer);
+		void ProcessTimers();
 
 		Clock clock_;
-		Timer * timer_head_;
+		FrameStatistics frame_statistics_;
+		Timer * wheel_[kWheelLevels][kWheelSize];	//!< lists of scheduled timers
+		Timer * expiring_;							//!< timers of the processed tick
+		PoolAllocator timer_pool_;					//!< timers storage
+		uint64_t current_tick_;						//!< next wheel tick to process
+		uint64_t timer_ticks_;						//!< sum of frame times
+		uint64_t fixed_frame_ticks_;
+		uint64_t last_ticks_;
+		uint64_t frame_ticks_;						//!< time between two updates
+		uint64_t fps_counter_ticks_;				//!< for counting FPS
+		uint32_t fps_counter_count_;				//!< for counting FPS
 		float fixed_frame_time_;		//!< our engine uses fixed time steps, so this just shares the value
-		float last_time_;
-		float frame_time_;				//!< time between two updates
 		float frame_rate_;				//!< frames per second (FPS)
-		float fps_counter_time_;		//!< for counting FPS
-		float fps_counter_count_;		//!< for counting FPS
 	};
 
 } // namespace scythe
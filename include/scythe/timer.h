@@ -1,12 +1,27 @@
 #ifndef __SCYTHE_TIMER_H__
 #define __SCYTHE_TIMER_H__
 
+#include "types.h"
+
 namespace scythe {
 
+	class Timer;
+	class TimeManager;
+
+	/**
+	 * @brief      Function that is called on timer expiration.
+	 *
+	 * @param      timer      The expired timer
+	 * @param      user_data  The user data
+	 */
+	typedef void (*TimerCallback)(Timer* timer, void* user_data);
+
 	/**
 	 * @brief      This class describes a timer.
 	 * @details    The timer is managed by @ref TimeManager.
-	 *             Initially disabled.
+	 *             Initially disabled. Timer with callback is scheduled in timer wheel,
+	 *             so callback is called on the frame when timer expires. Repeating timer
+	 *             restarts on expiration.
 	 * @see        TimeManager
 	 */
 	class Timer
@@ -57,14 +72,46 @@ namespace scythe {
 		 */
 		float GetTime() const;
 
+		/**
+		 * @brief      Sets the callback called on expiration.
+		 *
+		 * @param[in]  callback   The callback (nullptr to remove)
+		 * @param      user_data  The user data
+		 */
+		void SetCallback(TimerCallback callback, void* user_data);
+
+		/**
+		 * @brief      Sets whether timer restarts on expiration. Makes sense with callback only.
+		 *
+		 * @param[in]  repeating  The repeating
+		 */
+		void SetRepeating(bool repeating);
+
+		/**
+		 * @brief      Determines if timer is repeating.
+		 *
+		 * @return     True if repeating, False otherwise.
+		 */
+		bool IsRepeating() const;
+
 	private:
-		Timer(float interval);
+		Timer(TimeManager * manager, float interval);
 		~Timer();
 
-		Timer * next_;
-		float interval_;
-		float time_;
+		uint64_t GetElapsedTicks() const;
+		uint64_t GetExpirationTicks() const; //!< in time of manager
+
+		TimeManager * manager_;
+		Timer * next_;					//!< next timer in wheel slot
+		Timer ** link_;					//!< link that points to this timer (nullptr if not scheduled)
+		TimerCallback callback_;
+		void * user_data_;
+		uint64_t expiration_tick_;		//!< wheel tick
+		uint64_t start_ticks_;			//!< time of manager when timer was started or reset
+		uint64_t interval_ticks_;
+		uint64_t elapsed_ticks_;		//!< time elapsed before start
 		bool enabled_;
+		bool repeating_;
 	};
 
 } // namespace scythe
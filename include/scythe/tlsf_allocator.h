@@ -0,0 +1,211 @@
+#ifndef __SCYTHE_TLSF_ALLOCATOR_H__
+#define __SCYTHE_TLSF_ALLOCATOR_H__
+
+#include "non_copyable.h"
+#include "memory_tracker.h"
+#include "types.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <new>
+#include <cstddef>
+
+namespace scythe {
+
+	/**
+	 * @brief      This class describes a two-level segregated fit (TLSF) heap.
+	 * @details    Free blocks are kept in lists indexed by two-level size classes with bitmaps,
+	 *             so allocation and freeing take constant time regardless of heap state.
+	 *             Memory comes from backing regions: either provided by user or allocated by heap
+	 *             itself. Growable heap adds a new region when existing ones are exhausted, that
+	 *             is the only operation that isn't bounded in time.
+	 *             Instance isn't thread safe. Per-thread instances are available via
+	 *             @ref AllocateThreadLocal and @ref FreeThreadLocal.
+	 */
+	class TlsfAllocator final
+	: public NonCopyable
+	{
+	public:
+		static constexpr size_t kAlignment = 8;		//!< minimum alignment of returned memory
+
+		/**
+		 * @brief      Constructs a new instance.
+		 *
+		 * @param[in]  region_size  The size of regions allocated by heap (0 means user regions only)
+		 * @param[in]  growable     Whether new region is added when heap is exhausted
+		 * @param[in]  tag          The memory tag of regions allocated by heap
+		 */
+		explicit TlsfAllocator(size_t region_size = 0, bool growable = false, MemoryTag tag = MemoryTag::kGeneral);
+		~TlsfAllocator();
+
+		/**
+		 * @brief      Adds a user provided backing region. Memory should outlive the heap.
+		 *
+		 * @param      memory  The memory (aligned to kAlignment)
+		 * @param[in]  size    The size
+		 *
+		 * @return     True on success and false otherwise.
+		 */
+		bool AddRegion(void * memory, size_t size);
+
+		/**
+		 * @brief      Allocates memory.
+		 *
+		 * @param[in]  size       The size
+		 * @param[in]  alignment  The alignment (power of two)
+		 *
+		 * @return     Pointer to memory or nullptr on failure.
+		 */
+		void * Allocate(size_t size, size_t alignment = kAlignment);
+
+		/**
+		 * @brief      Frees memory previously allocated by this heap.
+		 *
+		 * @param      memory  The memory
+		 */
+		void Free(void * memory);
+
+		/**
+		 * @brief      Gets the usable size of allocated memory.
+		 *
+		 * @param[in]  memory  The memory
+		 *
+		 * @return     The size in bytes.
+		 */
+		size_t GetAllocatedSize(const void * memory) const;
+
+		/**
+		 * @brief      Gets the size of allocated blocks.
+		 *
+		 * @return     The used size in bytes.
+		 */
+		size_t GetUsedSize() const;
+
+		/**
+		 * @brief      Gets the total size of backing regions.
+		 *
+		 * @return     The capacity in bytes.
+		 */
+		size_t GetCapacity() const;
+
+		/**
+		 * @brief      Determines whether memory belongs to one of heap regions.
+		 *
+		 * @param[in]  memory  The memory
+		 *
+		 * @return     True if heap contains memory, False otherwise.
+		 */
+		bool Contains(const void * memory) const;
+
+		/**
+		 * @brief      Allocates memory from the calling thread heap.
+		 *
+		 * @param[in]  size       The size
+		 * @param[in]  alignment  The alignment (power of two)
+		 *
+		 * @return     Pointer to memory or nullptr on failure.
+		 */
+		static void * AllocateThreadLocal(size_t size, size_t alignment = kAlignment);
+
+		/**
+		 * @brief      Frees memory allocated by @ref AllocateThreadLocal on any thread.
+		 * @details    Memory of other thread heap is queued and freed by its owner later.
+		 *
+		 * @param      memory  The memory
+		 */
+		static void FreeThreadLocal(void * memory);
+
+	private:
+		static constexpr int kSecondLevelLog2 = 5;
+		static constexpr int kSecondLevelCount = 1 << kSecondLevelLog2;
+		static constexpr int kFirstLevelMax = 32;		//!< maximum block size is 4 GB
+		static constexpr int kFirstLevelShift = kSecondLevelLog2 + 3;
+		static constexpr int kFirstLevelCount = kFirstLevelMax - kFirstLevelShift + 1;
+
+		struct Block;
+		struct Region
+		{
+			char * begin;
+			char * end;
+			bool owned;
+		};
+
+		static TlsfAllocator * GetThreadInstance();
+		static void MapSize(size_t size, int * first_level, int * second_level);
+
+		bool CreateRegion(size_t size);
+		void InsertFreeBlock(Block * block);
+		void RemoveFreeBlock(Block * block);
+		Block * FindFreeBlock(size_t size);
+		Block * MergePrevious(Block * block);
+		Block * MergeNext(Block * block);
+		void TrimFree(Block * block, size_t size);
+		Block * TrimFreeLeading(Block * block, size_t size);
+		void * PrepareUsed(Block * block, size_t size);
+		void PushRemoteFree(void * memory);
+		void FreeRemote();
+
+		uint32_t first_level_bitmap_;
+		uint32_t second_level_bitmaps_[kFirstLevelCount];
+		Block * free_lists_[kFirstLevelCount][kSecondLevelCount];
+		std::vector<Region> regions_;			//!< modified under regions mutex
+		mutable std::mutex regions_mutex_;		//!< lets other threads find heap of memory
+		std::atomic<void *> remote_frees_;		//!< memory freed by other threads
+		size_t region_size_;
+		size_t used_size_;
+		size_t capacity_;
+		MemoryTag tag_;
+		bool growable_;
+	};
+
+	/**
+	 * @brief      STL compatible allocator that uses the specified @ref TlsfAllocator.
+	 */
+	template <typename T>
+	class TlsfStlAllocator
+	{
+		template <typename U>
+		friend class TlsfStlAllocator;
+
+	public:
+		typedef T value_type;
+
+		explicit TlsfStlAllocator(TlsfAllocator * heap) noexcept
+		: heap_(heap)
+		{
+		}
+		template <typename U>
+		TlsfStlAllocator(const TlsfStlAllocator<U>& other) noexcept
+		: heap_(other.heap_)
+		{
+		}
+
+		T * allocate(size_t n)
+		{
+			void * memory = heap_->Allocate(n * sizeof(T), alignof(T));
+			if (memory == nullptr)
+				throw std::bad_alloc();
+			return static_cast<T *>(memory);
+		}
+		void deallocate(T * pointer, size_t) noexcept
+		{
+			heap_->Free(pointer);
+		}
+
+		bool operator ==(const TlsfStlAllocator& other) const noexcept
+		{
+			return heap_ == other.heap_;
+		}
+		bool operator !=(const TlsfStlAllocator& other) const noexcept
+		{
+			return heap_ != other.heap_;
+		}
+
+	private:
+		TlsfAllocator * heap_;
+	};
+
+} // namespace scythe
+
+#endif
\ No newline at end of file
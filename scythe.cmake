@@ -11,26 +11,36 @@ set(PUBLIC_HEADERS
 	./include/scythe/endianness.h
 	./include/scythe/expandable.h
 	./include/scythe/flags.h
+	./include/scythe/frame_allocator.h
+	./include/scythe/frame_statistics.h
 	./include/scythe/graphics_controller.h
 	./include/scythe/graphics_provider.h
 	./include/scythe/keyboard.h
 	./include/scythe/keyboard_controller.h
 	./include/scythe/log.h
+	./include/scythe/memory_tracker.h
 	./include/scythe/logics_controller.h
+	./include/scythe/lz4.h
 	./include/scythe/main.h
 	./include/scythe/mouse.h
 	./include/scythe/mouse_controller.h
 	./include/scythe/non_copyable.h
+	./include/scythe/package.h
 	./include/scythe/physics_controller.h
+	./include/scythe/pool_allocator.h
 	./include/scythe/platform.h
+	./include/scythe/perf_counters.h
 	./include/scythe/platform_includes.h
+	./include/scythe/profiler.h
 	./include/scythe/resource.h
 	./include/scythe/resource_manager.h
 	./include/scythe/singleton.h
 	./include/scythe/string_format.h
 	./include/scythe/string_id.h
+	./include/scythe/thread_pool.h
 	./include/scythe/time_manager.h
 	./include/scythe/timer.h
+	./include/scythe/tlsf_allocator.h
 	./include/scythe/types.h
 	./include/scythe/window_controller.h
 )
@@ -38,27 +48,60 @@ set(PUBLIC_HEADERS
 # Source files
 set(SRC_FILES
 	./src/application/application.cpp
+	./src/application/benchmark.cpp
+	./src/application/benchmark.h
 	./src/application/desktop_application.cpp
+	./src/application/watchdog.cpp
+	./src/application/watchdog.h
 	./src/graphics/graphics_provider.cpp
 	./src/input/keyboard.cpp
 	./src/input/mouse.cpp
+	./src/memory/frame_allocator.cpp
+	./src/memory/memory_tracker.cpp
+	./src/memory/pool_allocator.cpp
+	./src/memory/tlsf_allocator.cpp
 	./src/platform/base_window.h
 	./src/platform/platform_inner.h
 	./src/time/clock.cpp
+	./src/time/frame_statistics.cpp
 	./src/time/time_manager.cpp
 	./src/time/timer.cpp
 	./src/endianness.cpp
 	./src/log.cpp
+	./src/lz4.cpp
+	./src/package.cpp
+	./src/perf_counters.cpp
 	./src/resource_manager.cpp
 	./src/string_id.cpp
+	./src/thread_pool.cpp
 )
-# Windows specific sources
-if (WIN32)
+# Platform specific sources
+if (SCYTHE_HEADLESS)
+	list(APPEND PUBLIC_HEADERS
+		./include/scythe/headless.h
+	)
+	list(APPEND SRC_FILES
+		./src/platform/headless/platform_data.h
+		./src/platform/headless/platform_inner.cpp
+	)
+elseif (WIN32)
 	list(APPEND SRC_FILES
 		./src/platform/windows/platform_data.h
 		./src/platform/windows/platform_inner.cpp
 	)
-endif (WIN32)
+elseif (UNIX AND NOT APPLE)
+	list(APPEND SRC_FILES
+		./src/platform/x11/platform_data.h
+		./src/platform/x11/platform_inner.cpp
+	)
+endif ()
+
+# Profiler specific
+if (SCYTHE_USE_PROFILER)
+	list(APPEND SRC_FILES
+		./src/profiler/profiler.cpp
+	)
+endif (SCYTHE_USE_PROFILER)
 
 # Math specific
 if (SCYTHE_USE_MATH)
@@ -107,6 +150,7 @@ endif (SCYTHE_USE_MATH)
 if (SCYTHE_USE_OPENGL)
 	list(APPEND PUBLIC_HEADERS
 		./include/scythe/opengl/opengl_include.h
+		./include/scythe/opengl/opengl_profiler.h
 		./include/scythe/opengl/opengl_program.h
 		./include/scythe/opengl/opengl_provider.h
 	)
@@ -116,19 +160,51 @@ if (SCYTHE_USE_OPENGL)
 		./src/graphics/opengl/opengl_program.cpp
 		./src/graphics/opengl/opengl_provider.cpp
 	)
-	if (WIN32)
+	if (SCYTHE_USE_PROFILER)
+		list(APPEND SRC_FILES
+			./src/graphics/opengl/opengl_profiler.cpp
+		)
+	endif (SCYTHE_USE_PROFILER)
+	if (SCYTHE_HEADLESS)
+		if (NOT UNIX OR APPLE)
+			message(FATAL_ERROR "Headless OpenGL is supported on Linux only (via EGL)")
+		endif ()
+		list(APPEND SRC_FILES
+			./src/platform/headless/egl.cpp
+			./src/platform/headless/egl.h
+			./src/platform/headless/opengl_provider.cpp
+		)
+	elseif (WIN32)
 		list(APPEND SRC_FILES
 			./src/platform/windows/opengl_provider.cpp
 			./src/platform/windows/wgl.cpp
 			./src/platform/windows/wgl.h
 		)
-	endif (WIN32)
+	elseif (UNIX AND NOT APPLE)
+		list(APPEND SRC_FILES
+			./src/platform/x11/glx.cpp
+			./src/platform/x11/glx.h
+			./src/platform/x11/opengl_provider.cpp
+		)
+	endif ()
 endif (SCYTHE_USE_OPENGL)
 
 # Libraries
 set(LIBRARIES
 	# TODO
 )
+if (UNIX)
+	find_package(Threads REQUIRED)
+	list(APPEND LIBRARIES Threads::Threads)
+	if (SCYTHE_USE_OPENGL)
+		# EGL and GLX are loaded at runtime
+		list(APPEND LIBRARIES ${CMAKE_DL_LIBS})
+	endif (SCYTHE_USE_OPENGL)
+	if (NOT APPLE AND NOT SCYTHE_HEADLESS)
+		find_package(X11 REQUIRED)
+		list(APPEND LIBRARIES X11::X11)
+	endif ()
+endif (UNIX)
 
 # Compile definitions
 set(PRIVATE_DEFINES
@@ -154,6 +230,12 @@ endif (SCYTHE_WINDOWS_NO_CONSOLE)
 if (SCYTHE_USE_OPENGL)
 	target_compile_definitions(${PROJECT_NAME} PUBLIC SCYTHE_USE_OPENGL)
 endif (SCYTHE_USE_OPENGL)
+if (SCYTHE_HEADLESS)
+	target_compile_definitions(${PROJECT_NAME} PUBLIC SCYTHE_HEADLESS)
+endif (SCYTHE_HEADLESS)
+if (SCYTHE_USE_PROFILER)
+	target_compile_definitions(${PROJECT_NAME} PUBLIC SCYTHE_USE_PROFILER)
+endif (SCYTHE_USE_PROFILER)
 
 # OpenGL specific
 if (SCYTHE_USE_OPENGL)
@@ -9,26 +9,36 @@ class ScytheFeatures:
 	# List of features
 	FEATURE_MATH = "Math"
 	FEATURE_OPENGL = "OpenGL"
+	FEATURE_HEADLESS = "Headless"
+	FEATURE_PROFILER = "Profiler"
 
 	# Features paired with its default values
 	features = {
 		FEATURE_MATH: True,
 		FEATURE_OPENGL: True,
+		FEATURE_HEADLESS: False,
+		FEATURE_PROFILER: False,
 	}
 	# Dependencies to other features
 	features_dependecies = {
 		FEATURE_MATH: [],
 		FEATURE_OPENGL: [],
+		FEATURE_HEADLESS: [],
+		FEATURE_PROFILER: [],
 	}
 	# First element is dependency, second is usage of transitive headers (if library headers are passed outside)
 	features_requirements = {
 		FEATURE_MATH: [],
 		FEATURE_OPENGL: [["glad/[>=2.0]", True]],
+		FEATURE_HEADLESS: [],
+		FEATURE_PROFILER: [],
 	}
 	# Maps feature to list of defines
 	features_defines = {
 		FEATURE_MATH: ["SCYTHE_USE_MATH"],
 		FEATURE_OPENGL: ["SCYTHE_USE_OPENGL"],
+		FEATURE_HEADLESS: ["SCYTHE_HEADLESS"],
+		FEATURE_PROFILER: ["SCYTHE_USE_PROFILER"],
 	}
 
 	def __all_dicts_have_same_keys(self, dicts):
@@ -5,9 +5,14 @@
 #include <scythe/defines.h>
 #include <scythe/time_manager.h>
 #include <scythe/resource_manager.h>
+#include <scythe/frame_allocator.h>
+#include <scythe/memory_tracker.h>
 #include <scythe/graphics_provider.h>
+#include <scythe/profiler.h>
 
 #include "../platform/platform_inner.h"
+#include "benchmark.h"
+#include "watchdog.h"
 
 namespace scythe {
 
@@ -27,12 +32,18 @@ namespace scythe {
 	{
 		TimeManager::CreateInstance<TimeManager>();
 		ResourceManager::CreateInstance<ResourceManager>();
+		FrameAllocator::CreateInstance<FrameAllocator>();
+
+		FrameAllocator::GetInstance()->SetParameters(GetFrameArenaSize(), GetFrameArenaCount());
+		ResourceManager::GetInstance()->SetFinalizeBudget(GetResourceFinalizeBudget());
+		ResourceManager::GetInstance()->SetMemoryBudget(GetResourceMemoryBudget());
 
 		// Our engine uses fixed time steps, so make it shared for any consumer
 		TimeManager::GetInstance()->SetFixedFrameTime(GetFrameTime());
 	}
 	void Application::DeinitializeManagers()
 	{
+		FrameAllocator::DestroyInstance();
 		ResourceManager::DestroyInstance();
 		TimeManager::DestroyInstance();
 	}
@@ -40,6 +51,9 @@ namespace scythe {
 	{
 		// Update time manager
 		TimeManager::GetInstance()->Update();
+
+		// Finalize asynchronously loaded resources
+		ResourceManager::GetInstance()->Update();
 	}
 	void Application::Update()
 	{
@@ -48,42 +62,135 @@ namespace scythe {
 	}
 	void Application::RunMainCycle()
 	{
+		if (IsBenchmark())
+		{
+			RunBenchmarkCycle();
+			return;
+		}
+
+		// Exact integer ticks are accumulated, so the loop doesn't lose precision with uptime
 		const Clock& clock = TimeManager::GetInstance()->GetClock();
-		float time_gameclock = clock.GetTime();
-		float time_physics_prev, time_physics_curr;
+		uint64_t time_gameclock = clock.GetTicks();
+		uint64_t time_physics_prev, time_physics_curr;
 		time_physics_prev = time_physics_curr = time_gameclock;
-		const float kTickTime = 1.0f / GetDesiredFrameRate();
+		const uint64_t kTickTicks = Clock::FromSeconds(1.0f / GetDesiredFrameRate());
+
+		Watchdog watchdog;
+		if (IsWatchdogEnabled())
+			watchdog.Start(GetWatchdogStallTime(), GetWatchdogReportFilename());
+
+		FrameAllocator * frame_allocator = FrameAllocator::GetInstance();
 
 		while (!need_quit_)
 		{
+			watchdog.Heartbeat();
+			frame_allocator->BeginFrame();
+			UpdateMemoryStatistics();
+			SCYTHE_PROFILE_SCOPE("Frame");
+
 			// Update physics
 			if (physics_controller_ != nullptr)
 			{
-				time_physics_curr = clock.GetTime();
-				physics_controller_->UpdatePhysics(time_physics_curr - time_physics_prev);
+				SCYTHE_PROFILE_SCOPE("Physics");
+				time_physics_curr = clock.GetTicks();
+				physics_controller_->UpdatePhysics(Clock::ToSeconds(time_physics_curr - time_physics_prev));
 				time_physics_prev = time_physics_curr;
 			}
 
-			UpdateManagers();
+			{
+				SCYTHE_PROFILE_SCOPE("UpdateManagers");
+				UpdateManagers();
+			}
 
 			// Game clock part of the loop. Ticks for every tick_time at average.
-			float dt = clock.GetTime() - time_gameclock;
+			uint64_t dt = clock.GetTicks() - time_gameclock;
 
-			while (dt >= kTickTime)
+			while (dt >= kTickTicks)
 			{
-				dt -= kTickTime;
-				time_gameclock += kTickTime;
+				dt -= kTickTicks;
+				time_gameclock += kTickTicks;
 
 				// Poll platform events
-				platform::PollEvents();
+				{
+					SCYTHE_PROFILE_SCOPE("PollEvents");
+					platform::PollEvents();
+				}
 
 				// Update application
+				{
+					SCYTHE_PROFILE_SCOPE("Update");
+					Update();
+				}
+			}
+
+			// Render a frame
+			RenderFrame();
+		}
+	}
+	void Application::RunBenchmarkCycle()
+	{
+		// Benchmark mode is uncapped and deterministic: every iteration makes exactly
+		// one update with fixed time step and renders one frame.
+		const float kTickTime = GetFrameTime();
+		Benchmark benchmark(GetBenchmarkWarmupFrames(), GetBenchmarkFrames(), kTickTime, IsPerfCountersEnabled());
+
+		FrameAllocator * frame_allocator = FrameAllocator::GetInstance();
+
+		while (!need_quit_ && !benchmark.IsFinished())
+		{
+			frame_allocator->BeginFrame();
+			UpdateMemoryStatistics();
+			SCYTHE_PROFILE_SCOPE("Frame");
+			benchmark.BeginFrame();
+
+			// Update physics
+			if (physics_controller_ != nullptr)
+			{
+				SCYTHE_PROFILE_SCOPE("Physics");
+				benchmark.BeginStage(Benchmark::Stage::kPhysics);
+				physics_controller_->UpdatePhysics(kTickTime);
+				benchmark.EndStage();
+			}
+
+			// Update time manager with fixed time step
+			TimeManager::GetInstance()->UpdateFixed();
+
+			// Finalize asynchronously loaded resources
+			ResourceManager::GetInstance()->Update();
+
+			// Poll platform events
+			platform::PollEvents();
+
+			// Update application
+			{
+				SCYTHE_PROFILE_SCOPE("Update");
+				benchmark.BeginStage(Benchmark::Stage::kLogics);
 				Update();
+				benchmark.EndStage();
 			}
 
 			// Render a frame
+			benchmark.BeginStage(Benchmark::Stage::kRender);
+			RenderFrame();
+			benchmark.EndStage();
+
+			benchmark.EndFrame();
+		}
+
+		benchmark.WriteReport(GetBenchmarkReportFilename());
+	}
+	void Application::RenderFrame()
+	{
+		{
+			SCYTHE_PROFILE_SCOPE("BeginFrame");
 			graphics_provider_->BeginFrame();
+		}
+		{
+			SCYTHE_PROFILE_SCOPE("Render");
 			graphics_controller_->Render();
+		}
+		{
+			SCYTHE_PROFILE_SCOPE("EndFrame");
 			graphics_provider_->EndFrame();
 		}
 	}
@@ -132,13 +239,28 @@ namespace scythe {
 							Show();
 
 							// Run main cycle routine
+							SCYTHE_PROFILE_THREAD("Main");
+#ifdef SCYTHE_USE_PROFILER
+							Profiler::GetInstance()->SetPerfCountersEnabled(IsPerfCountersEnabled());
+#endif
 							RunMainCycle();
+
+#ifdef SCYTHE_USE_PROFILER
+							const char* trace_filename = GetProfileTraceFilename();
+							if (trace_filename != nullptr)
+								Profiler::GetInstance()->ExportChromeTrace(trace_filename);
+#endif
 						}
 						// Unload graphics dependent resources
 						graphics_controller_->UnloadGraphicsResources();
 
 						// Deinitialize all managers
 						DeinitializeManagers();
+
+						// Everything allocated by engine should have been freed by now
+						if (IsMemoryReportEnabled())
+							ReportMemoryStatistics();
+						ReportMemoryLeaks();
 					}
 					// Deinitialize graphics API
 					graphics_provider_->Deinitialize();
@@ -197,5 +319,57 @@ namespace scythe {
 	{
 		return false;
 	}
+	const int Application::GetBenchmarkWarmupFrames() const
+	{
+		return 60;
+	}
+	const int Application::GetBenchmarkFrames() const
+	{
+		return 600;
+	}
+	const char* Application::GetBenchmarkReportFilename() const
+	{
+		return "benchmark.json";
+	}
+	const char* Application::GetProfileTraceFilename() const
+	{
+		return "trace.json";
+	}
+	const bool Application::IsPerfCountersEnabled() const
+	{
+		return false;
+	}
+	const bool Application::IsWatchdogEnabled() const
+	{
+		return false;
+	}
+	const float Application::GetWatchdogStallTime() const
+	{
+		return 0.2f;
+	}
+	const char* Application::GetWatchdogReportFilename() const
+	{
+		return "watchdog.txt";
+	}
+	const size_t Application::GetFrameArenaSize() const
+	{
+		return 1u << 20;
+	}
+	const uint32_t Application::GetFrameArenaCount() const
+	{
+		return 2;
+	}
+	const bool Application::IsMemoryReportEnabled() const
+	{
+		return false;
+	}
+	const float Application::GetResourceFinalizeBudget() const
+	{
+		return 0.004f;
+	}
+	const size_t Application::GetResourceMemoryBudget() const
+	{
+		return 0;
+	}
 
 } // namespace scythe
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include "benchmark.h"
+
+#include <scythe/types.h>
+#include <scythe/log.h>
+#include <scythe/clock.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+/**
+ * @brief      Describes statistics of a single series of values.
+ */
+struct SeriesStatistics
+{
+	double mean;
+	double min;
+	double max;
+	double p50;
+	double p95;
+	double p99;
+};
+
+/**
+ * @brief      Converts clock ticks to milliseconds.
+ *
+ * @param[in]  ticks  The ticks
+ *
+ * @return     The milliseconds.
+ */
+static double TicksToMilliseconds(uint64_t ticks)
+{
+	return static_cast<double>(ticks) * 1000.0 / static_cast<double>(scythe::Clock::kTicksPerSecond);
+}
+
+/**
+ * @brief      Gets a percentile value using nearest-rank method.
+ *
+ * @param[in]  sorted      The sorted values
+ * @param[in]  percentile  The percentile in range [0, 100]
+ *
+ * @return     The percentile value.
+ */
+static double GetPercentile(const std::vector<double>& sorted, double percentile)
+{
+	if (sorted.empty())
+		return 0.0;
+	double rank = std::ceil(percentile / 100.0 * static_cast<double>(sorted.size()));
+	size_t index = (rank < 1.0) ? 0u : static_cast<size_t>(rank) - 1u;
+	return sorted[std::min(index, sorted.size() - 1u)];
+}
+
+/**
+ * @brief      Calculates series statistics.
+ *
+ * @param[in]  values  The values
+ *
+ * @return     The statistics.
+ */
+static SeriesStatistics CalculateStatistics(std::vector<double> values)
+{
+	SeriesStatistics stats = {};
+	if (values.empty())
+		return stats;
+	std::sort(values.begin(), values.end());
+	double sum = 0.0;
+	for (double value : values)
+		sum += value;
+	stats.mean = sum / static_cast<double>(values.size());
+	stats.min = values.front();
+	stats.max = values.back();
+	stats.p50 = ::GetPercentile(values, 50.0);
+	stats.p95 = ::GetPercentile(values, 95.0);
+	stats.p99 = ::GetPercentile(values, 99.0);
+	return stats;
+}
+
+/**
+ * @brief      Writes statistics as JSON object.
+ *
+ * @param      file   The file
+ * @param[in]  stats  The statistics
+ */
+static void WriteStatistics(FILE* file, const SeriesStatistics& stats)
+{
+	fprintf(file, "{\"mean\": %.6f, \"min\": %.6f, \"max\": %.6f, \"p50\": %.6f, \"p95\": %.6f, \"p99\": %.6f}",
+		stats.mean, stats.min, stats.max, stats.p50, stats.p95, stats.p99);
+}
+
+namespace scythe {
+
+	static const char* kStageNames[] = {
+		"physics",
+		"logics",
+		"render",
+	};
+	static_assert(_countof(kStageNames) == static_cast<size_t>(Benchmark::Stage::kCount), "Stage names mismatch");
+
+	Benchmark::Benchmark(int warmup_frames, int measured_frames, float fixed_frame_time, bool use_counters)
+	: warmup_frames_(std::max(warmup_frames, 0))
+	, measured_frames_(std::max(measured_frames, 0))
+	, fixed_frame_time_(fixed_frame_time)
+	, frame_index_(0)
+	, current_stage_(Stage::kCount)
+	, current_sample_()
+	{
+		// Reserve all the memory beforehand to not disturb measured frames
+		samples_.reserve(static_cast<size_t>(measured_frames_));
+		run_start_ = run_end_ = Clock::Now();
+
+		if (use_counters && !counters_.Open())
+			Error("Benchmark: performance counters are not available");
+	}
+	void Benchmark::BeginFrame()
+	{
+		current_sample_ = FrameSample();
+		if (counters_.IsOpened())
+			counters_.Read(&frame_counters_start_);
+		frame_start_ = Clock::Now();
+		if (frame_index_ == warmup_frames_)
+			run_start_ = frame_start_;
+	}
+	void Benchmark::EndFrame()
+	{
+		const uint64_t frame_end = Clock::Now();
+		if (counters_.IsOpened())
+		{
+			PerfCounterValues values;
+			counters_.Read(&values);
+			PerfCounters::Subtract(values, frame_counters_start_, &current_sample_.counters);
+		}
+		if (frame_index_ >= warmup_frames_)
+		{
+			current_sample_.total = ::TicksToMilliseconds(frame_end - frame_start_);
+			samples_.push_back(current_sample_);
+			run_end_ = frame_end;
+		}
+		++frame_index_;
+	}
+	void Benchmark::BeginStage(Stage stage)
+	{
+		current_stage_ = stage;
+		if (counters_.IsOpened())
+			counters_.Read(&stage_counters_start_);
+		stage_start_ = Clock::Now();
+	}
+	void Benchmark::EndStage()
+	{
+		if (current_stage_ == Stage::kCount)
+			return;
+		const uint64_t stage_end = Clock::Now();
+		int index = static_cast<int>(current_stage_);
+		current_sample_.stages[index] += ::TicksToMilliseconds(stage_end - stage_start_);
+		if (counters_.IsOpened())
+		{
+			PerfCounterValues values, delta;
+			counters_.Read(&values);
+			PerfCounters::Subtract(values, stage_counters_start_, &delta);
+			PerfCounterValues& stage_counters = current_sample_.stage_counters[index];
+			for (int i = 0; i < PerfCounters::kNumCounters; ++i)
+				stage_counters.values[i] += delta.values[i];
+		}
+		current_stage_ = Stage::kCount;
+	}
+	bool Benchmark::IsFinished() const
+	{
+		return frame_index_ >= warmup_frames_ + measured_frames_;
+	}
+	void Benchmark::WriteCounters(FILE* file) const
+	{
+		const double num_samples = static_cast<double>(std::max<size_t>(samples_.size(), 1u));
+		std::vector<double> values(samples_.size());
+		double totals[PerfCounters::kNumCounters];
+
+		fprintf(file, "\t\"counters\": {\n");
+
+		// Per frame statistics of every available counter
+		fprintf(file, "\t\t\"frame\": {\n");
+		bool first = true;
+		for (int c = 0; c < PerfCounters::kNumCounters; ++c)
+		{
+			totals[c] = 0.0;
+			const PerfCounter counter = static_cast<PerfCounter>(c);
+			if (!counters_.IsAvailable(counter))
+				continue;
+			for (size_t i = 0; i < samples_.size(); ++i)
+			{
+				values[i] = static_cast<double>(samples_[i].counters.values[c]);
+				totals[c] += values[i];
+			}
+			fprintf(file, first ? "\t\t\t\"%s\": " : ",\n\t\t\t\"%s\": ", PerfCounters::GetName(counter));
+			::WriteStatistics(file, ::CalculateStatistics(values));
+			first = false;
+		}
+		fprintf(file, "\n\t\t},\n");
+
+		// Mean values per frame for every stage
+		fprintf(file, "\t\t\"controllers\": {\n");
+		for (int stage = 0; stage < kNumStages; ++stage)
+		{
+			fprintf(file, "\t\t\t\"%s\": {", kStageNames[stage]);
+			const char* separator = "";
+			for (int c = 0; c < PerfCounters::kNumCounters; ++c)
+			{
+				const PerfCounter counter = static_cast<PerfCounter>(c);
+				if (!counters_.IsAvailable(counter))
+					continue;
+				double sum = 0.0;
+				for (size_t i = 0; i < samples_.size(); ++i)
+					sum += static_cast<double>(samples_[i].stage_counters[stage].values[c]);
+				fprintf(file, "%s\"%s\": %.3f", separator, PerfCounters::GetName(counter), sum / num_samples);
+				separator = ", ";
+			}
+			fprintf(file, (stage + 1 < kNumStages) ? "},\n" : "}\n");
+		}
+		fprintf(file, "\t\t},\n");
+
+		// Derived metrics tell whether run is compute or memory bound
+		const double instructions = totals[static_cast<int>(PerfCounter::kInstructions)];
+		const double cycles = totals[static_cast<int>(PerfCounter::kCycles)];
+		fprintf(file, "\t\t\"derived\": {");
+		if (instructions > 0.0 && cycles > 0.0)
+		{
+			fprintf(file, "\"ipc\": %.4f, \"cache_misses_per_kilo_instruction\": %.4f, \"branch_misses_per_kilo_instruction\": %.4f",
+				instructions / cycles,
+				totals[static_cast<int>(PerfCounter::kCacheMisses)] * 1000.0 / instructions,
+				totals[static_cast<int>(PerfCounter::kBranchMisses)] * 1000.0 / instructions);
+		}
+		fprintf(file, "}\n");
+
+		fprintf(file, "\t},\n");
+	}
+	bool Benchmark::WriteReport(const char* filename) const
+	{
+		FILE* file = fopen(filename, "wt");
+		if (!file)
+		{
+			Error("Can't open benchmark report file '%s'", filename);
+			return false;
+		}
+
+		// Calculate statistics
+		std::vector<double> values(samples_.size());
+		for (size_t i = 0; i < samples_.size(); ++i)
+			values[i] = samples_[i].total;
+		SeriesStatistics frame_stats = ::CalculateStatistics(values);
+		SeriesStatistics stage_stats[kNumStages];
+		for (int stage = 0; stage < kNumStages; ++stage)
+		{
+			for (size_t i = 0; i < samples_.size(); ++i)
+				values[i] = samples_[i].stages[stage];
+			stage_stats[stage] = ::CalculateStatistics(values);
+		}
+		double run_time = ::TicksToMilliseconds(run_end_ - run_start_);
+
+		// Header
+		fprintf(file, "{\n");
+		fprintf(file, "\t\"version\": 1,\n");
+		fprintf(file, "\t\"units\": \"ms\",\n");
+		fprintf(file, "\t\"warmup_frames\": %d,\n", warmup_frames_);
+		fprintf(file, "\t\"measured_frames\": %d,\n", static_cast<int>(samples_.size()));
+		fprintf(file, "\t\"fixed_frame_time\": %.6f,\n", static_cast<double>(fixed_frame_time_) * 1000.0);
+		fprintf(file, "\t\"run_time\": %.6f,\n", run_time);
+
+		// Summary
+		fprintf(file, "\t\"frame\": ");
+		::WriteStatistics(file, frame_stats);
+		fprintf(file, ",\n");
+		fprintf(file, "\t\"controllers\": {\n");
+		for (int stage = 0; stage < kNumStages; ++stage)
+		{
+			fprintf(file, "\t\t\"%s\": ", kStageNames[stage]);
+			::WriteStatistics(file, stage_stats[stage]);
+			fprintf(file, (stage + 1 < kNumStages) ? ",\n" : "\n");
+		}
+		fprintf(file, "\t},\n");
+
+		// Performance counters
+		if (counters_.IsOpened())
+			WriteCounters(file);
+
+		// Per frame samples
+		fprintf(file, "\t\"frames\": [\n");
+		for (size_t i = 0; i < samples_.size(); ++i)
+		{
+			const FrameSample& sample = samples_[i];
+			fprintf(file, "\t\t{\"total\": %.6f", sample.total);
+			for (int stage = 0; stage < kNumStages; ++stage)
+				fprintf(file, ", \"%s\": %.6f", kStageNames[stage], sample.stages[stage]);
+			fprintf(file, (i + 1 < samples_.size()) ? "},\n" : "}\n");
+		}
+		fprintf(file, "\t]\n");
+		fprintf(file, "}\n");
+
+		fclose(file);
+		return true;
+	}
+
+} // namespace scythe
\ No newline at end of file
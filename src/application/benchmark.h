@@ -0,0 +1,114 @@
+#ifndef __SCYTHE_BENCHMARK_H__
+#define __SCYTHE_BENCHMARK_H__
+
+#include <vector>
+#include <cstdio>
+
+#include <scythe/non_copyable.h>
+#include <scythe/perf_counters.h>
+
+namespace scythe {
+
+	/**
+	 * @brief      This class describes a benchmark statistics collector.
+	 * @details    Used by @ref Application in benchmark mode. Skips warm-up frames,
+	 *             records CPU time of every measured frame and its stages and writes
+	 *             JSON report at the end of the run. Optionally samples performance
+	 *             counters of the main thread for frames and stages.
+	 */
+	class Benchmark final
+	: public NonCopyable
+	{
+	public:
+
+		/**
+		 * @brief      Describes a measured stage of the frame.
+		 */
+		enum class Stage
+		{
+			kPhysics,
+			kLogics,
+			kRender,
+			kCount
+		};
+
+		/**
+		 * @brief      Constructs a new instance.
+		 *
+		 * @param[in]  warmup_frames     The number of warm-up frames
+		 * @param[in]  measured_frames   The number of measured frames
+		 * @param[in]  fixed_frame_time  The fixed frame time in seconds
+		 * @param[in]  use_counters      Whether to sample performance counters
+		 */
+		Benchmark(int warmup_frames, int measured_frames, float fixed_frame_time, bool use_counters);
+
+		/**
+		 * @brief      Begins a frame.
+		 */
+		void BeginFrame();
+
+		/**
+		 * @brief      Ends a frame.
+		 */
+		void EndFrame();
+
+		/**
+		 * @brief      Begins a stage of the current frame.
+		 *
+		 * @param[in]  stage  The stage
+		 */
+		void BeginStage(Stage stage);
+
+		/**
+		 * @brief      Ends a previously begun stage of the current frame.
+		 */
+		void EndStage();
+
+		/**
+		 * @brief      Determines if all frames have been processed.
+		 *
+		 * @return     True if finished, False otherwise.
+		 */
+		bool IsFinished() const;
+
+		/**
+		 * @brief      Writes a report in JSON format.
+		 *
+		 * @param[in]  filename  The filename
+		 *
+		 * @return     True on success and false otherwise.
+		 */
+		bool WriteReport(const char* filename) const;
+
+	private:
+		static constexpr int kNumStages = static_cast<int>(Stage::kCount);
+
+		struct FrameSample
+		{
+			double total;				//!< whole frame time in milliseconds
+			double stages[kNumStages];	//!< stage times in milliseconds
+			PerfCounterValues counters;	//!< whole frame counters
+			PerfCounterValues stage_counters[kNumStages];
+		};
+
+		void WriteCounters(FILE* file) const;
+
+		const int warmup_frames_;
+		const int measured_frames_;
+		const float fixed_frame_time_;
+		int frame_index_;
+		Stage current_stage_;
+		uint64_t frame_start_;					//!< in clock ticks
+		uint64_t stage_start_;
+		uint64_t run_start_;
+		uint64_t run_end_;
+		FrameSample current_sample_;
+		std::vector<FrameSample> samples_;
+		PerfCounters counters_;
+		PerfCounterValues frame_counters_start_;
+		PerfCounterValues stage_counters_start_;
+	};
+
+} // namespace scythe
+
+#endif
\ No newline at end of file
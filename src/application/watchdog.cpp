@@ -0,0 +1,287 @@
+#include "watchdog.h"
+
+#include <scythe/defines.h>
+#include <scythe/log.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#if defined(SCYTHE_TARGET_UNIX)
+# include <execinfo.h>
+# include <signal.h>
+# include <semaphore.h>
+# include <cxxabi.h>
+# include <cerrno>
+#endif
+
+#if defined(SCYTHE_TARGET_UNIX)
+
+static constexpr int kMaxBacktraceFrames = 64;
+
+// Backtrace is captured by the monitored thread itself in signal handler
+static void* s_backtrace_frames[kMaxBacktraceFrames];
+static volatile sig_atomic_t s_backtrace_count = 0;
+static sem_t s_backtrace_semaphore;
+static struct sigaction s_old_action;
+
+/**
+ * @brief      Gets the signal used to request backtrace.
+ *
+ * @return     The signal number.
+ */
+static int GetBacktraceSignal()
+{
+	return SIGRTMIN + 3;
+}
+
+/**
+ * @brief      Captures backtrace of the interrupted thread.
+ * @details    backtrace() has been called once before installing the handler,
+ *             so it doesn't allocate here.
+ *
+ * @param[in]  signal  The signal
+ */
+static void BacktraceSignalHandler(int signal)
+{
+	SCYTHE_UNUSED(signal);
+	const int saved_errno = errno;
+	s_backtrace_count = backtrace(s_backtrace_frames, kMaxBacktraceFrames);
+	sem_post(&s_backtrace_semaphore);
+	errno = saved_errno;
+}
+
+/**
+ * @brief      Installs the backtrace signal handler.
+ *
+ * @return     True on success and false otherwise.
+ */
+static bool InstallBacktraceHandler()
+{
+	// Load unwinder library beforehand, it's not safe to do in signal handler
+	void* frames[1];
+	backtrace(frames, 1);
+
+	if (sem_init(&s_backtrace_semaphore, 0, 0) != 0)
+		return false;
+
+	struct sigaction action;
+	std::memset(&action, 0, sizeof(action));
+	action.sa_handler = ::BacktraceSignalHandler;
+	action.sa_flags = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	if (sigaction(::GetBacktraceSignal(), &action, &s_old_action) != 0)
+	{
+		sem_destroy(&s_backtrace_semaphore);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief      Restores previous signal handler.
+ */
+static void UninstallBacktraceHandler()
+{
+	sigaction(::GetBacktraceSignal(), &s_old_action, nullptr);
+	sem_destroy(&s_backtrace_semaphore);
+}
+
+/**
+ * @brief      Requests backtrace of the thread and writes it into file.
+ *
+ * @param[in]  thread  The thread
+ * @param      file    The file
+ */
+static void WriteBacktrace(pthread_t thread, FILE* file)
+{
+	// Drain possible post from previous timed out request
+	while (sem_trywait(&s_backtrace_semaphore) == 0) {}
+
+	s_backtrace_count = 0;
+	if (pthread_kill(thread, ::GetBacktraceSignal()) != 0)
+	{
+		std::fprintf(file, "Backtrace: failed to signal main thread\n");
+		return;
+	}
+
+	struct timespec deadline;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_nsec += 500000000L; // 0.5 seconds
+	if (deadline.tv_nsec >= 1000000000L)
+	{
+		deadline.tv_sec += 1;
+		deadline.tv_nsec -= 1000000000L;
+	}
+	int result;
+	while ((result = sem_timedwait(&s_backtrace_semaphore, &deadline)) != 0 && errno == EINTR) {}
+	if (result != 0)
+	{
+		std::fprintf(file, "Backtrace: main thread didn't respond\n");
+		return;
+	}
+
+	const int count = static_cast<int>(s_backtrace_count);
+	char** symbols = backtrace_symbols(s_backtrace_frames, count);
+	std::fprintf(file, "Backtrace:\n");
+	// Skip signal handler frame
+	for (int i = 1; i < count; ++i)
+	{
+		const char* symbol = (symbols != nullptr) ? symbols[i] : "";
+		// Format is "module(mangled+offset) [address]"
+		const char* begin = std::strchr(symbol, '(');
+		const char* plus = (begin != nullptr) ? std::strchr(begin, '+') : nullptr;
+		char* demangled = nullptr;
+		if (begin != nullptr && plus != nullptr && plus > begin + 1)
+		{
+			std::string mangled(begin + 1, plus);
+			int status = 0;
+			demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+		}
+		if (demangled != nullptr)
+		{
+			std::fprintf(file, "  #%-2d %s (%.*s)\n", i - 1, demangled, static_cast<int>(begin - symbol), symbol);
+			std::free(demangled);
+		}
+		else if (symbols != nullptr)
+			std::fprintf(file, "  #%-2d %s\n", i - 1, symbol);
+		else
+			std::fprintf(file, "  #%-2d %p\n", i - 1, s_backtrace_frames[i]);
+	}
+	std::free(symbols);
+}
+
+#endif // SCYTHE_TARGET_UNIX
+
+namespace scythe {
+
+	Watchdog::Watchdog()
+	: heartbeat_(0)
+	, running_(false)
+	, stall_time_(0.0)
+#ifdef SCYTHE_USE_PROFILER
+	, profiler_thread_(nullptr)
+#endif
+#if defined(SCYTHE_TARGET_UNIX)
+	, backtrace_enabled_(false)
+#endif
+	{
+	}
+	Watchdog::~Watchdog()
+	{
+		Stop();
+	}
+	bool Watchdog::Start(float stall_time, const char* filename)
+	{
+		if (thread_.joinable())
+			return true;
+
+		stall_time_ = static_cast<double>(stall_time);
+		filename_ = filename;
+#ifdef SCYTHE_USE_PROFILER
+		profiler_thread_ = Profiler::GetInstance()->GetThreadData();
+#endif
+#if defined(SCYTHE_TARGET_UNIX)
+		monitored_thread_ = pthread_self();
+		backtrace_enabled_ = ::InstallBacktraceHandler();
+		if (!backtrace_enabled_)
+			Error("Watchdog: failed to install signal handler, backtraces are disabled");
+#endif
+		running_ = true;
+		thread_ = std::thread(&Watchdog::ThreadFunc, this);
+		return true;
+	}
+	void Watchdog::Stop()
+	{
+		if (!thread_.joinable())
+			return;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			running_ = false;
+		}
+		condition_.notify_one();
+		thread_.join();
+#if defined(SCYTHE_TARGET_UNIX)
+		if (backtrace_enabled_)
+			::UninstallBacktraceHandler();
+		backtrace_enabled_ = false;
+#endif
+	}
+	void Watchdog::ThreadFunc()
+	{
+		typedef std::chrono::steady_clock clock;
+
+		// Check a few times per stall time to detect it without much delay
+		const auto period = std::chrono::duration<double>(stall_time_ * 0.25);
+		uint64_t last_heartbeat = heartbeat_.load(std::memory_order_relaxed);
+		clock::time_point last_change = clock::now();
+		bool reported = false;
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		while (running_)
+		{
+			condition_.wait_for(lock, period);
+			if (!running_)
+				break;
+
+			const uint64_t heartbeat = heartbeat_.load(std::memory_order_relaxed);
+			const clock::time_point now = clock::now();
+			if (heartbeat != last_heartbeat)
+			{
+				last_heartbeat = heartbeat;
+				last_change = now;
+				reported = false;
+			}
+			else if (!reported)
+			{
+				const double stall = std::chrono::duration<double>(now - last_change).count();
+				if (stall >= stall_time_)
+				{
+					WriteReport(heartbeat, stall);
+					reported = true;
+				}
+			}
+		}
+	}
+	void Watchdog::WriteReport(uint64_t frame, double stall_time)
+	{
+		FILE* file = std::fopen(filename_.c_str(), "a");
+		if (!file)
+		{
+			Error("Watchdog: failed to open file %s", filename_.c_str());
+			return;
+		}
+
+		char time_string[32];
+		std::time_t time = std::time(nullptr);
+		std::strftime(time_string, sizeof(time_string), "%Y-%m-%d %H:%M:%S", std::localtime(&time));
+		std::fprintf(file, "[%s] Stall detected: frame %llu has been running for at least %.0f ms\n",
+			time_string, static_cast<unsigned long long>(frame), stall_time * 1000.0);
+
+#ifdef SCYTHE_USE_PROFILER
+		Profiler* profiler = Profiler::GetInstance();
+		StringID ids[Profiler::kMaxDepth];
+		const uint32_t depth = profiler->GetZoneStack(profiler_thread_, ids, Profiler::kMaxDepth);
+		std::fprintf(file, "Profiler zones:\n");
+		for (uint32_t i = 0; i < depth; ++i)
+		{
+			const char* name = profiler->GetName(ids[i]);
+			if (name != nullptr)
+				std::fprintf(file, "  %*s%s\n", static_cast<int>(i * 2), "", name);
+			else
+				std::fprintf(file, "  %*s0x%08X\n", static_cast<int>(i * 2), "", ids[i]);
+		}
+#endif
+
+#if defined(SCYTHE_TARGET_UNIX)
+		if (backtrace_enabled_)
+			::WriteBacktrace(monitored_thread_, file);
+#endif
+
+		std::fprintf(file, "\n");
+		std::fclose(file);
+	}
+
+} // namespace scythe
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef __SCYTHE_WATCHDOG_H__
+#define __SCYTHE_WATCHDOG_H__
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+
+#include <scythe/non_copyable.h>
+#include <scythe/platform.h>
+#include <scythe/profiler.h>
+
+#if defined(SCYTHE_TARGET_UNIX)
+# include <pthread.h>
+#endif
+
+namespace scythe {
+
+	/**
+	 * @brief      This class describes a main loop hitch watchdog.
+	 * @details    Used by @ref Application. Main thread just increments heartbeat
+	 *             counter every frame. Watchdog thread checks it periodically and
+	 *             when it hasn't changed longer than stall time, writes report with
+	 *             active profiler zones and main thread backtrace (on Linux).
+	 *             Every stall is reported once.
+	 */
+	class Watchdog final
+	: public NonCopyable
+	{
+	public:
+		Watchdog();
+		~Watchdog();
+
+		/**
+		 * @brief      Starts watchdog thread. Should be called from the monitored thread.
+		 *
+		 * @param[in]  stall_time  The stall time in seconds
+		 * @param[in]  filename    The report filename
+		 *
+		 * @return     True on success and false otherwise.
+		 */
+		bool Start(float stall_time, const char* filename);
+
+		/**
+		 * @brief      Stops watchdog thread.
+		 */
+		void Stop();
+
+		/**
+		 * @brief      Notifies watchdog that monitored thread is alive.
+		 */
+		inline void Heartbeat()
+		{
+			heartbeat_.store(heartbeat_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+
+	private:
+		void ThreadFunc();
+		void WriteReport(uint64_t frame, double stall_time);
+
+		std::atomic<uint64_t> heartbeat_;
+		std::thread thread_;
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		bool running_;						//!< guarded by mutex
+		std::string filename_;
+		double stall_time_;					//!< in seconds
+#ifdef SCYTHE_USE_PROFILER
+		Profiler::ThreadData* profiler_thread_;	//!< profiler data of monitored thread
+#endif
+#if defined(SCYTHE_TARGET_UNIX)
+		pthread_t monitored_thread_;
+		bool backtrace_enabled_;			//!< signal handler has been installed
+#endif
+	};
+
+} // namespace scythe
+
+#endif
\ No newline at end of file
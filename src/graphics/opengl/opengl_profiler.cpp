@@ -0,0 +1,170 @@
+#include <scythe/opengl/opengl_profiler.h>
+
+#include <scythe/opengl/opengl_include.h>
+#include <scythe/log.h>
+
+namespace scythe {
+
+	OpenGLProfiler::OpenGLProfiler()
+	: track_(nullptr)
+	, frame_index_(0)
+	, depth_(0)
+	, overflow_(0)
+	, frames_since_calibration_(0)
+	, clock_offset_(0)
+	, initialized_(false)
+	{
+		for (Frame& frame : frames_)
+		{
+			frame.num_zones = 0;
+			frame.pending = false;
+		}
+	}
+	OpenGLProfiler::~OpenGLProfiler()
+	{
+	}
+	bool OpenGLProfiler::Initialize()
+	{
+		if (initialized_)
+			return true;
+
+		// Timestamp queries are core since OpenGL 3.3
+		GLint major = 0, minor = 0;
+		glGetIntegerv(GL_MAJOR_VERSION, &major);
+		glGetIntegerv(GL_MINOR_VERSION, &minor);
+		if (major * 10 + minor < 33)
+		{
+			Error("GPU profiler requires OpenGL 3.3, but context has %d.%d", major, minor);
+			return false;
+		}
+
+		for (Frame& frame : frames_)
+		{
+			glGenQueries(kMaxZonesPerFrame * 2, frame.queries);
+			frame.num_zones = 0;
+			frame.pending = false;
+		}
+		if (track_ == nullptr)
+			track_ = Profiler::GetInstance()->CreateTrack("GPU");
+		frame_index_ = 0;
+		depth_ = 0;
+		overflow_ = 0;
+
+		Calibrate();
+
+		initialized_ = true;
+		return true;
+	}
+	void OpenGLProfiler::Deinitialize()
+	{
+		if (!initialized_)
+			return;
+		for (Frame& frame : frames_)
+			glDeleteQueries(kMaxZonesPerFrame * 2, frame.queries);
+		initialized_ = false;
+	}
+	void OpenGLProfiler::BeginZone(StringID id)
+	{
+		if (!initialized_)
+			return;
+		Frame& frame = frames_[frame_index_];
+		if (depth_ == kMaxDepth || frame.num_zones == kMaxZonesPerFrame)
+		{
+			++overflow_;
+			return;
+		}
+		const uint32_t index = frame.num_zones++;
+		frame.zones[index].name = id;
+		frame.zones[index].depth = depth_;
+		stack_[depth_++] = index;
+		glQueryCounter(frame.queries[index * 2], GL_TIMESTAMP);
+	}
+	void OpenGLProfiler::EndZone()
+	{
+		if (!initialized_)
+			return;
+		if (overflow_ != 0)
+		{
+			--overflow_;
+			return;
+		}
+		if (depth_ == 0)
+			return;
+		Frame& frame = frames_[frame_index_];
+		const uint32_t index = stack_[--depth_];
+		glQueryCounter(frame.queries[index * 2 + 1], GL_TIMESTAMP);
+	}
+	void OpenGLProfiler::EndFrame()
+	{
+		if (!initialized_)
+			return;
+
+		Frame& frame = frames_[frame_index_];
+		if (depth_ != 0)
+		{
+			// Some zones haven't been ended, so frame can't be collected
+			Error("GPU profiler: %u zones haven't been ended until frame end", depth_);
+			frame.num_zones = 0;
+			depth_ = 0;
+			overflow_ = 0;
+		}
+		frame.pending = (frame.num_zones != 0);
+
+		if (++frames_since_calibration_ >= kCalibrationPeriod)
+			Calibrate();
+
+		// Collect finished frames from the oldest one, stop at the first not ready
+		for (uint32_t i = 1; i <= kFramesInFlight; ++i)
+		{
+			Frame& finished = frames_[(frame_index_ + i) % kFramesInFlight];
+			if (finished.pending && !Collect(finished))
+				break;
+		}
+
+		// Queries of the frame that is still not ready are reused, thus its results are lost
+		frame_index_ = (frame_index_ + 1) % kFramesInFlight;
+		Frame& next = frames_[frame_index_];
+		next.num_zones = 0;
+		next.pending = false;
+	}
+	void OpenGLProfiler::Calibrate()
+	{
+		// GL_TIMESTAMP state gives GPU time without waiting for commands completion
+		const uint64_t cpu_before = Profiler::GetTimestamp();
+		GLint64 gpu_time = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpu_time);
+		const uint64_t cpu_after = Profiler::GetTimestamp();
+		const uint64_t cpu_time = cpu_before + (cpu_after - cpu_before) / 2;
+		clock_offset_ = static_cast<int64_t>(cpu_time) - static_cast<int64_t>(gpu_time);
+		frames_since_calibration_ = 0;
+	}
+	bool OpenGLProfiler::Collect(Frame& frame)
+	{
+		const uint32_t num_queries = frame.num_zones * 2;
+		for (uint32_t i = num_queries; i > 0; --i)
+		{
+			GLuint available = GL_FALSE;
+			glGetQueryObjectuiv(frame.queries[i - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (available == GL_FALSE)
+				return false;
+		}
+
+		Profiler* profiler = Profiler::GetInstance();
+		for (uint32_t i = 0; i < frame.num_zones; ++i)
+		{
+			GLuint64 begin = 0, end = 0;
+			glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+			const int64_t start = static_cast<int64_t>(begin) + clock_offset_;
+			const int64_t finish = static_cast<int64_t>(end) + clock_offset_;
+			if (start < 0 || finish < start)
+				continue;
+			const Zone& zone = frame.zones[i];
+			profiler->AddEvent(track_, zone.name, zone.depth,
+				static_cast<uint64_t>(start), static_cast<uint64_t>(finish));
+		}
+		frame.pending = false;
+		return true;
+	}
+
+} // namespace scythe
\ No newline at end of file
@@ -76,11 +76,13 @@ namespace scythe {
 	 * @param[in]   shader_required  The shader required
 	 * @param[out]  shaders          The shaders
 	 * @param[in]   use_files        Whether use files or sources.
+	 * @param[in]   package          The package to take sources from (by names) or nullptr.
 	 *
 	 * @return      True on success and false otherwise.
 	 */
 	static bool CreateProgram(GLuint& id_, const std::vector<const char*>& shader_files, const std::vector<GLenum>& shader_types, 
-		const std::vector<bool>& shader_required, std::vector<std::optional<OpenGLShader>>& shaders, bool use_files)
+		const std::vector<bool>& shader_required, std::vector<std::optional<OpenGLShader>>& shaders, bool use_files,
+		const Package* package)
 	{
 		for (std::size_t i = 0u; i < shader_types.size(); ++i)
 		{
@@ -94,6 +96,31 @@ namespace scythe {
 			if (use_files && !ReadFile(shader_files[i], shader_code))
 				return false;
 
+			// Uncompressed package blob is used in place, it isn't NULL terminated
+			PackageSpan span = {nullptr, 0};
+			if (package != nullptr)
+			{
+				const PackageEntry* entry = package->FindEntry(RuntimeStringId(shader_files[i]));
+				if (entry == nullptr)
+				{
+					Error("Can't find shader '%s' in package", shader_files[i]);
+					return false;
+				}
+				if ((entry->flags & kPackageEntryCompressed) == 0)
+					span = package->Find(entry->string_id);
+				else
+				{
+					// Compressed blob is decompressed into temporary buffer
+					shader_code.resize(static_cast<size_t>(entry->size));
+					if (!package->Read(*entry, 0, &shader_code[0], shader_code.size()))
+					{
+						Error("Can't read shader '%s' from package", shader_files[i]);
+						return false;
+					}
+					span = PackageSpan{reinterpret_cast<const uint8_t*>(shader_code.data()), shader_code.size()};
+				}
+			}
+
 			auto& shader = shaders[i];
 			// Create an empty shader handle
 			shader.emplace(shader_types[i]);
@@ -102,11 +129,14 @@ namespace scythe {
 			// Send the shader source code to GL
 			// Note that std::string's .c_str is NULL character terminated.
 			const GLchar *source;
-			if (use_files)
+			const GLint length = static_cast<GLint>(span.size);
+			if (package != nullptr)
+				source = (const GLchar *)span.data;
+			else if (use_files)
 				source = (const GLchar *)shader_code.c_str();
 			else
 				source = (const GLchar *)shader_files[i];
-			glShaderSource(shader_id, 1, &source, nullptr);
+			glShaderSource(shader_id, 1, &source, (package != nullptr) ? &length : nullptr);
 
 			// Compile the vertex shader
 			glCompileShader(shader_id);
@@ -178,6 +208,22 @@ namespace scythe {
 	}
 
 	bool OpenGLProgram::Create(const RenderShadersInfo& info, bool use_files)
+	{
+		return Create(info, use_files, nullptr);
+	}
+	bool OpenGLProgram::Create(const ComputeShadersInfo& info, bool use_files)
+	{
+		return Create(info, use_files, nullptr);
+	}
+	bool OpenGLProgram::Create(const RenderShadersInfo& info, const Package& package)
+	{
+		return Create(info, false, &package);
+	}
+	bool OpenGLProgram::Create(const ComputeShadersInfo& info, const Package& package)
+	{
+		return Create(info, false, &package);
+	}
+	bool OpenGLProgram::Create(const RenderShadersInfo& info, bool use_files, const Package* package)
 	{
 		std::vector<const char*> shader_files;
 		std::vector<GLenum> shader_types;
@@ -206,9 +252,9 @@ namespace scythe {
 			return false;
 		}
 
-		return CreateProgram(id_, shader_files, shader_types, shader_required, shaders, use_files);
+		return CreateProgram(id_, shader_files, shader_types, shader_required, shaders, use_files, package);
 	}
-	bool OpenGLProgram::Create(const ComputeShadersInfo& info, bool use_files)
+	bool OpenGLProgram::Create(const ComputeShadersInfo& info, bool use_files, const Package* package)
 	{
 		std::vector<const char*> shader_files;
 		std::vector<GLenum> shader_types;
@@ -233,7 +279,7 @@ namespace scythe {
 			return false;
 		}
 
-		return CreateProgram(id_, shader_files, shader_types, shader_required, shaders, use_files);
+		return CreateProgram(id_, shader_files, shader_types, shader_required, shaders, use_files, package);
 	}
 	void OpenGLProgram::Destroy()
 	{
@@ -129,9 +129,124 @@ namespace scythe {
 		table[0x037] = KeyboardKey::kKpMultiply;
 		table[0x04A] = KeyboardKey::kKpSubstract;
 #elif defined(SCYTHE_TARGET_UNIX)
+		// X11 key codes are evdev scan codes shifted by 8
+		table[0x13] = KeyboardKey::k0;
+		table[0x0A] = KeyboardKey::k1;
+		table[0x0B] = KeyboardKey::k2;
+		table[0x0C] = KeyboardKey::k3;
+		table[0x0D] = KeyboardKey::k4;
+		table[0x0E] = KeyboardKey::k5;
+		table[0x0F] = KeyboardKey::k6;
+		table[0x10] = KeyboardKey::k7;
+		table[0x11] = KeyboardKey::k8;
+		table[0x12] = KeyboardKey::k9;
+		table[0x26] = KeyboardKey::kA;
+		table[0x38] = KeyboardKey::kB;
+		table[0x36] = KeyboardKey::kC;
+		table[0x28] = KeyboardKey::kD;
+		table[0x1A] = KeyboardKey::kE;
+		table[0x29] = KeyboardKey::kF;
+		table[0x2A] = KeyboardKey::kG;
+		table[0x2B] = KeyboardKey::kH;
+		table[0x1F] = KeyboardKey::kI;
+		table[0x2C] = KeyboardKey::kJ;
+		table[0x2D] = KeyboardKey::kK;
+		table[0x2E] = KeyboardKey::kL;
+		table[0x3A] = KeyboardKey::kM;
+		table[0x39] = KeyboardKey::kN;
+		table[0x20] = KeyboardKey::kO;
+		table[0x21] = KeyboardKey::kP;
+		table[0x18] = KeyboardKey::kQ;
+		table[0x1B] = KeyboardKey::kR;
+		table[0x27] = KeyboardKey::kS;
+		table[0x1C] = KeyboardKey::kT;
+		table[0x1E] = KeyboardKey::kU;
+		table[0x37] = KeyboardKey::kV;
+		table[0x19] = KeyboardKey::kW;
+		table[0x35] = KeyboardKey::kX;
+		table[0x1D] = KeyboardKey::kY;
+		table[0x34] = KeyboardKey::kZ;
 
-		// TODO:
+		table[0x30] = KeyboardKey::kApostrophe;
+		table[0x33] = KeyboardKey::kBackslash;
+		table[0x3B] = KeyboardKey::kComma;
+		table[0x15] = KeyboardKey::kEqual;
+		table[0x31] = KeyboardKey::kGraveAccent;
+		table[0x22] = KeyboardKey::kLeftBracket;
+		table[0x14] = KeyboardKey::kMinus;
+		table[0x3C] = KeyboardKey::kPeriod;
+		table[0x23] = KeyboardKey::kRightBracket;
+		table[0x2F] = KeyboardKey::kSemicolon;
+		table[0x3D] = KeyboardKey::kSlash;
+		table[0x5E] = KeyboardKey::kWorld2;
 
+		table[0x16] = KeyboardKey::kBackspace;
+		table[0x77] = KeyboardKey::kDelete;
+		table[0x73] = KeyboardKey::kEnd;
+		table[0x24] = KeyboardKey::kEnter;
+		table[0x09] = KeyboardKey::kEscape;
+		table[0x6E] = KeyboardKey::kHome;
+		table[0x76] = KeyboardKey::kInsert;
+		table[0x87] = KeyboardKey::kMenu;
+		table[0x75] = KeyboardKey::kPageDown;
+		table[0x70] = KeyboardKey::kPageUp;
+		table[0x7F] = KeyboardKey::kPause;
+		table[0x41] = KeyboardKey::kSpace;
+		table[0x17] = KeyboardKey::kTab;
+		table[0x42] = KeyboardKey::kCapsLock;
+		table[0x4D] = KeyboardKey::kNumLock;
+		table[0x4E] = KeyboardKey::kScrollLock;
+		table[0x43] = KeyboardKey::kF1;
+		table[0x44] = KeyboardKey::kF2;
+		table[0x45] = KeyboardKey::kF3;
+		table[0x46] = KeyboardKey::kF4;
+		table[0x47] = KeyboardKey::kF5;
+		table[0x48] = KeyboardKey::kF6;
+		table[0x49] = KeyboardKey::kF7;
+		table[0x4A] = KeyboardKey::kF8;
+		table[0x4B] = KeyboardKey::kF9;
+		table[0x4C] = KeyboardKey::kF10;
+		table[0x5F] = KeyboardKey::kF11;
+		table[0x60] = KeyboardKey::kF12;
+		table[0xBF] = KeyboardKey::kF13;
+		table[0xC0] = KeyboardKey::kF14;
+		table[0xC1] = KeyboardKey::kF15;
+		table[0xC2] = KeyboardKey::kF16;
+		table[0xC3] = KeyboardKey::kF17;
+		table[0xC4] = KeyboardKey::kF18;
+		table[0xC5] = KeyboardKey::kF19;
+		table[0xC6] = KeyboardKey::kF20;
+		table[0x40] = KeyboardKey::kLeftAlt;
+		table[0x25] = KeyboardKey::kLeftControl;
+		table[0x32] = KeyboardKey::kLeftShift;
+		table[0x85] = KeyboardKey::kLeftSuper;
+		table[0x6B] = KeyboardKey::kPrintScreen;
+		table[0x6C] = KeyboardKey::kRightAlt;
+		table[0x69] = KeyboardKey::kRightControl;
+		table[0x3E] = KeyboardKey::kRightShift;
+		table[0x86] = KeyboardKey::kRightSuper;
+		table[0x74] = KeyboardKey::kDown;
+		table[0x71] = KeyboardKey::kLeft;
+		table[0x72] = KeyboardKey::kRight;
+		table[0x6F] = KeyboardKey::kUp;
+
+		table[0x5A] = KeyboardKey::kKp0;
+		table[0x57] = KeyboardKey::kKp1;
+		table[0x58] = KeyboardKey::kKp2;
+		table[0x59] = KeyboardKey::kKp3;
+		table[0x53] = KeyboardKey::kKp4;
+		table[0x54] = KeyboardKey::kKp5;
+		table[0x55] = KeyboardKey::kKp6;
+		table[0x4F] = KeyboardKey::kKp7;
+		table[0x50] = KeyboardKey::kKp8;
+		table[0x51] = KeyboardKey::kKp9;
+		table[0x56] = KeyboardKey::kKpAdd;
+		table[0x5B] = KeyboardKey::kKpDecimal;
+		table[0x6A] = KeyboardKey::kKpDivide;
+		table[0x68] = KeyboardKey::kKpEnter;
+		table[0x7D] = KeyboardKey::kKpEqual;
+		table[0x3F] = KeyboardKey::kKpMultiply;
+		table[0x52] = KeyboardKey::kKpSubstract;
 #elif defined(SCYTHE_TARGET_MAC)
 		table[0x1D] = KeyboardKey::k0;
 		table[0x12] = KeyboardKey::k1;
@@ -1,53 +1,624 @@
 #include <scythe/log.h>
+#include <scythe/clock.h>
+#include <scythe/memory_tracker.h>
 
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
 #include <string>
-#include <string.h>
-#include <stdio.h>
-#include <stdarg.h>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+
+static constexpr uint64_t kRingSize = 1u << 16;			//!< per thread queue size in bytes (power of two)
+static constexpr uint64_t kRecordAlignment = 8;
+static constexpr uint32_t kDefaultRateLimit = 100;		//!< messages per second for the same format
+static constexpr size_t kRateLimitSlots = 64;
+static constexpr size_t kMaxMessageLength = 4096;
+static constexpr uint64_t kNanosecondsPerSecond = 1000000000ull;
+
+static const char* kLevelNames[] = {
+	"debug",
+	"info",
+	"warning",
+	"error",
+};
+static_assert(_countof(kLevelNames) == static_cast<size_t>(scythe::LogLevel::kCount), "Level names mismatch");
+
+#if defined(_DEBUG) || defined(DEBUG)
+static std::atomic<int> s_level(static_cast<int>(scythe::LogLevel::kDebug));
+#else
+static std::atomic<int> s_level(static_cast<int>(scythe::LogLevel::kInfo));
+#endif
+static std::atomic<uint32_t> s_rate_limit(kDefaultRateLimit);
+
+/**
+ * @brief      Kind of the record in queue.
+ */
+enum class LogRecordKind : uint32_t
+{
+	kPadding,							//!< skipped tail of the queue, only size is valid
+	kText,
+	kBinary,
+};
+
+/**
+ * @brief      Record of the message in queue. Packed arguments follow it.
+ */
+struct LogRecordHeader
+{
+	uint32_t size;						//!< whole record size including header and padding
+	uint32_t data_size;					//!< packed arguments size without padding
+	uint32_t suppressed;				//!< number of messages suppressed by rate limit before this one
+	LogRecordKind kind;
+	uint64_t timestamp;
+	const char* format;
+	scythe::LogFormatFunc func;
+	const scythe::LogFormatInfo* info;	//!< nullptr for text message
+	scythe::LogLevel level;
+};
+
+/**
+ * @brief      Single producer single consumer queue of the thread messages.
+ */
+struct LogRing
+{
+	char* buffer;
+	std::atomic<uint64_t> write_position;
+	std::atomic<uint64_t> read_position;
+	std::atomic<uint64_t> dropped;		//!< messages dropped due to full queue
+	std::atomic<bool> abandoned;		//!< owning thread has exited
+};
+
+struct RateLimitSlot
+{
+	const char* format;
+	uint64_t window_start;
+	uint32_t count;
+	uint32_t suppressed;
+};
+
+/**
+ * @brief      Log state of the thread.
+ */
+struct ThreadLogState
+{
+	LogRing* ring = nullptr;
+	RateLimitSlot slots[kRateLimitSlots] = {};
+	bool destroyed = false;
+
+	~ThreadLogState()
+	{
+		// Queue is freed by log thread once it's drained
+		if (ring != nullptr)
+			ring->abandoned.store(true, std::memory_order_release);
+		ring = nullptr;
+		destroyed = true;
+	}
+};
+
+static thread_local ThreadLogState s_thread_state;
+
+/**
+ * @brief      Gets the timestamp.
+ *
+ * @return     The timestamp in nanoseconds.
+ */
+static uint64_t GetTimestamp()
+{
+	return scythe::Clock::Now();
+}
+
+/**
+ * @brief      Gets the rate limit slot of the format.
+ *
+ * @param[in]  format  The format
+ *
+ * @return     The slot.
+ */
+static RateLimitSlot& GetRateLimitSlot(const char* format)
+{
+	uintptr_t hash = reinterpret_cast<uintptr_t>(format);
+	hash ^= hash >> 17;
+	hash *= 0x9E3779B1u;
+	return s_thread_state.slots[(hash >> 7) % kRateLimitSlots];
+}
 
 /**
- * @brief      Outputs error message
+ * @brief      Formats message and removes trailing new lines.
  *
- * @param[in]  message  The message
+ * @param      buffer  The buffer of kMaxMessageLength bytes
+ * @param[in]  format  The format
+ * @param[in]  func    The format function
+ * @param[in]  data    The packed arguments
  */
-static void OutputErrorMessage(const char* message) noexcept
+static void FormatLogMessage(char* buffer, const char* format, scythe::LogFormatFunc func, const void* data)
 {
-	fprintf(stderr, message);
+	int count = func(buffer, kMaxMessageLength, format, data);
+	if (count < 0)
+	{
+		buffer[0] = '\0';
+		return;
+	}
+	size_t length = std::min(static_cast<size_t>(count), kMaxMessageLength - 1);
+	while (length > 0 && (buffer[length - 1] == '\n' || buffer[length - 1] == '\r'))
+		buffer[--length] = '\0';
 }
 
 namespace scythe {
 
-	void Error(const char* format, ...) noexcept
+	/**
+	 * @brief      This class describes asynchronous logger.
+	 * @details    Every thread puts messages with packed arguments into its own queue
+	 *             without locking. Log thread periodically drains all queues, formats
+	 *             messages, sorts them by time and writes them out. Messages that don't
+	 *             fit into full queue are dropped and counted.
+	 */
+	class Logger final
+	{
+	public:
+		Logger();
+		~Logger();
+
+		void Push(LogLevel level, const char* format, LogFormatFunc func, const LogFormatInfo* info,
+			const void* data, size_t size, uint32_t suppressed);
+		void Flush();
+		bool SetFile(const char* filename);
+		bool SetBinaryFile(const char* filename);
+
+	private:
+		struct Entry
+		{
+			uint64_t timestamp;
+			LogLevel level;
+			const LogFormatInfo* info;					//!< binary message has raw arguments instead of text
+			std::string message;
+		};
+
+		LogRing* CreateRing();
+		void ThreadFunc();
+		void Drain();
+		void Output(const Entry& entry);
+		void OutputBinary(const Entry& entry);
+
+		std::thread thread_;
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		std::condition_variable flushed_condition_;
+		bool running_;									//!< guarded by mutex
+		uint64_t flush_requested_;						//!< guarded by mutex
+		uint64_t flush_completed_;						//!< guarded by mutex
+
+		std::mutex rings_mutex_;
+		std::vector<LogRing*> rings_;					//!< guarded by rings mutex
+
+		std::mutex output_mutex_;
+		FILE* file_;									//!< guarded by output mutex
+		FILE* binary_file_;								//!< guarded by output mutex
+		std::unordered_map<StringID, const LogFormatInfo*> binary_formats_; //!< formats written to binary file
+
+		// Used by log thread only
+		std::vector<LogRing*> drained_rings_;
+		std::vector<Entry> entries_;
+		uint64_t start_time_;
+	};
+
+	static std::atomic<int> s_logger_state(0); //!< 0 - not created, 1 - alive, 2 - destroyed
+
+	/**
+	 * @brief      Gets the logger.
+	 *
+	 * @return     The logger or nullptr if it has been already destroyed.
+	 */
+	static Logger* GetLogger()
+	{
+		if (s_logger_state.load(std::memory_order_acquire) == 2)
+			return nullptr;
+		static Logger logger;
+		return &logger;
+	}
+
+	Logger::Logger()
+	: running_(true)
+	, flush_requested_(0)
+	, flush_completed_(0)
+	, file_(nullptr)
+	, binary_file_(nullptr)
+	, start_time_(::GetTimestamp())
 	{
-		va_list ap;
-		va_start(ap, format);
+		s_logger_state.store(1, std::memory_order_release);
+		thread_ = std::thread(&Logger::ThreadFunc, this);
+	}
+	Logger::~Logger()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			running_ = false;
+		}
+		condition_.notify_one();
+		thread_.join();
+		s_logger_state.store(2, std::memory_order_release);
+
+		for (LogRing* ring : rings_)
+		{
+			TaggedFree(ring->buffer);
+			delete ring;
+		}
+		if (file_ != nullptr)
+			std::fclose(file_);
+		if (binary_file_ != nullptr)
+			std::fclose(binary_file_);
+	}
+	LogRing* Logger::CreateRing()
+	{
+		char* buffer = static_cast<char*>(TaggedAllocate(kRingSize, MemoryTag::kLog));
+		if (buffer == nullptr)
+			return nullptr;
+		LogRing* ring = new LogRing();
+		ring->buffer = buffer;
+		ring->write_position.store(0, std::memory_order_relaxed);
+		ring->read_position.store(0, std::memory_order_relaxed);
+		ring->dropped.store(0, std::memory_order_relaxed);
+		ring->abandoned.store(false, std::memory_order_relaxed);
+		std::lock_guard<std::mutex> lock(rings_mutex_);
+		rings_.push_back(ring);
+		return ring;
+	}
+	void Logger::Push(LogLevel level, const char* format, LogFormatFunc func, const LogFormatInfo* info,
+		const void* data, size_t size, uint32_t suppressed)
+	{
+		LogRing* ring = s_thread_state.ring;
+		if (ring == nullptr)
+		{
+			ring = s_thread_state.ring = CreateRing();
+			if (ring == nullptr)
+				return;
+		}
+
+		const uint64_t record_size = (sizeof(LogRecordHeader) + size + kRecordAlignment - 1) & ~(kRecordAlignment - 1);
+		uint64_t write = ring->write_position.load(std::memory_order_relaxed);
+		const uint64_t read = ring->read_position.load(std::memory_order_acquire);
+		const uint64_t offset = write & (kRingSize - 1);
+		const uint64_t to_end = kRingSize - offset;
 
-		int count = vsnprintf(NULL, 0, format, ap);
-		if (count < 1)
+		// Record is never split, the tail is skipped instead
+		const uint64_t needed = (to_end < record_size) ? to_end + record_size : record_size;
+		if (write + needed - read > kRingSize)
 		{
-			va_end(ap);
+			ring->dropped.fetch_add(1, std::memory_order_relaxed);
 			return;
 		}
-		size_t size = static_cast<size_t>(count);
-		char* result = new char[size+2]; // one spot for '\n' and one for '\0'
-		if (!result)
+		if (to_end < record_size)
+		{
+			// Tail that can't hold a header is skipped implicitly
+			if (to_end >= sizeof(LogRecordHeader))
+			{
+				LogRecordHeader* padding = reinterpret_cast<LogRecordHeader*>(ring->buffer + offset);
+				padding->size = static_cast<uint32_t>(to_end);
+				padding->kind = LogRecordKind::kPadding;
+			}
+			write += to_end;
+		}
+
+		char* record = ring->buffer + (write & (kRingSize - 1));
+		LogRecordHeader* header = reinterpret_cast<LogRecordHeader*>(record);
+		header->size = static_cast<uint32_t>(record_size);
+		header->data_size = static_cast<uint32_t>(size);
+		header->suppressed = suppressed;
+		header->kind = (info != nullptr) ? LogRecordKind::kBinary : LogRecordKind::kText;
+		header->timestamp = ::GetTimestamp();
+		header->format = format;
+		header->func = func;
+		header->info = info;
+		header->level = level;
+		if (size != 0)
+			std::memcpy(record + sizeof(LogRecordHeader), data, size);
+		ring->write_position.store(write + record_size, std::memory_order_release);
+
+		// Don't wait for the next period to output errors
+		if (level == LogLevel::kError)
+			condition_.notify_one();
+	}
+	void Logger::Flush()
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		const uint64_t target = ++flush_requested_;
+		condition_.notify_one();
+		flushed_condition_.wait(lock, [this, target]{ return flush_completed_ >= target || !running_; });
+	}
+	bool Logger::SetFile(const char* filename)
+	{
+		std::lock_guard<std::mutex> lock(output_mutex_);
+		if (file_ != nullptr)
+		{
+			std::fclose(file_);
+			file_ = nullptr;
+		}
+		if (filename == nullptr)
+			return true;
+		file_ = std::fopen(filename, "w");
+		return file_ != nullptr;
+	}
+	bool Logger::SetBinaryFile(const char* filename)
+	{
+		std::lock_guard<std::mutex> lock(output_mutex_);
+		if (binary_file_ != nullptr)
+		{
+			std::fclose(binary_file_);
+			binary_file_ = nullptr;
+		}
+		binary_formats_.clear();
+		if (filename == nullptr)
+			return true;
+		binary_file_ = std::fopen(filename, "wb");
+		if (binary_file_ == nullptr)
+			return false;
+		const uint32_t version = kBinaryLogVersion;
+		const uint32_t pointer_size = sizeof(void*);
+		std::fwrite(kBinaryLogMagic, sizeof(kBinaryLogMagic), 1, binary_file_);
+		std::fwrite(&version, sizeof(version), 1, binary_file_);
+		std::fwrite(&pointer_size, sizeof(pointer_size), 1, binary_file_);
+		return true;
+	}
+	void Logger::ThreadFunc()
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		for (;;)
+		{
+			if (running_ && flush_requested_ == flush_completed_)
+				condition_.wait_for(lock, std::chrono::milliseconds(10));
+			const bool running = running_;
+			const uint64_t requested = flush_requested_;
+			lock.unlock();
+
+			Drain();
+
+			lock.lock();
+			flush_completed_ = requested;
+			flushed_condition_.notify_all();
+			if (!running)
+				break;
+		}
+	}
+	void Logger::Drain()
+	{
+		{
+			std::lock_guard<std::mutex> lock(rings_mutex_);
+			drained_rings_ = rings_;
+		}
+
+		char buffer[kMaxMessageLength];
+		for (LogRing* ring : drained_rings_)
+		{
+			// Abandoned queue gets no more records, so it may be freed after draining
+			const bool abandoned = ring->abandoned.load(std::memory_order_acquire);
+			uint64_t read = ring->read_position.load(std::memory_order_relaxed);
+			const uint64_t write = ring->write_position.load(std::memory_order_acquire);
+			while (read < write)
+			{
+				const uint64_t offset = read & (kRingSize - 1);
+				const uint64_t to_end = kRingSize - offset;
+				if (to_end < sizeof(LogRecordHeader))
+				{
+					read += to_end;
+					continue;
+				}
+				const char* record = ring->buffer + offset;
+				const LogRecordHeader* header = reinterpret_cast<const LogRecordHeader*>(record);
+				// Padding record only moves read position
+				if (header->kind == LogRecordKind::kBinary)
+				{
+					// Binary message is formatted on output if there is no binary file
+					const char* data = record + sizeof(LogRecordHeader);
+					entries_.push_back(Entry{header->timestamp, header->level, header->info, std::string(data, header->data_size)});
+				}
+				else if (header->kind == LogRecordKind::kText)
+				{
+					::FormatLogMessage(buffer, header->format, header->func, record + sizeof(LogRecordHeader));
+					Entry entry;
+					entry.timestamp = header->timestamp;
+					entry.level = header->level;
+					entry.info = nullptr;
+					entry.message = buffer;
+					if (header->suppressed != 0)
+					{
+						std::snprintf(buffer, sizeof(buffer), " (%u similar messages suppressed)", header->suppressed);
+						entry.message += buffer;
+					}
+					entries_.push_back(std::move(entry));
+				}
+				read += header->size;
+				ring->read_position.store(read, std::memory_order_release);
+			}
+
+			const uint64_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+			if (dropped != 0)
+			{
+				std::snprintf(buffer, sizeof(buffer), "%llu messages have been dropped due to full queue",
+					static_cast<unsigned long long>(dropped));
+				entries_.push_back(Entry{::GetTimestamp(), LogLevel::kWarning, nullptr, buffer});
+			}
+
+			if (abandoned)
+			{
+				std::lock_guard<std::mutex> lock(rings_mutex_);
+				rings_.erase(std::find(rings_.begin(), rings_.end(), ring));
+				TaggedFree(ring->buffer);
+				delete ring;
+			}
+		}
+
+		if (entries_.empty())
 			return;
-		vsnprintf(&result[0], size+1, format, ap);
-		result[size] = '\0';
-		if (result[size-1] != '\n')
+
+		// Messages of different threads are merged in time order
+		std::stable_sort(entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b){
+			return a.timestamp < b.timestamp;
+		});
+		std::lock_guard<std::mutex> lock(output_mutex_);
+		for (const Entry& entry : entries_)
 		{
-			// Append new line character
-			result[size] = '\n';
-			result[size+1] = '\0';
+			if (entry.info != nullptr && binary_file_ != nullptr)
+				OutputBinary(entry);
+			else
+				Output(entry);
+		}
+		std::fflush(stderr);
+		if (file_ != nullptr)
+			std::fflush(file_);
+		if (binary_file_ != nullptr)
+			std::fflush(binary_file_);
+		entries_.clear();
+	}
+	void Logger::Output(const Entry& entry)
+	{
+		const char* message = entry.message.c_str();
+		char buffer[kMaxMessageLength];
+		if (entry.info != nullptr)
+		{
+			::FormatLogMessage(buffer, entry.info->format, entry.info->func, entry.message.data());
+			message = buffer;
+		}
+		const double time = static_cast<double>(entry.timestamp - std::min(entry.timestamp, start_time_)) * 1e-9;
+		const char* level = kLevelNames[static_cast<int>(entry.level)];
+		std::fprintf(stderr, "[%10.4f] [%s] %s\n", time, level, message);
+		if (file_ != nullptr)
+			std::fprintf(file_, "[%10.4f] [%s] %s\n", time, level, message);
+	}
+	void Logger::OutputBinary(const Entry& entry)
+	{
+		const LogFormatInfo* info = entry.info;
+		auto it = binary_formats_.find(info->id);
+		if (it == binary_formats_.end() || it->second != info)
+		{
+			// Format is written once per file before its first message
+			if (it != binary_formats_.end() && std::strcmp(it->second->format, info->format) != 0)
+				std::fprintf(stderr, "[warning] Binary log formats \"%s\" and \"%s\" have the same identifier\n",
+					it->second->format, info->format);
+			binary_formats_[info->id] = info;
+			const uint8_t type = static_cast<uint8_t>(BinaryLogRecord::kFormat);
+			const uint16_t format_length = static_cast<uint16_t>(std::strlen(info->format));
+			const uint16_t signature_length = static_cast<uint16_t>(std::strlen(info->signature));
+			std::fwrite(&type, sizeof(type), 1, binary_file_);
+			std::fwrite(&info->id, sizeof(info->id), 1, binary_file_);
+			std::fwrite(&format_length, sizeof(format_length), 1, binary_file_);
+			std::fwrite(&signature_length, sizeof(signature_length), 1, binary_file_);
+			std::fwrite(info->format, format_length, 1, binary_file_);
+			std::fwrite(info->signature, signature_length, 1, binary_file_);
 		}
 
-		va_end(ap);
+		const uint8_t type = static_cast<uint8_t>(BinaryLogRecord::kMessage);
+		const uint8_t level = static_cast<uint8_t>(entry.level);
+		const uint64_t time = entry.timestamp - std::min(entry.timestamp, start_time_);
+		const uint16_t size = static_cast<uint16_t>(entry.message.size());
+		char record[sizeof(type) + sizeof(info->id) + sizeof(level) + sizeof(time) + sizeof(size)];
+		char* out = record;
+		std::memcpy(out, &type, sizeof(type)); out += sizeof(type);
+		std::memcpy(out, &info->id, sizeof(info->id)); out += sizeof(info->id);
+		std::memcpy(out, &level, sizeof(level)); out += sizeof(level);
+		std::memcpy(out, &time, sizeof(time)); out += sizeof(time);
+		std::memcpy(out, &size, sizeof(size));
+		std::fwrite(record, sizeof(record), 1, binary_file_);
+		std::fwrite(entry.message.data(), size, 1, binary_file_);
+	}
 
-		// Output
-		::OutputErrorMessage(result);
+	void SetLogLevel(LogLevel level) noexcept
+	{
+		s_level.store(static_cast<int>(level), std::memory_order_relaxed);
+	}
+	LogLevel GetLogLevel() noexcept
+	{
+		return static_cast<LogLevel>(s_level.load(std::memory_order_relaxed));
+	}
+	void SetLogRateLimit(uint32_t messages_per_second) noexcept
+	{
+		s_rate_limit.store(messages_per_second, std::memory_order_relaxed);
+	}
+	bool SetLogFile(const char* filename) noexcept
+	{
+		Logger* logger = GetLogger();
+		return (logger != nullptr) ? logger->SetFile(filename) : false;
+	}
+	bool SetBinaryLogFile(const char* filename) noexcept
+	{
+		Logger* logger = GetLogger();
+		return (logger != nullptr) ? logger->SetBinaryFile(filename) : false;
+	}
+	void FlushLog() noexcept
+	{
+		Logger* logger = GetLogger();
+		if (logger != nullptr)
+			logger->Flush();
+	}
+	bool IsLogAllowed(LogLevel level, const char* format) noexcept
+	{
+		if (static_cast<int>(level) < s_level.load(std::memory_order_relaxed))
+			return false;
+		const uint32_t limit = s_rate_limit.load(std::memory_order_relaxed);
+		if (limit == 0)
+			return true;
+
+		RateLimitSlot& slot = ::GetRateLimitSlot(format);
+		const uint64_t now = ::GetTimestamp();
+		if (slot.format != format)
+		{
+			// Slot is shared with another format, the older one loses its state
+			slot.format = format;
+			slot.window_start = now;
+			slot.count = 0;
+			slot.suppressed = 0;
+		}
+		else if (now - slot.window_start >= kNanosecondsPerSecond)
+		{
+			slot.window_start = now;
+			slot.count = 0;
+		}
+		if (slot.count >= limit)
+		{
+			++slot.suppressed;
+			return false;
+		}
+		++slot.count;
+		return true;
+	}
+	void LogWrite(LogLevel level, const char* format, LogFormatFunc func, const void* data, size_t size) noexcept
+	{
+		uint32_t suppressed = 0;
+		RateLimitSlot& slot = ::GetRateLimitSlot(format);
+		if (slot.format == format)
+		{
+			suppressed = slot.suppressed;
+			slot.suppressed = 0;
+		}
+
+		// Messages of thread local destructors can't use the abandoned queue
+		Logger* logger = s_thread_state.destroyed ? nullptr : GetLogger();
+		if (logger != nullptr)
+		{
+			logger->Push(level, format, func, nullptr, data, size, suppressed);
+			return;
+		}
+
+		// Log thread or thread queue doesn't exist anymore, so output synchronously
+		char buffer[kMaxMessageLength];
+		::FormatLogMessage(buffer, format, func, data);
+		std::fprintf(stderr, "[%s] %s\n", kLevelNames[static_cast<int>(level)], buffer);
+	}
+
+	void LogWriteBinary(LogLevel level, const LogFormatInfo* info, const void* data, size_t size) noexcept
+	{
+		Logger* logger = s_thread_state.destroyed ? nullptr : GetLogger();
+		if (logger != nullptr)
+		{
+			logger->Push(level, info->format, info->func, info, data, size, 0);
+			return;
+		}
 
-		// Finally
-		delete[] result;
+		char buffer[kMaxMessageLength];
+		::FormatLogMessage(buffer, info->format, info->func, data);
+		std::fprintf(stderr, "[%s] %s\n", kLevelNames[static_cast<int>(level)], buffer);
 	}
 
 } // namespace scythe
\ No newline at end of file
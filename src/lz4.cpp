@@ -0,0 +1,196 @@
+#include <scythe/lz4.h>
+
+#include <cstring>
+
+static constexpr size_t kMinMatch = 4;
+static constexpr size_t kLastLiterals = 5;			//!< block always ends with literals
+static constexpr size_t kMatchSearchLimit = 12;		//!< last match should start before that
+static constexpr size_t kMaxOffset = 65535;
+static constexpr uint32_t kHashLog = 12;
+
+static uint32_t Read32(const uint8_t* pointer)
+{
+	uint32_t value;
+	memcpy(&value, pointer, sizeof(value));
+	return value;
+}
+static uint32_t Hash(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - kHashLog);
+}
+/**
+ * @brief      Writes length continuation bytes.
+ *
+ * @param      output  The output pointer
+ * @param[in]  length  The length beyond token value
+ */
+static void WriteLength(uint8_t*& output, size_t length)
+{
+	while (length >= 255)
+	{
+		*output++ = 255;
+		length -= 255;
+	}
+	*output++ = static_cast<uint8_t>(length);
+}
+/**
+ * @brief      Reads length continuation bytes.
+ *
+ * @param      input   The input pointer
+ * @param[in]  end     The input end
+ * @param      length  The length to add to
+ *
+ * @return     True on success and false if input is malformed.
+ */
+static bool ReadLength(const uint8_t*& input, const uint8_t* end, size_t& length)
+{
+	uint8_t value;
+	do
+	{
+		if (input == end)
+			return false;
+		value = *input++;
+		length += value;
+	}
+	while (value == 255);
+	return true;
+}
+
+namespace scythe {
+
+	size_t Lz4CompressBound(size_t size)
+	{
+		return size + size / 255 + 16;
+	}
+	size_t Lz4Compress(const void* source, size_t source_size, void* destination, size_t capacity)
+	{
+		if (capacity < Lz4CompressBound(source_size))
+			return 0;
+
+		const uint8_t* const input = static_cast<const uint8_t*>(source);
+		const uint8_t* const input_end = input + source_size;
+		uint8_t* output = static_cast<uint8_t*>(destination);
+		const uint8_t* anchor = input;
+
+		if (source_size > kMatchSearchLimit)
+		{
+			// Greedy parsing with a single position per hash
+			uint32_t table[1u << kHashLog];
+			memset(table, 0, sizeof(table));
+			const uint8_t* const match_limit = input_end - kMatchSearchLimit;
+			const uint8_t* const copy_limit = input_end - kLastLiterals;
+			const uint8_t* current = input + 1;
+			while (current < match_limit)
+			{
+				const uint32_t sequence = Read32(current);
+				const uint32_t hash = Hash(sequence);
+				const uint8_t* match = input + table[hash];
+				table[hash] = static_cast<uint32_t>(current - input);
+				if (match >= current || static_cast<size_t>(current - match) > kMaxOffset || Read32(match) != sequence)
+				{
+					++current;
+					continue;
+				}
+
+				// Extend match backwards and forwards
+				while (current > anchor && match > input && current[-1] == match[-1])
+				{
+					--current;
+					--match;
+				}
+				const uint8_t* match_end = current + kMinMatch;
+				const uint8_t* reference = match + kMinMatch;
+				while (match_end < copy_limit && *match_end == *reference)
+				{
+					++match_end;
+					++reference;
+				}
+
+				// Emit sequence
+				const size_t literals = static_cast<size_t>(current - anchor);
+				const size_t match_length = static_cast<size_t>(match_end - current) - kMinMatch;
+				uint8_t* token = output++;
+				*token = static_cast<uint8_t>(((literals < 15) ? literals : 15) << 4);
+				if (literals >= 15)
+					::WriteLength(output, literals - 15);
+				memcpy(output, anchor, literals);
+				output += literals;
+				const size_t offset = static_cast<size_t>(current - match);
+				*output++ = static_cast<uint8_t>(offset & 0xFF);
+				*output++ = static_cast<uint8_t>(offset >> 8);
+				*token |= static_cast<uint8_t>((match_length < 15) ? match_length : 15);
+				if (match_length >= 15)
+					::WriteLength(output, match_length - 15);
+
+				current = match_end;
+				anchor = current;
+				if (current < match_limit)
+					table[Hash(Read32(current - 2))] = static_cast<uint32_t>(current - 2 - input);
+			}
+		}
+
+		// Last literals
+		const size_t literals = static_cast<size_t>(input_end - anchor);
+		*output++ = static_cast<uint8_t>(((literals < 15) ? literals : 15) << 4);
+		if (literals >= 15)
+			::WriteLength(output, literals - 15);
+		if (literals != 0)
+			memcpy(output, anchor, literals);
+		output += literals;
+		return static_cast<size_t>(output - static_cast<uint8_t*>(destination));
+	}
+	bool Lz4Decompress(const void* source, size_t source_size, void* destination, size_t destination_size)
+	{
+		const uint8_t* input = static_cast<const uint8_t*>(source);
+		const uint8_t* const input_end = input + source_size;
+		uint8_t* const output_begin = static_cast<uint8_t*>(destination);
+		uint8_t* output = output_begin;
+		uint8_t* const output_end = output_begin + destination_size;
+
+		while (input < input_end)
+		{
+			const uint8_t token = *input++;
+
+			// Literals
+			size_t literals = token >> 4;
+			if (literals == 15 && !::ReadLength(input, input_end, literals))
+				return false;
+			if (literals > static_cast<size_t>(input_end - input) || literals > static_cast<size_t>(output_end - output))
+				return false;
+			if (literals != 0)
+				memcpy(output, input, literals);
+			input += literals;
+			output += literals;
+			if (input == input_end)
+				break; // the last sequence has no match
+
+			// Match
+			if (input_end - input < 2)
+				return false;
+			const size_t offset = static_cast<size_t>(input[0]) | (static_cast<size_t>(input[1]) << 8);
+			input += 2;
+			if (offset == 0 || offset > static_cast<size_t>(output - output_begin))
+				return false;
+			size_t match_length = token & 15;
+			if (match_length == 15 && !::ReadLength(input, input_end, match_length))
+				return false;
+			match_length += kMinMatch;
+			if (match_length > static_cast<size_t>(output_end - output))
+				return false;
+			const uint8_t* match = output - offset;
+			if (offset >= match_length)
+			{
+				memcpy(output, match, match_length);
+				output += match_length;
+			}
+			else
+			{
+				// Overlapping copy repeats the pattern
+				for (size_t i = 0; i < match_length; ++i)
+					*output++ = *match++;
+			}
+		}
+		return output == output_end;
+	}
+
+} // namespace scythe
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include <scythe/frame_allocator.h>
+
+#include <scythe/memory_tracker.h>
+
+static constexpr size_t kDefaultBufferSize = 1u << 20;
+static constexpr uint32_t kDefaultFramesCount = 2;
+
+static std::atomic<uint32_t> s_generation(0);
+static std::mutex s_instance_mutex;
+static scythe::FrameAllocator * s_instance = nullptr;	//!< for returning arenas on thread exit
+
+/**
+ * @brief      Memory block of frame buffer.
+ */
+struct FrameBlock
+{
+	char * memory;
+	size_t size;
+};
+
+/**
+ * @brief      Memory of the thread for one frame.
+ */
+struct FrameBuffer
+{
+	std::vector<FrameBlock> blocks;		//!< allocation is made from the last block
+	char * current;
+	char * end;
+	uint64_t frame;						//!< frame the buffer has been reset for
+};
+
+/**
+ * @brief      Aligns pointer up.
+ *
+ * @param      pointer    The pointer
+ * @param[in]  alignment  The alignment (power of two)
+ *
+ * @return     The aligned pointer.
+ */
+static char * AlignPointer(char * pointer, size_t alignment)
+{
+	const uintptr_t value = reinterpret_cast<uintptr_t>(pointer);
+	return pointer + (((value + alignment - 1) & ~(alignment - 1)) - value);
+}
+
+namespace scythe {
+
+	struct FrameAllocator::ThreadArena
+	{
+		FrameBuffer buffers[kMaxFrames];
+		std::atomic<size_t> used;			//!< used in frame below (read by other threads for statistics)
+		std::atomic<uint64_t> used_frame;
+		std::atomic<size_t> capacity;
+	};
+
+	FrameAllocator::FrameAllocator()
+	: frame_(0)
+	, buffer_size_(kDefaultBufferSize)
+	, frames_count_(kDefaultFramesCount)
+	, generation_(s_generation.fetch_add(1, std::memory_order_relaxed) + 1)
+	{
+		std::lock_guard<std::mutex> lock(s_instance_mutex);
+		s_instance = this;
+	}
+	FrameAllocator::~FrameAllocator()
+	{
+		{
+			std::lock_guard<std::mutex> lock(s_instance_mutex);
+			if (s_instance == this)
+				s_instance = nullptr;
+		}
+		for (ThreadArena * arena : arenas_)
+		{
+			for (FrameBuffer& buffer : arena->buffers)
+				for (FrameBlock& block : buffer.blocks)
+					TaggedFree(block.memory);
+			delete arena;
+		}
+	}
+	void FrameAllocator::SetParameters(size_t buffer_size, uint32_t frames_count)
+	{
+		buffer_size_ = (buffer_size != 0) ? buffer_size : kDefaultBufferSize;
+		frames_count_ = (frames_count < 1) ? 1 : (frames_count > kMaxFrames) ? kMaxFrames : frames_count;
+	}
+	void FrameAllocator::BeginFrame()
+	{
+		// Buffers are reset lazily by their threads on the next allocation
+		frame_.fetch_add(1, std::memory_order_release);
+	}
+	FrameAllocator::ThreadArena * FrameAllocator::GetThreadArena()
+	{
+		struct Cache
+		{
+			uint32_t generation = 0;
+			ThreadArena * arena = nullptr;
+
+			~Cache()
+			{
+				// Arena is given back on thread exit if its allocator is still alive
+				std::lock_guard<std::mutex> lock(s_instance_mutex);
+				if (arena != nullptr && s_instance != nullptr && s_instance->generation_ == generation)
+					s_instance->ReleaseThreadArena(arena);
+			}
+		};
+		static thread_local Cache cache;
+		if (cache.generation == generation_)
+			return cache.arena;
+
+		ThreadArena * arena = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (!free_arenas_.empty())
+			{
+				// Memory of the recent frames is kept, since it may still be in use
+				arena = free_arenas_.back();
+				free_arenas_.pop_back();
+			}
+		}
+		if (arena == nullptr)
+		{
+			arena = new ThreadArena();
+			for (FrameBuffer& buffer : arena->buffers)
+			{
+				buffer.current = nullptr;
+				buffer.end = nullptr;
+				buffer.frame = UINT64_MAX;
+			}
+			arena->used.store(0, std::memory_order_relaxed);
+			arena->used_frame.store(UINT64_MAX, std::memory_order_relaxed);
+			arena->capacity.store(0, std::memory_order_relaxed);
+			std::lock_guard<std::mutex> lock(mutex_);
+			arenas_.push_back(arena);
+		}
+		cache.generation = generation_;
+		cache.arena = arena;
+		return arena;
+	}
+	void FrameAllocator::ReleaseThreadArena(ThreadArena * arena)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		free_arenas_.push_back(arena);
+	}
+	void * FrameAllocator::Allocate(size_t size, size_t alignment)
+	{
+		ThreadArena * arena = GetThreadArena();
+		const uint64_t frame = frame_.load(std::memory_order_acquire);
+		FrameBuffer& buffer = arena->buffers[frame % frames_count_];
+
+		if (buffer.frame != frame)
+		{
+			// Overflowed buffer is replaced by a single block of the whole size
+			if (buffer.blocks.size() > 1)
+			{
+				size_t total_size = 0;
+				for (FrameBlock& block : buffer.blocks)
+				{
+					total_size += block.size;
+					TaggedFree(block.memory);
+				}
+				buffer.blocks.clear();
+				FrameBlock block = { static_cast<char *>(TaggedAllocate(total_size, MemoryTag::kFrame)), total_size };
+				if (block.memory != nullptr)
+					buffer.blocks.push_back(block);
+				else
+					arena->capacity.fetch_sub(total_size, std::memory_order_relaxed);
+			}
+			buffer.current = buffer.blocks.empty() ? nullptr : buffer.blocks.front().memory;
+			buffer.end = buffer.blocks.empty() ? nullptr : buffer.blocks.front().memory + buffer.blocks.front().size;
+			buffer.frame = frame;
+			arena->used.store(0, std::memory_order_relaxed);
+			arena->used_frame.store(frame, std::memory_order_relaxed);
+		}
+
+		char * pointer = ::AlignPointer(buffer.current, alignment);
+		if (buffer.current == nullptr || pointer + size > buffer.end)
+		{
+			// Add block that is twice as large as the last one
+			size_t block_size = buffer.blocks.empty() ? buffer_size_ : buffer.blocks.back().size * 2;
+			if (block_size < size + alignment)
+				block_size = size + alignment;
+			FrameBlock block = { static_cast<char *>(TaggedAllocate(block_size, MemoryTag::kFrame)), block_size };
+			if (block.memory == nullptr)
+				return nullptr;
+			buffer.blocks.push_back(block);
+			arena->capacity.fetch_add(block_size, std::memory_order_relaxed);
+			buffer.end = block.memory + block_size;
+			pointer = ::AlignPointer(block.memory, alignment);
+		}
+		buffer.current = pointer + size;
+		// Only the owning thread writes, so no read-modify-write is needed
+		arena->used.store(arena->used.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+		return pointer;
+	}
+	uint32_t FrameAllocator::GetFramesCount() const
+	{
+		return frames_count_;
+	}
+	size_t FrameAllocator::GetUsedSize() const
+	{
+		const uint64_t frame = frame_.load(std::memory_order_relaxed);
+		size_t used = 0;
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (const ThreadArena * arena : arenas_)
+			if (arena->used_frame.load(std::memory_order_relaxed) == frame)
+				used += arena->used.load(std::memory_order_relaxed);
+		return used;
+	}
+	size_t FrameAllocator::GetCapacity() const
+	{
+		size_t capacity = 0;
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (const ThreadArena * arena : arenas_)
+			capacity += arena->capacity.load(std::memory_order_relaxed);
+		return capacity;
+	}
+
+} // namespace scythe
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include <scythe/memory_tracker.h>
+
+#include <scythe/log.h>
+
+#include <atomic>
+
+/**
+ * @brief      Counters of a single tag. Every tag has its own cache line.
+ */
+struct alignas(64) TagCounters
+{
+	std::atomic<size_t> current;
+	std::atomic<size_t> peak;
+	std::atomic<size_t> count;
+	std::atomic<size_t> frame_count;		//!< allocations since frame start
+	std::atomic<size_t> last_frame_count;
+	std::atomic<size_t> budget;
+	std::atomic<bool> exceeded;				//!< budget has been exceeded since last check
+	bool reported;							//!< warning has been shown (main thread only)
+};
+
+/**
+ * @brief      Header stored right before memory returned by TaggedAllocate.
+ */
+struct TaggedHeader
+{
+	size_t size;
+	uint32_t tag;
+	uint32_t alignment;
+};
+
+static TagCounters s_counters[static_cast<int>(scythe::MemoryTag::kCount)];
+
+static const char * kTagNames[] = {
+	"general",
+	"resource",
+	"time",
+	"frame",
+	"log",
+	"profiler",
+	"heap",
+};
+static_assert(_countof(kTagNames) == static_cast<size_t>(scythe::MemoryTag::kCount), "Tag names mismatch");
+
+/**
+ * @brief      Determines whether memory of the tag lives until process exit.
+ *
+ * @param[in]  tag   The tag
+ *
+ * @return     True if process lifetime, False otherwise.
+ */
+static bool IsProcessLifetime(scythe::MemoryTag tag)
+{
+	return tag == scythe::MemoryTag::kLog || tag == scythe::MemoryTag::kProfiler || tag == scythe::MemoryTag::kHeap;
+}
+
+namespace scythe {
+
+	void * TaggedAllocate(size_t size, MemoryTag tag, size_t alignment)
+	{
+		if (alignment < alignof(TaggedHeader))
+			alignment = alignof(TaggedHeader);
+		// Header is put right before aligned memory
+		const size_t offset = (sizeof(TaggedHeader) + alignment - 1) & ~(alignment - 1);
+		char * base = static_cast<char *>(::operator new(offset + size, std::align_val_t(alignment), std::nothrow));
+		if (base == nullptr)
+			return nullptr;
+		TaggedHeader * header = reinterpret_cast<TaggedHeader *>(base + offset) - 1;
+		header->size = size;
+		header->tag = static_cast<uint32_t>(tag);
+		header->alignment = static_cast<uint32_t>(alignment);
+		TrackAllocation(tag, size);
+		return base + offset;
+	}
+	void TaggedFree(void * memory)
+	{
+		if (memory == nullptr)
+			return;
+		const TaggedHeader * header = static_cast<const TaggedHeader *>(memory) - 1;
+		const size_t alignment = header->alignment;
+		const size_t offset = (sizeof(TaggedHeader) + alignment - 1) & ~(alignment - 1);
+		TrackDeallocation(static_cast<MemoryTag>(header->tag), header->size);
+		::operator delete(static_cast<char *>(memory) - offset, std::align_val_t(alignment));
+	}
+	void TrackAllocation(MemoryTag tag, size_t size)
+	{
+		TagCounters& counters = s_counters[static_cast<int>(tag)];
+		const size_t current = counters.current.fetch_add(size, std::memory_order_relaxed) + size;
+		size_t peak = counters.peak.load(std::memory_order_relaxed);
+		while (current > peak && !counters.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+		{
+		}
+		counters.count.fetch_add(1, std::memory_order_relaxed);
+		counters.frame_count.fetch_add(1, std::memory_order_relaxed);
+
+		// Warning isn't logged here, because logging may allocate itself
+		const size_t budget = counters.budget.load(std::memory_order_relaxed);
+		if (budget != 0 && current > budget && !counters.exceeded.load(std::memory_order_relaxed))
+			counters.exceeded.store(true, std::memory_order_relaxed);
+	}
+	void TrackDeallocation(MemoryTag tag, size_t size)
+	{
+		TagCounters& counters = s_counters[static_cast<int>(tag)];
+		counters.current.fetch_sub(size, std::memory_order_relaxed);
+		counters.count.fetch_sub(1, std::memory_order_relaxed);
+	}
+	void SetMemoryBudget(MemoryTag tag, size_t budget)
+	{
+		TagCounters& counters = s_counters[static_cast<int>(tag)];
+		counters.budget.store(budget, std::memory_order_relaxed);
+		if (budget != 0 && counters.current.load(std::memory_order_relaxed) > budget)
+			counters.exceeded.store(true, std::memory_order_relaxed);
+	}
+	MemoryStatistics GetMemoryStatistics(MemoryTag tag)
+	{
+		const TagCounters& counters = s_counters[static_cast<int>(tag)];
+		MemoryStatistics statistics;
+		statistics.current = counters.current.load(std::memory_order_relaxed);
+		statistics.peak = counters.peak.load(std::memory_order_relaxed);
+		statistics.count = counters.count.load(std::memory_order_relaxed);
+		statistics.frame_count = counters.last_frame_count.load(std::memory_order_relaxed);
+		statistics.budget = counters.budget.load(std::memory_order_relaxed);
+		return statistics;
+	}
+	const char * GetMemoryTagName(MemoryTag tag)
+	{
+		return kTagNames[static_cast<int>(tag)];
+	}
+	void UpdateMemoryStatistics()
+	{
+		for (int i = 0; i < static_cast<int>(MemoryTag::kCount); ++i)
+		{
+			TagCounters& counters = s_counters[i];
+			counters.last_frame_count.store(counters.frame_count.exchange(0, std::memory_order_relaxed),
+				std::memory_order_relaxed);
+
+			// Warning is shown once until usage gets back under budget
+			const size_t budget = counters.budget.load(std::memory_order_relaxed);
+			const size_t current = counters.current.load(std::memory_order_relaxed);
+			if (counters.exceeded.exchange(false, std::memory_order_relaxed) && !counters.reported)
+			{
+				counters.reported = true;
+				Warning("Memory budget of '%s' has been exceeded: peak is %zu of %zu bytes", kTagNames[i],
+					counters.peak.load(std::memory_order_relaxed), budget);
+			}
+			else if (counters.reported && (budget == 0 || current <= budget))
+				counters.reported = false;
+		}
+	}
+	void ReportMemoryStatistics()
+	{
+		Info("Memory usage (current / peak bytes, live allocations):");
+		for (int i = 0; i < static_cast<int>(MemoryTag::kCount); ++i)
+		{
+			const MemoryStatistics statistics = GetMemoryStatistics(static_cast<MemoryTag>(i));
+			Info("  %-10s %12zu / %12zu, %zu", kTagNames[i], statistics.current, statistics.peak, statistics.count);
+		}
+	}
+	size_t ReportMemoryLeaks()
+	{
+		size_t leaked = 0;
+		for (int i = 0; i < static_cast<int>(MemoryTag::kCount); ++i)
+		{
+			const MemoryTag tag = static_cast<MemoryTag>(i);
+			if (::IsProcessLifetime(tag))
+				continue;
+			const MemoryStatistics statistics = GetMemoryStatistics(tag);
+			if (statistics.count == 0)
+				continue;
+			Error("Memory leak: '%s' has %zu allocations of %zu bytes in total", kTagNames[i],
+				statistics.count, statistics.current);
+			leaked += statistics.count;
+		}
+		return leaked;
+	}
+
+} // namespace scythe
\ No newline at end of file
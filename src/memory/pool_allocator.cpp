@@ -0,0 +1,321 @@
+#include <scythe/pool_allocator.h>
+
+#include <scythe/defines.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+static constexpr int kMaxThreadPools = 16;		//!< pools cached by a single thread
+static constexpr uint32_t kCacheBatch = 32;		//!< slots moved between cache and shared list at once
+static constexpr uint32_t kCacheLimit = 64;		//!< free slots kept by thread cache
+static constexpr unsigned char kFreedByte = 0xDD;
+static constexpr unsigned char kAllocatedByte = 0xCD;
+
+static std::atomic<uint32_t> s_pool_id(0);
+
+/**
+ * @brief      Identifiers of alive pools.
+ * @details    Threads return their caches on exit, so it has to be known whether pool still exists.
+ */
+struct PoolRegistry
+{
+	std::mutex mutex;
+	std::vector<uint32_t> ids;
+};
+
+/**
+ * @brief      Gets the pool registry.
+ * @details    Registry is never destroyed, so static pools may outlive other statics.
+ *
+ * @return     The pool registry.
+ */
+static PoolRegistry& GetPoolRegistry()
+{
+	static PoolRegistry * registry = new PoolRegistry();
+	return *registry;
+}
+
+/**
+ * @brief      Determines whether the specified pool is alive. Should be called under registry mutex.
+ *
+ * @param[in]  registry  The registry
+ * @param[in]  id        The pool identifier
+ *
+ * @return     True if alive, False otherwise.
+ */
+static bool IsPoolAlive(const PoolRegistry& registry, uint32_t id)
+{
+	return std::find(registry.ids.begin(), registry.ids.end(), id) != registry.ids.end();
+}
+
+/**
+ * @brief      Gets the next slot of free list.
+ *
+ * @param      memory  The slot memory
+ *
+ * @return     The next slot.
+ */
+static void * GetNext(void * memory)
+{
+	void * next;
+	std::memcpy(&next, memory, sizeof(void *));
+	return next;
+}
+
+/**
+ * @brief      Sets the next slot of free list.
+ *
+ * @param      memory  The slot memory
+ * @param      next    The next slot
+ */
+static void SetNext(void * memory, void * next)
+{
+	std::memcpy(memory, &next, sizeof(void *));
+}
+
+namespace scythe {
+
+	struct PoolAllocator::ThreadCache
+	{
+		void * head;
+		uint32_t count;
+	};
+
+	PoolAllocator::PoolAllocator(size_t object_size, size_t alignment, size_t objects_per_block, MemoryTag tag)
+	: free_list_(nullptr)
+	, alignment_(std::max(alignment, alignof(void *)))
+	, objects_per_block_(std::max<size_t>(objects_per_block, 1))
+	, tag_(tag)
+	, id_(s_pool_id.fetch_add(1, std::memory_order_relaxed) + 1)
+	{
+		// Every slot should be able to hold a free list link
+		slot_size_ = std::max(object_size, sizeof(void *));
+		slot_size_ = (slot_size_ + alignment_ - 1) & ~(alignment_ - 1);
+
+		PoolRegistry& registry = ::GetPoolRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.ids.push_back(id_);
+	}
+	PoolAllocator::~PoolAllocator()
+	{
+		{
+			PoolRegistry& registry = ::GetPoolRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.ids.erase(std::find(registry.ids.begin(), registry.ids.end(), id_));
+		}
+
+		// Objects that are still alive are freed with the pool by its owner
+		size_t free_count = 0;
+		for (void * memory = free_list_; memory != nullptr; memory = ::GetNext(memory))
+			++free_count;
+		for (ThreadCache * cache : caches_)
+			free_count += cache->count;
+		for (size_t i = free_count; i < blocks_.size() * objects_per_block_; ++i)
+			TrackDeallocation(tag_, slot_size_);
+		for (ThreadCache * cache : caches_)
+			delete cache;
+		for (void * block : blocks_)
+			::operator delete(block, std::align_val_t(alignment_));
+	}
+	void * PoolAllocator::Allocate()
+	{
+		void * memory;
+		ThreadCache * cache = GetThreadCache();
+		if (cache != nullptr)
+		{
+			if (cache->count == 0 && !Refill(cache))
+				return nullptr;
+			memory = cache->head;
+			cache->head = ::GetNext(memory);
+			--cache->count;
+		}
+		else
+		{
+			// Thread uses too many pools, so shared list is used directly
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (free_list_ == nullptr && !AllocateBlock())
+				return nullptr;
+			memory = free_list_;
+			free_list_ = ::GetNext(memory);
+		}
+		CheckPoison(memory);
+		TrackAllocation(tag_, slot_size_);
+		return memory;
+	}
+	void PoolAllocator::Free(void * memory)
+	{
+		if (memory == nullptr)
+			return;
+		TrackDeallocation(tag_, slot_size_);
+		Poison(memory);
+		ThreadCache * cache = GetThreadCache();
+		if (cache != nullptr)
+		{
+			::SetNext(memory, cache->head);
+			cache->head = memory;
+			if (++cache->count >= kCacheLimit)
+				Flush(cache, kCacheBatch);
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			::SetNext(memory, free_list_);
+			free_list_ = memory;
+		}
+	}
+	size_t PoolAllocator::GetSlotSize() const
+	{
+		return slot_size_;
+	}
+	size_t PoolAllocator::GetCapacity() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return blocks_.size() * objects_per_block_;
+	}
+	PoolAllocator::ThreadCache * PoolAllocator::GetThreadCache()
+	{
+		struct Entry
+		{
+			uint32_t id;
+			PoolAllocator * pool;
+			ThreadCache * cache;
+		};
+		struct Cache
+		{
+			Entry entries[kMaxThreadPools] = {};
+			bool destroyed = false;
+
+			~Cache()
+			{
+				// Free slots are given back on thread exit if their pools are still alive
+				PoolRegistry& registry = ::GetPoolRegistry();
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				for (Entry& entry : entries)
+				{
+					if (entry.cache != nullptr && ::IsPoolAlive(registry, entry.id))
+						entry.pool->ReleaseThreadCache(entry.cache);
+					entry = Entry();
+				}
+				destroyed = true;
+			}
+		};
+		static thread_local Cache thread_cache;
+		// Objects freed by static destructors use shared list
+		if (thread_cache.destroyed)
+			return nullptr;
+		for (Entry& entry : thread_cache.entries)
+			if (entry.id == id_)
+				return entry.cache;
+
+		// Entry is either empty or belongs to already destroyed pool
+		Entry * free_entry = nullptr;
+		{
+			PoolRegistry& registry = ::GetPoolRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			for (Entry& entry : thread_cache.entries)
+				if (entry.cache == nullptr || !::IsPoolAlive(registry, entry.id))
+				{
+					free_entry = &entry;
+					break;
+				}
+		}
+		if (free_entry == nullptr)
+			return nullptr;
+
+		ThreadCache * cache;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (!free_caches_.empty())
+			{
+				cache = free_caches_.back();
+				free_caches_.pop_back();
+			}
+			else
+			{
+				cache = new ThreadCache();
+				cache->head = nullptr;
+				cache->count = 0;
+				caches_.push_back(cache);
+			}
+		}
+		free_entry->id = id_;
+		free_entry->pool = this;
+		free_entry->cache = cache;
+		return cache;
+	}
+	void PoolAllocator::ReleaseThreadCache(ThreadCache * cache)
+	{
+		if (cache->count != 0)
+			Flush(cache, cache->count);
+		std::lock_guard<std::mutex> lock(mutex_);
+		free_caches_.push_back(cache);
+	}
+	bool PoolAllocator::Refill(ThreadCache * cache)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		while (cache->count < kCacheBatch)
+		{
+			if (free_list_ == nullptr && !AllocateBlock())
+				break;
+			void * memory = free_list_;
+			free_list_ = ::GetNext(memory);
+			::SetNext(memory, cache->head);
+			cache->head = memory;
+			++cache->count;
+		}
+		return cache->count != 0;
+	}
+	void PoolAllocator::Flush(ThreadCache * cache, uint32_t count)
+	{
+		// Chain is detached without lock and then linked to shared list at once
+		void * head = cache->head;
+		void * tail = head;
+		for (uint32_t i = 1; i < count; ++i)
+			tail = ::GetNext(tail);
+		cache->head = ::GetNext(tail);
+		cache->count -= count;
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		::SetNext(tail, free_list_);
+		free_list_ = head;
+	}
+	bool PoolAllocator::AllocateBlock()
+	{
+		char * block = static_cast<char *>(::operator new(slot_size_ * objects_per_block_,
+			std::align_val_t(alignment_), std::nothrow));
+		if (block == nullptr)
+			return false;
+		blocks_.push_back(block);
+		// Slots are linked in address order, so objects allocated together are adjacent
+		for (size_t i = objects_per_block_; i > 0; --i)
+		{
+			void * memory = block + (i - 1) * slot_size_;
+			Poison(memory);
+			::SetNext(memory, free_list_);
+			free_list_ = memory;
+		}
+		return true;
+	}
+	void PoolAllocator::Poison(void * memory)
+	{
+#if defined(DEBUG) || defined(_DEBUG)
+		std::memset(memory, kFreedByte, slot_size_);
+#else
+		SCYTHE_UNUSED(memory);
+#endif
+	}
+	void PoolAllocator::CheckPoison(void * memory)
+	{
+#if defined(DEBUG) || defined(_DEBUG)
+		// Free list link occupies the beginning of the slot
+		const unsigned char * bytes = static_cast<const unsigned char *>(memory);
+		for (size_t i = sizeof(void *); i < slot_size_; ++i)
+			SCYTHE_ASSERT(bytes[i] == kFreedByte && "Pool memory has been modified after free");
+		std::memset(memory, kAllocatedByte, slot_size_);
+#else
+		SCYTHE_UNUSED(memory);
+#endif
+	}
+
+} // namespace scythe
\ No newline at end of file
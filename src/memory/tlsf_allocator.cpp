@@ -0,0 +1,531 @@
+#include <scythe/tlsf_allocator.h>
+
+#include <scythe/defines.h>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
+static constexpr size_t kBlockFreeBit = 1;
+static constexpr size_t kPreviousFreeBit = 2;
+static constexpr size_t kDefaultThreadRegionSize = 1u << 20;
+
+/**
+ * @brief      Finds the last (most significant) set bit.
+ *
+ * @param[in]  value  The value (non zero)
+ *
+ * @return     The bit index.
+ */
+static int FindLastSet(size_t value)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanReverse64(&index, static_cast<unsigned __int64>(value));
+	return static_cast<int>(index);
+#else
+	return 63 - __builtin_clzll(static_cast<unsigned long long>(value));
+#endif
+}
+
+/**
+ * @brief      Finds the first (least significant) set bit.
+ *
+ * @param[in]  value  The value (non zero)
+ *
+ * @return     The bit index.
+ */
+static int FindFirstSet(uint32_t value)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, value);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctz(value);
+#endif
+}
+
+/**
+ * @brief      Aligns value up.
+ *
+ * @param[in]  value      The value
+ * @param[in]  alignment  The alignment (power of two)
+ *
+ * @return     The aligned value.
+ */
+static size_t AlignUp(size_t value, size_t alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief      Heaps of threads. Never destroyed, since memory may be freed after thread exit.
+ */
+struct TlsfThreadHeaps
+{
+	std::mutex mutex;
+	std::vector<scythe::TlsfAllocator *> heaps;
+	std::vector<scythe::TlsfAllocator *> free_heaps;	//!< heaps of exited threads
+};
+
+/**
+ * @brief      Gets the thread heaps.
+ *
+ * @return     The thread heaps.
+ */
+static TlsfThreadHeaps& GetThreadHeaps()
+{
+	static TlsfThreadHeaps * heaps = new TlsfThreadHeaps();
+	return *heaps;
+}
+
+namespace scythe {
+
+	/**
+	 * Block layout: pointer to the previous physical block is stored in the last word of
+	 * previous block and is valid only if that block is free, so used block overhead is
+	 * just its size. Free list links occupy the payload of free block.
+	 */
+	struct TlsfAllocator::Block
+	{
+		static constexpr size_t kOverhead = sizeof(size_t);
+		static constexpr size_t kPayloadOffset = sizeof(Block *) + sizeof(size_t);
+		static constexpr size_t kMinSize = sizeof(Block *) * 3;	//!< free block should hold links
+
+		Block * previous_physical;
+		size_t size;						//!< payload size and flags in low bits
+		Block * next_free;
+		Block * previous_free;
+
+		size_t GetSize() const
+		{
+			return size & ~(kBlockFreeBit | kPreviousFreeBit);
+		}
+		void SetSize(size_t new_size)
+		{
+			size = new_size | (size & (kBlockFreeBit | kPreviousFreeBit));
+		}
+		bool IsFree() const
+		{
+			return (size & kBlockFreeBit) != 0;
+		}
+		bool IsPreviousFree() const
+		{
+			return (size & kPreviousFreeBit) != 0;
+		}
+		void SetPreviousFree(bool free)
+		{
+			size = free ? (size | kPreviousFreeBit) : (size & ~kPreviousFreeBit);
+		}
+		void * GetPayload()
+		{
+			return reinterpret_cast<char *>(this) + kPayloadOffset;
+		}
+		static Block * FromPayload(const void * memory)
+		{
+			return reinterpret_cast<Block *>(const_cast<char *>(static_cast<const char *>(memory)) - kPayloadOffset);
+		}
+		Block * GetNext()
+		{
+			return reinterpret_cast<Block *>(static_cast<char *>(GetPayload()) + GetSize() - kOverhead);
+		}
+		Block * LinkNext()
+		{
+			Block * next = GetNext();
+			next->previous_physical = this;
+			return next;
+		}
+		void MarkFree()
+		{
+			LinkNext()->SetPreviousFree(true);
+			size |= kBlockFreeBit;
+		}
+		void MarkUsed()
+		{
+			GetNext()->SetPreviousFree(false);
+			size &= ~kBlockFreeBit;
+		}
+		bool CanSplit(size_t new_size) const
+		{
+			return GetSize() >= sizeof(Block) + new_size;
+		}
+		Block * Split(size_t new_size)
+		{
+			// Remaining block starts right after new payload
+			Block * remaining = reinterpret_cast<Block *>(static_cast<char *>(GetPayload()) + new_size - kOverhead);
+			const size_t remaining_size = GetSize() - (new_size + kOverhead);
+			remaining->size = remaining_size;
+			SetSize(new_size);
+			remaining->MarkFree();
+			return remaining;
+		}
+		Block * Absorb(Block * block)
+		{
+			size += block->GetSize() + kOverhead;
+			LinkNext();
+			return this;
+		}
+	};
+
+	/**
+	 * @brief      Maps block size to free list indices.
+	 *
+	 * @param[in]  size          The size
+	 * @param      first_level   The first level index
+	 * @param      second_level  The second level index
+	 */
+	void TlsfAllocator::MapSize(size_t size, int * first_level, int * second_level)
+	{
+		constexpr size_t kSmallBlockSize = size_t(1) << (kFirstLevelShift);
+		if (size < kSmallBlockSize)
+		{
+			// Small blocks are linearly distributed in the first list
+			*first_level = 0;
+			*second_level = static_cast<int>(size / (kSmallBlockSize / kSecondLevelCount));
+		}
+		else
+		{
+			const int last_bit = ::FindLastSet(size);
+			*second_level = static_cast<int>(size >> (last_bit - kSecondLevelLog2)) ^ kSecondLevelCount;
+			*first_level = last_bit - (kFirstLevelShift - 1);
+		}
+	}
+
+	TlsfAllocator::TlsfAllocator(size_t region_size, bool growable, MemoryTag tag)
+	: first_level_bitmap_(0)
+	, remote_frees_(nullptr)
+	, region_size_(region_size)
+	, used_size_(0)
+	, capacity_(0)
+	, tag_(tag)
+	, growable_(growable)
+	{
+		std::memset(second_level_bitmaps_, 0, sizeof(second_level_bitmaps_));
+		std::memset(free_lists_, 0, sizeof(free_lists_));
+		if (region_size_ != 0)
+			CreateRegion(region_size_);
+	}
+	TlsfAllocator::~TlsfAllocator()
+	{
+		for (Region& region : regions_)
+			if (region.owned)
+				TaggedFree(region.begin);
+	}
+	bool TlsfAllocator::AddRegion(void * memory, size_t size)
+	{
+		// First block header starts one word before the region, since its previous link is never used
+		constexpr size_t kRegionOverhead = 2 * Block::kOverhead;
+		constexpr size_t kMaxBlockSize = size_t(1) << kFirstLevelMax;
+		if (memory == nullptr || (reinterpret_cast<uintptr_t>(memory) & (kAlignment - 1)) != 0)
+		{
+			SCYTHE_ASSERT(!"TLSF region should be aligned");
+			return false;
+		}
+		if (size < kRegionOverhead + Block::kMinSize)
+			return false;
+		const size_t block_size = std::min((size - kRegionOverhead) & ~(kAlignment - 1), kMaxBlockSize - kAlignment);
+
+		Block * block = reinterpret_cast<Block *>(static_cast<char *>(memory) - Block::kOverhead);
+		block->size = block_size;
+		block->MarkFree();
+		block->SetPreviousFree(false);
+		InsertFreeBlock(block);
+
+		// Zero sized used sentinel terminates the region
+		Block * sentinel = block->LinkNext();
+		sentinel->size = 0;
+		sentinel->SetPreviousFree(true);
+
+		{
+			std::lock_guard<std::mutex> lock(regions_mutex_);
+			Region region = { static_cast<char *>(memory), static_cast<char *>(memory) + size, false };
+			regions_.push_back(region);
+		}
+		capacity_ += size;
+		return true;
+	}
+	bool TlsfAllocator::CreateRegion(size_t size)
+	{
+		void * memory = TaggedAllocate(size, tag_, kAlignment);
+		if (memory == nullptr)
+			return false;
+		if (!AddRegion(memory, size))
+		{
+			TaggedFree(memory);
+			return false;
+		}
+		std::lock_guard<std::mutex> lock(regions_mutex_);
+		regions_.back().owned = true;
+		return true;
+	}
+	void * TlsfAllocator::Allocate(size_t size, size_t alignment)
+	{
+		constexpr size_t kMaxBlockSize = size_t(1) << kFirstLevelMax;
+		if (size == 0 || size >= kMaxBlockSize)
+			return nullptr;
+		if (alignment < kAlignment)
+			alignment = kAlignment;
+		const size_t adjusted_size = std::max(::AlignUp(size, kAlignment), Block::kMinSize);
+
+		// Bigger block is searched for alignment, so that leading gap can become a free block
+		const size_t search_size = (alignment > kAlignment)
+			? ::AlignUp(adjusted_size + alignment + sizeof(Block), kAlignment)
+			: adjusted_size;
+		Block * block = FindFreeBlock(search_size);
+		if (block == nullptr && growable_)
+		{
+			// The only unbounded operation. Search rounds size up to the next list, so region is larger.
+			const size_t needed = search_size + search_size / kSecondLevelCount + sizeof(Block) + 2 * Block::kOverhead;
+			if (!CreateRegion(std::max(region_size_, needed)))
+				return nullptr;
+			block = FindFreeBlock(search_size);
+		}
+		if (block == nullptr)
+			return nullptr;
+
+		if (alignment > kAlignment)
+		{
+			char * payload = static_cast<char *>(block->GetPayload());
+			char * aligned = payload + (::AlignUp(reinterpret_cast<uintptr_t>(payload), alignment) - reinterpret_cast<uintptr_t>(payload));
+			size_t gap = static_cast<size_t>(aligned - payload);
+			if (gap != 0 && gap < sizeof(Block))
+			{
+				// Gap should be large enough to hold a free block
+				aligned += ::AlignUp(sizeof(Block) - gap, alignment);
+				gap = static_cast<size_t>(aligned - payload);
+			}
+			if (gap != 0)
+				block = TrimFreeLeading(block, gap);
+		}
+		return PrepareUsed(block, adjusted_size);
+	}
+	void TlsfAllocator::Free(void * memory)
+	{
+		if (memory == nullptr)
+			return;
+		Block * block = Block::FromPayload(memory);
+		SCYTHE_ASSERT(!block->IsFree() && "Block has been already freed");
+		used_size_ -= block->GetSize();
+		block->MarkFree();
+		block = MergePrevious(block);
+		block = MergeNext(block);
+		InsertFreeBlock(block);
+	}
+	size_t TlsfAllocator::GetAllocatedSize(const void * memory) const
+	{
+		return (memory != nullptr) ? Block::FromPayload(memory)->GetSize() : 0;
+	}
+	size_t TlsfAllocator::GetUsedSize() const
+	{
+		return used_size_;
+	}
+	size_t TlsfAllocator::GetCapacity() const
+	{
+		return capacity_;
+	}
+	bool TlsfAllocator::Contains(const void * memory) const
+	{
+		const char * pointer = static_cast<const char *>(memory);
+		std::lock_guard<std::mutex> lock(regions_mutex_);
+		for (const Region& region : regions_)
+			if (pointer >= region.begin && pointer < region.end)
+				return true;
+		return false;
+	}
+	void TlsfAllocator::InsertFreeBlock(Block * block)
+	{
+		int first_level, second_level;
+		MapSize(block->GetSize(), &first_level, &second_level);
+		Block * current = free_lists_[first_level][second_level];
+		block->next_free = current;
+		block->previous_free = nullptr;
+		if (current != nullptr)
+			current->previous_free = block;
+		free_lists_[first_level][second_level] = block;
+		first_level_bitmap_ |= 1u << first_level;
+		second_level_bitmaps_[first_level] |= 1u << second_level;
+	}
+	void TlsfAllocator::RemoveFreeBlock(Block * block)
+	{
+		int first_level, second_level;
+		MapSize(block->GetSize(), &first_level, &second_level);
+		Block * previous = block->previous_free;
+		Block * next = block->next_free;
+		if (next != nullptr)
+			next->previous_free = previous;
+		if (previous != nullptr)
+			previous->next_free = next;
+		if (free_lists_[first_level][second_level] == block)
+		{
+			free_lists_[first_level][second_level] = next;
+			if (next == nullptr)
+			{
+				second_level_bitmaps_[first_level] &= ~(1u << second_level);
+				if (second_level_bitmaps_[first_level] == 0)
+					first_level_bitmap_ &= ~(1u << first_level);
+			}
+		}
+	}
+	TlsfAllocator::Block * TlsfAllocator::FindFreeBlock(size_t size)
+	{
+		// Size is rounded up to the next list, so any block of that list fits
+		constexpr size_t kSmallBlockSize = size_t(1) << (kFirstLevelShift);
+		if (size >= kSmallBlockSize)
+			size += (size_t(1) << (::FindLastSet(size) - kSecondLevelLog2)) - 1;
+		int first_level, second_level;
+		MapSize(size, &first_level, &second_level);
+		if (first_level >= kFirstLevelCount)
+			return nullptr;
+
+		uint32_t second_level_map = second_level_bitmaps_[first_level] & (~0u << second_level);
+		if (second_level_map == 0)
+		{
+			const uint32_t first_level_map = (first_level + 1 < 32) ? (first_level_bitmap_ & (~0u << (first_level + 1))) : 0;
+			if (first_level_map == 0)
+				return nullptr;
+			first_level = ::FindFirstSet(first_level_map);
+			second_level_map = second_level_bitmaps_[first_level];
+		}
+		second_level = ::FindFirstSet(second_level_map);
+		Block * block = free_lists_[first_level][second_level];
+		RemoveFreeBlock(block);
+		return block;
+	}
+	TlsfAllocator::Block * TlsfAllocator::MergePrevious(Block * block)
+	{
+		if (!block->IsPreviousFree())
+			return block;
+		Block * previous = block->previous_physical;
+		RemoveFreeBlock(previous);
+		return previous->Absorb(block);
+	}
+	TlsfAllocator::Block * TlsfAllocator::MergeNext(Block * block)
+	{
+		Block * next = block->GetNext();
+		if (!next->IsFree())
+			return block;
+		RemoveFreeBlock(next);
+		return block->Absorb(next);
+	}
+	void TlsfAllocator::TrimFree(Block * block, size_t size)
+	{
+		if (!block->CanSplit(size))
+			return;
+		Block * remaining = block->Split(size);
+		block->LinkNext();
+		remaining->SetPreviousFree(true);
+		InsertFreeBlock(remaining);
+	}
+	TlsfAllocator::Block * TlsfAllocator::TrimFreeLeading(Block * block, size_t size)
+	{
+		if (!block->CanSplit(size - Block::kOverhead))
+			return block;
+		// Leading part stays free and the rest is used for allocation
+		Block * remaining = block->Split(size - Block::kOverhead);
+		remaining->SetPreviousFree(true);
+		block->LinkNext();
+		InsertFreeBlock(block);
+		return remaining;
+	}
+	void * TlsfAllocator::PrepareUsed(Block * block, size_t size)
+	{
+		TrimFree(block, size);
+		block->MarkUsed();
+		used_size_ += block->GetSize();
+		return block->GetPayload();
+	}
+	void TlsfAllocator::PushRemoteFree(void * memory)
+	{
+		void * head = remote_frees_.load(std::memory_order_relaxed);
+		do
+		{
+			std::memcpy(memory, &head, sizeof(void *));
+		}
+		while (!remote_frees_.compare_exchange_weak(head, memory, std::memory_order_release, std::memory_order_relaxed));
+	}
+	void TlsfAllocator::FreeRemote()
+	{
+		if (remote_frees_.load(std::memory_order_relaxed) == nullptr)
+			return;
+		void * memory = remote_frees_.exchange(nullptr, std::memory_order_acquire);
+		while (memory != nullptr)
+		{
+			void * next;
+			std::memcpy(&next, memory, sizeof(void *));
+			Free(memory);
+			memory = next;
+		}
+	}
+	TlsfAllocator * TlsfAllocator::GetThreadInstance()
+	{
+		struct Holder
+		{
+			TlsfAllocator * heap = nullptr;
+			bool destroyed = false;
+
+			~Holder()
+			{
+				// Heap may still have memory used by other threads, so it's given to the next thread
+				destroyed = true;
+				if (heap == nullptr)
+					return;
+				TlsfThreadHeaps& heaps = ::GetThreadHeaps();
+				std::lock_guard<std::mutex> lock(heaps.mutex);
+				heaps.free_heaps.push_back(heap);
+				heap = nullptr;
+			}
+		};
+		static thread_local Holder holder;
+		if (holder.heap != nullptr || holder.destroyed)
+			return holder.heap;
+
+		TlsfThreadHeaps& heaps = ::GetThreadHeaps();
+		std::lock_guard<std::mutex> lock(heaps.mutex);
+		if (!heaps.free_heaps.empty())
+		{
+			holder.heap = heaps.free_heaps.back();
+			heaps.free_heaps.pop_back();
+		}
+		else
+		{
+			holder.heap = new TlsfAllocator(kDefaultThreadRegionSize, true, MemoryTag::kHeap);
+			heaps.heaps.push_back(holder.heap);
+		}
+		return holder.heap;
+	}
+	void * TlsfAllocator::AllocateThreadLocal(size_t size, size_t alignment)
+	{
+		TlsfAllocator * heap = GetThreadInstance();
+		if (heap == nullptr)
+			return nullptr;
+		heap->FreeRemote();
+		return heap->Allocate(size, alignment);
+	}
+	void TlsfAllocator::FreeThreadLocal(void * memory)
+	{
+		if (memory == nullptr)
+			return;
+		TlsfAllocator * heap = GetThreadInstance();
+		if (heap != nullptr && heap->Contains(memory))
+		{
+			heap->Free(memory);
+			return;
+		}
+
+		// Memory of other thread heap is freed by its owner
+		TlsfThreadHeaps& heaps = ::GetThreadHeaps();
+		std::lock_guard<std::mutex> lock(heaps.mutex);
+		for (TlsfAllocator * owner : heaps.heaps)
+			if (owner->Contains(memory))
+			{
+				owner->PushRemoteFree(memory);
+				return;
+			}
+		SCYTHE_ASSERT(!"Memory doesn't belong to any thread heap");
+	}
+
+} // namespace scythe
\ No newline at end of file
@@ -0,0 +1,321 @@
+#include <scythe/package.h>
+
+#include <scythe/platform.h>
+#include <scythe/endianness.h>
+#include <scythe/log.h>
+#include <scythe/lz4.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#ifdef SCYTHE_TARGET_WINDOWS
+# ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+# endif
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+/**
+ * @brief      Shared state of parallel read, outlives the read for late helpers.
+ */
+struct ParallelRead
+{
+	std::atomic<uint64_t> next_block;
+	std::atomic<uint64_t> done_count;
+	std::atomic<bool> failed;
+	std::mutex mutex;
+	std::condition_variable condition;
+};
+
+namespace scythe {
+
+	Package::Package()
+	: data_(nullptr)
+	, size_(0)
+	, entries_(nullptr)
+	, entries_count_(0)
+	, block_size_(0)
+	, mapping_(nullptr)
+	{
+	}
+	Package::~Package()
+	{
+		Close();
+	}
+	bool Package::Open(const char* filename)
+	{
+		Close();
+
+		// Format is little endian and read in place
+		if (!IsLittleEndian())
+		{
+			Error("Packages aren't supported on big endian platforms");
+			return false;
+		}
+
+#ifdef SCYTHE_TARGET_WINDOWS
+		HANDLE file = ::CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			Error("Can't open package '%s'", filename);
+			return false;
+		}
+		LARGE_INTEGER file_size;
+		if (!::GetFileSizeEx(file, &file_size) || file_size.QuadPart < static_cast<LONGLONG>(sizeof(PackageHeader)))
+		{
+			Error("Package '%s' is too small", filename);
+			::CloseHandle(file);
+			return false;
+		}
+		HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		::CloseHandle(file);
+		if (mapping == nullptr)
+		{
+			Error("Can't map package '%s'", filename);
+			return false;
+		}
+		void* data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (data == nullptr)
+		{
+			Error("Can't map package '%s'", filename);
+			::CloseHandle(mapping);
+			return false;
+		}
+		mapping_ = mapping;
+		data_ = static_cast<const uint8_t*>(data);
+		size_ = static_cast<size_t>(file_size.QuadPart);
+#else
+		int file = ::open(filename, O_RDONLY);
+		if (file < 0)
+		{
+			Error("Can't open package '%s'", filename);
+			return false;
+		}
+		struct stat file_stat;
+		if (::fstat(file, &file_stat) != 0 || file_stat.st_size < static_cast<off_t>(sizeof(PackageHeader)))
+		{
+			Error("Package '%s' is too small", filename);
+			::close(file);
+			return false;
+		}
+		void* data = ::mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		// Mapping stays valid after closing the descriptor
+		::close(file);
+		if (data == MAP_FAILED)
+		{
+			Error("Can't map package '%s'", filename);
+			return false;
+		}
+		data_ = static_cast<const uint8_t*>(data);
+		size_ = static_cast<size_t>(file_stat.st_size);
+#endif
+
+		// Validate header and table of contents, so lookups don't need any checks
+		const PackageHeader* header = reinterpret_cast<const PackageHeader*>(data_);
+		if (header->magic != kPackageMagic || header->version != kPackageVersion)
+		{
+			Error("Package '%s' has unsupported format", filename);
+			Unmap();
+			return false;
+		}
+		if (header->entries_count > (size_ - sizeof(PackageHeader)) / sizeof(PackageEntry))
+		{
+			Error("Package '%s' is truncated", filename);
+			Unmap();
+			return false;
+		}
+		entries_ = reinterpret_cast<const PackageEntry*>(data_ + sizeof(PackageHeader));
+		entries_count_ = header->entries_count;
+		block_size_ = header->block_size;
+		for (uint32_t i = 0; i < entries_count_; ++i)
+		{
+			const PackageEntry& entry = entries_[i];
+			const bool compressed = (entry.flags & kPackageEntryCompressed) != 0;
+			if (entry.offset > size_ || entry.stored_size > size_ - entry.offset ||
+				(!compressed && entry.stored_size != entry.size) ||
+				(compressed && !ValidateBlocks(entry)) ||
+				(i > 0 && entries_[i - 1].string_id >= entry.string_id))
+			{
+				Error("Package '%s' has corrupted table of contents", filename);
+				Unmap();
+				return false;
+			}
+		}
+		return true;
+	}
+	void Package::Close()
+	{
+		if (data_ != nullptr)
+			Unmap();
+	}
+	bool Package::IsOpen() const
+	{
+		return data_ != nullptr;
+	}
+	PackageSpan Package::Find(StringID string_id) const
+	{
+		const PackageEntry* entry = FindEntry(string_id);
+		if (entry != nullptr && (entry->flags & kPackageEntryCompressed) == 0)
+			return PackageSpan{data_ + entry->offset, static_cast<size_t>(entry->size)};
+		return PackageSpan{nullptr, 0};
+	}
+	const PackageEntry* Package::FindEntry(StringID string_id) const
+	{
+		const PackageEntry* end = entries_ + entries_count_;
+		const PackageEntry* entry = std::lower_bound(entries_, end, string_id,
+			[](const PackageEntry& item, StringID value) { return item.string_id < value; });
+		if (entry != end && entry->string_id == string_id)
+			return entry;
+		return nullptr;
+	}
+	bool Package::Read(const PackageEntry& entry, uint64_t offset, void* destination, size_t size, ThreadPool* pool) const
+	{
+		if (offset > entry.size || size > entry.size - offset)
+		{
+			Error("Read of package blob %u is out of range", entry.string_id);
+			return false;
+		}
+		if (size == 0)
+			return true;
+		uint8_t* output = static_cast<uint8_t*>(destination);
+		if ((entry.flags & kPackageEntryCompressed) == 0)
+		{
+			memcpy(output, data_ + entry.offset + offset, size);
+			return true;
+		}
+
+		const uint64_t end = offset + size;
+		const uint64_t first_block = offset / block_size_;
+		const uint64_t blocks_count = (end - 1) / block_size_ + 1 - first_block;
+		const uint32_t helpers_count = (pool != nullptr)
+			? static_cast<uint32_t>(std::min<uint64_t>(pool->GetThreadsCount(), blocks_count - 1)) : 0;
+		if (helpers_count == 0)
+		{
+			for (uint64_t i = 0; i < blocks_count; ++i)
+				if (!ReadBlock(entry, first_block + i, offset, end, output))
+					return false;
+			return true;
+		}
+
+		// Blocks are taken one by one by helpers and the calling thread.
+		// Helper started after the read has finished finds no blocks and touches shared state only.
+		std::shared_ptr<ParallelRead> state = std::make_shared<ParallelRead>();
+		state->next_block.store(0, std::memory_order_relaxed);
+		state->done_count.store(0, std::memory_order_relaxed);
+		state->failed.store(false, std::memory_order_relaxed);
+		auto process = [this, &entry, state, first_block, blocks_count, offset, end, output]()
+		{
+			for (;;)
+			{
+				const uint64_t i = state->next_block.fetch_add(1, std::memory_order_relaxed);
+				if (i >= blocks_count)
+					return;
+				if (!ReadBlock(entry, first_block + i, offset, end, output))
+					state->failed.store(true, std::memory_order_relaxed);
+				if (state->done_count.fetch_add(1, std::memory_order_acq_rel) + 1 == blocks_count)
+				{
+					std::lock_guard<std::mutex> lock(state->mutex);
+					state->condition.notify_all();
+				}
+			}
+		};
+		for (uint32_t i = 0; i < helpers_count; ++i)
+			pool->Submit(process);
+		process();
+		std::unique_lock<std::mutex> lock(state->mutex);
+		state->condition.wait(lock, [&state, blocks_count]{
+			return state->done_count.load(std::memory_order_acquire) == blocks_count; });
+		return !state->failed.load(std::memory_order_relaxed);
+	}
+	uint32_t Package::GetEntriesCount() const
+	{
+		return entries_count_;
+	}
+	const PackageEntry& Package::GetEntry(uint32_t index) const
+	{
+		return entries_[index];
+	}
+	void Package::Unmap()
+	{
+#ifdef SCYTHE_TARGET_WINDOWS
+		::UnmapViewOfFile(data_);
+		::CloseHandle(static_cast<HANDLE>(mapping_));
+#else
+		::munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+		data_ = nullptr;
+		size_ = 0;
+		entries_ = nullptr;
+		entries_count_ = 0;
+		block_size_ = 0;
+		mapping_ = nullptr;
+	}
+	bool Package::ValidateBlocks(const PackageEntry& entry) const
+	{
+		if (block_size_ == 0)
+			return false;
+		const uint64_t blocks_count = (entry.size + block_size_ - 1) / block_size_;
+		if (entry.offset % sizeof(uint32_t) != 0 || blocks_count > entry.stored_size / sizeof(uint32_t))
+			return false;
+		const uint32_t* block_ends = reinterpret_cast<const uint32_t*>(data_ + entry.offset);
+		const uint64_t blocks_size = entry.stored_size - blocks_count * sizeof(uint32_t);
+		uint64_t begin = 0;
+		for (uint64_t i = 0; i < blocks_count; ++i)
+		{
+			if (block_ends[i] <= begin || block_ends[i] > blocks_size)
+				return false;
+			begin = block_ends[i];
+		}
+		return begin == blocks_size;
+	}
+	bool Package::ReadBlock(const PackageEntry& entry, uint64_t block, uint64_t offset, uint64_t end, uint8_t* destination) const
+	{
+		const uint64_t blocks_count = (entry.size + block_size_ - 1) / block_size_;
+		const uint32_t* block_ends = reinterpret_cast<const uint32_t*>(data_ + entry.offset);
+		const uint8_t* blocks = data_ + entry.offset + blocks_count * sizeof(uint32_t);
+		const uint32_t stored_begin = (block > 0) ? block_ends[block - 1] : 0;
+		const size_t stored_size = block_ends[block] - stored_begin;
+		const uint64_t block_begin = block * block_size_;
+		const size_t block_size = static_cast<size_t>(std::min<uint64_t>(block_size_, entry.size - block_begin));
+
+		// Part of the block that gets into the destination
+		const uint64_t copy_begin = std::max(offset, block_begin);
+		const uint64_t copy_end = std::min(end, block_begin + block_size);
+		uint8_t* output = destination + (copy_begin - offset);
+		if (stored_size == block_size)
+		{
+			memcpy(output, blocks + stored_begin + (copy_begin - block_begin), static_cast<size_t>(copy_end - copy_begin));
+			return true;
+		}
+		if (copy_begin == block_begin && copy_end == block_begin + block_size)
+		{
+			if (Lz4Decompress(blocks + stored_begin, stored_size, output, block_size))
+				return true;
+		}
+		else
+		{
+			// Partial block is decompressed aside
+			std::unique_ptr<uint8_t[]> buffer(new uint8_t[block_size]);
+			if (Lz4Decompress(blocks + stored_begin, stored_size, buffer.get(), block_size))
+			{
+				memcpy(output, buffer.get() + (copy_begin - block_begin), static_cast<size_t>(copy_end - copy_begin));
+				return true;
+			}
+		}
+		Error("Block %llu of package blob %u is corrupted", static_cast<unsigned long long>(block), entry.string_id);
+		return false;
+	}
+
+} // namespace scythe
\ No newline at end of file
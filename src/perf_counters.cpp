@@ -0,0 +1,172 @@
+#include <scythe/perf_counters.h>
+
+#include <scythe/platform.h>
+
+#include <cstring>
+
+#if defined(SCYTHE_TARGET_UNIX) && defined(__linux__)
+# define SCYTHE_HAS_PERF_EVENT
+# include <linux/perf_event.h>
+# include <sys/syscall.h>
+# include <sys/ioctl.h>
+# include <unistd.h>
+#endif
+
+#ifdef SCYTHE_HAS_PERF_EVENT
+
+/**
+ * @brief      Describes counter event.
+ */
+struct PerfEventInfo
+{
+	uint32_t type;
+	uint64_t config;
+};
+
+static const PerfEventInfo kPerfEvents[] = {
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+	{PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+	{PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+	{PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+};
+static_assert(_countof(kPerfEvents) == static_cast<size_t>(scythe::PerfCounter::kCount), "Perf events mismatch");
+
+/**
+ * @brief      Opens the performance event for the calling thread.
+ *
+ * @param[in]  info      The event information
+ * @param[in]  group_fd  The group leader file descriptor or -1
+ *
+ * @return     The file descriptor or -1 on failure.
+ */
+static int OpenPerfEvent(const PerfEventInfo& info, int group_fd)
+{
+	struct perf_event_attr attr;
+	std::memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = info.type;
+	attr.config = info.config;
+	attr.disabled = (group_fd == -1) ? 1 : 0; // whole group is enabled via leader
+	attr.exclude_kernel = 1; // allowed with default perf_event_paranoid
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+#endif // SCYTHE_HAS_PERF_EVENT
+
+namespace scythe {
+
+	static const char* kCounterNames[] = {
+		"instructions",
+		"cycles",
+		"cache_misses",
+		"branch_misses",
+		"task_clock",
+		"page_faults",
+		"context_switches",
+	};
+	static_assert(_countof(kCounterNames) == static_cast<size_t>(PerfCounter::kCount), "Counter names mismatch");
+
+	PerfCounters::PerfCounters()
+	: group_fd_(-1)
+	, num_opened_(0)
+	{
+		for (int i = 0; i < kNumCounters; ++i)
+		{
+			fds_[i] = -1;
+			indices_[i] = -1;
+		}
+	}
+	PerfCounters::~PerfCounters()
+	{
+		Close();
+	}
+	bool PerfCounters::Open()
+	{
+		Close();
+#ifdef SCYTHE_HAS_PERF_EVENT
+		// Hardware counters go first, so one of them becomes group leader if permitted
+		for (int i = 0; i < kNumCounters; ++i)
+		{
+			int fd = ::OpenPerfEvent(kPerfEvents[i], group_fd_);
+			if (fd == -1)
+				continue;
+			if (group_fd_ == -1)
+				group_fd_ = fd;
+			fds_[i] = fd;
+			indices_[i] = num_opened_++;
+		}
+		if (group_fd_ == -1)
+			return false;
+		ioctl(group_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(group_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		return true;
+#else
+		return false;
+#endif
+	}
+	void PerfCounters::Close()
+	{
+#ifdef SCYTHE_HAS_PERF_EVENT
+		for (int i = 0; i < kNumCounters; ++i)
+		{
+			if (fds_[i] != -1)
+				close(fds_[i]);
+			fds_[i] = -1;
+			indices_[i] = -1;
+		}
+#endif
+		group_fd_ = -1;
+		num_opened_ = 0;
+	}
+	bool PerfCounters::IsAvailable(PerfCounter counter) const
+	{
+		return fds_[static_cast<int>(counter)] != -1;
+	}
+	bool PerfCounters::IsOpened() const
+	{
+		return group_fd_ != -1;
+	}
+	void PerfCounters::Read(PerfCounterValues* values) const
+	{
+		std::memset(values, 0, sizeof(PerfCounterValues));
+#ifdef SCYTHE_HAS_PERF_EVENT
+		if (group_fd_ == -1)
+			return;
+
+		// Group read format: number of counters, time enabled, time running, values
+		uint64_t data[3 + kNumCounters];
+		ssize_t size = read(group_fd_, data, sizeof(data));
+		if (size < static_cast<ssize_t>(3 * sizeof(uint64_t)))
+			return;
+		const uint64_t count = data[0];
+		const uint64_t time_enabled = data[1];
+		const uint64_t time_running = data[2];
+		for (int i = 0; i < kNumCounters; ++i)
+		{
+			const int index = indices_[i];
+			if (index < 0 || static_cast<uint64_t>(index) >= count)
+				continue;
+			uint64_t value = data[3 + index];
+			// Scale if counters have been multiplexed
+			if (time_running != 0 && time_running < time_enabled)
+				value = static_cast<uint64_t>(static_cast<double>(value) * static_cast<double>(time_enabled) / static_cast<double>(time_running));
+			values->values[i] = value;
+		}
+#endif
+	}
+	const char* PerfCounters::GetName(PerfCounter counter)
+	{
+		return kCounterNames[static_cast<int>(counter)];
+	}
+	void PerfCounters::Subtract(const PerfCounterValues& end, const PerfCounterValues& start, PerfCounterValues* result)
+	{
+		for (int i = 0; i < kNumCounters; ++i)
+			result->values[i] = (end.values[i] > start.values[i]) ? end.values[i] - start.values[i] : 0;
+	}
+
+} // namespace scythe
\ No newline at end of file
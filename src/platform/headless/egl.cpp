@@ -0,0 +1,338 @@
+#include "egl.h"
+
+#include <cstring>
+#include <cassert>
+#include <dlfcn.h>
+
+#include <scythe/application.h>
+#include <scythe/log.h>
+#include "platform_data.h"
+#include "../platform_inner.h"
+
+/**
+ * @brief      Determines if string in extension string.
+ *
+ * @param[in]  string      The string
+ * @param[in]  extensions  The extensions
+ *
+ * @return     True if string in extension string, False otherwise.
+ */
+static bool IsStringInExtensionString(const char* string, const char* extensions)
+{
+	const char* start = extensions;
+
+	for (;;)
+	{
+		const char* where;
+		const char* terminator;
+
+		where = std::strstr(start, string);
+		if (!where)
+			return false;
+
+		terminator = where + std::strlen(string);
+		if (where == start || *(where - 1) == ' ')
+		{
+			if (*terminator == ' ' || *terminator == '\0')
+				break;
+		}
+
+		start = terminator;
+	}
+
+	return true;
+}
+
+/**
+ * @brief      Gets the EGL error string.
+ *
+ * @param[in]  error  The error code
+ *
+ * @return     The error string.
+ */
+static const char* GetErrorString(EGLint error)
+{
+	switch (error)
+	{
+	case EGL_SUCCESS:			return "Success";
+	case EGL_NOT_INITIALIZED:	return "EGL is not or could not be initialized";
+	case EGL_BAD_ACCESS:		return "EGL cannot access a requested resource";
+	case EGL_BAD_ALLOC:			return "EGL failed to allocate resources";
+	case EGL_BAD_ATTRIBUTE:		return "An unrecognized attribute or attribute value was passed";
+	case EGL_BAD_CONFIG:		return "An EGLConfig argument does not name a valid EGL frame buffer configuration";
+	case EGL_BAD_CONTEXT:		return "An EGLContext argument does not name a valid EGL rendering context";
+	case EGL_BAD_MATCH:			return "Arguments are inconsistent";
+	default:					return "Unknown EGL error";
+	}
+}
+
+static inline scythe::platform::Window* GetMainWindow()
+{
+	scythe::Application* app = scythe::Application::GetInstance();
+	scythe::platform::Data* data = scythe::platform::GetData(app);
+	return data->main_window;
+}
+
+namespace scythe {
+
+	bool LibraryEGL::Initialize()
+	{
+		if (library_handle_)
+			return true;
+
+		library_handle_ = ::dlopen("libEGL.so.1", RTLD_LAZY | RTLD_LOCAL);
+		if (!library_handle_)
+			library_handle_ = ::dlopen("libEGL.so", RTLD_LAZY | RTLD_LOCAL);
+		if (!library_handle_)
+		{
+			Error("EGL: Failed to load libEGL.so");
+			return false;
+		}
+
+		eglGetError             = (PFN_eglGetError)             ::dlsym(library_handle_, "eglGetError");
+		eglGetDisplay           = (PFN_eglGetDisplay)           ::dlsym(library_handle_, "eglGetDisplay");
+		eglInitialize           = (PFN_eglInitialize)           ::dlsym(library_handle_, "eglInitialize");
+		eglTerminate            = (PFN_eglTerminate)            ::dlsym(library_handle_, "eglTerminate");
+		eglBindAPI              = (PFN_eglBindAPI)              ::dlsym(library_handle_, "eglBindAPI");
+		eglQueryString          = (PFN_eglQueryString)          ::dlsym(library_handle_, "eglQueryString");
+		eglChooseConfig         = (PFN_eglChooseConfig)         ::dlsym(library_handle_, "eglChooseConfig");
+		eglCreateContext        = (PFN_eglCreateContext)        ::dlsym(library_handle_, "eglCreateContext");
+		eglDestroyContext       = (PFN_eglDestroyContext)       ::dlsym(library_handle_, "eglDestroyContext");
+		eglCreatePbufferSurface = (PFN_eglCreatePbufferSurface) ::dlsym(library_handle_, "eglCreatePbufferSurface");
+		eglDestroySurface       = (PFN_eglDestroySurface)       ::dlsym(library_handle_, "eglDestroySurface");
+		eglMakeCurrent          = (PFN_eglMakeCurrent)          ::dlsym(library_handle_, "eglMakeCurrent");
+		eglGetProcAddress       = (PFN_eglGetProcAddress)       ::dlsym(library_handle_, "eglGetProcAddress");
+
+		if (!eglGetError || !eglGetDisplay || !eglInitialize || !eglTerminate ||
+			!eglBindAPI || !eglQueryString || !eglChooseConfig || !eglCreateContext ||
+			!eglDestroyContext || !eglCreatePbufferSurface || !eglDestroySurface ||
+			!eglMakeCurrent || !eglGetProcAddress)
+		{
+			Error("EGL: Failed to load required entry points");
+			Deinitialize();
+			return false;
+		}
+
+		// Client extensions are queried without display
+		const char* client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+		if (client_extensions)
+		{
+			EXT_platform_base         = ::IsStringInExtensionString("EGL_EXT_platform_base", client_extensions);
+			EXT_platform_device       = ::IsStringInExtensionString("EGL_EXT_platform_device", client_extensions);
+			MESA_platform_surfaceless = ::IsStringInExtensionString("EGL_MESA_platform_surfaceless", client_extensions);
+		}
+		if (EXT_platform_base)
+		{
+			eglGetPlatformDisplayEXT = (PFN_eglGetPlatformDisplayEXT) eglGetProcAddress("eglGetPlatformDisplayEXT");
+			eglQueryDevicesEXT       = (PFN_eglQueryDevicesEXT)       eglGetProcAddress("eglQueryDevicesEXT");
+		}
+
+		display_ = _GetDisplay();
+		if (display_ == EGL_NO_DISPLAY)
+		{
+			Error("EGL: Failed to get display");
+			Deinitialize();
+			return false;
+		}
+
+		EGLint major, minor;
+		if (!eglInitialize(display_, &major, &minor))
+		{
+			Error("EGL: Failed to initialize display: %s", ::GetErrorString(eglGetError()));
+			display_ = EGL_NO_DISPLAY;
+			Deinitialize();
+			return false;
+		}
+
+		KHR_surfaceless_context     = IsExtensionSupported("EGL_KHR_surfaceless_context");
+		KHR_create_context_no_error = IsExtensionSupported("EGL_KHR_create_context_no_error");
+
+		return true;
+	}
+	void LibraryEGL::Deinitialize()
+	{
+		if (display_ != EGL_NO_DISPLAY)
+		{
+			eglTerminate(display_);
+			display_ = EGL_NO_DISPLAY;
+		}
+		if (library_handle_)
+		{
+			::dlclose(library_handle_);
+			library_handle_ = nullptr;
+		}
+	}
+	EGLDisplay LibraryEGL::_GetDisplay()
+	{
+		// Surfaceless platform doesn't require neither GPU nor display server (works with llvmpipe)
+		if (eglGetPlatformDisplayEXT && MESA_platform_surfaceless)
+		{
+			EGLDisplay display = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+			if (display != EGL_NO_DISPLAY)
+				return display;
+		}
+		// Then try first available device
+		if (eglGetPlatformDisplayEXT && eglQueryDevicesEXT && EXT_platform_device)
+		{
+			EGLDeviceEXT device;
+			EGLint num_devices = 0;
+			if (eglQueryDevicesEXT(1, &device, &num_devices) && num_devices > 0)
+			{
+				EGLDisplay display = eglGetPlatformDisplayEXT(EGL_PLATFORM_DEVICE_EXT, device, nullptr);
+				if (display != EGL_NO_DISPLAY)
+					return display;
+			}
+		}
+		return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+
+#define SET_ATTRIB(a, v) \
+{ \
+	assert(((size_t) index + 1) < sizeof(attribs) / sizeof(attribs[0])); \
+	attribs[index++] = a; \
+	attribs[index++] = v; \
+}
+
+	bool LibraryEGL::CreateContext(const OpenGLContextConfiguration* context_config, const OpenGLFramebufferConfiguration* fb_config)
+	{
+		platform::Window* window = ::GetMainWindow();
+
+		if (!eglBindAPI(EGL_OPENGL_API))
+		{
+			Error("EGL: Failed to bind OpenGL API: %s", ::GetErrorString(eglGetError()));
+			return false;
+		}
+
+		// Choose config. Rendering is done into framebuffer object,
+		// so config buffers are only needed for pbuffer fallback.
+		EGLConfig config;
+		EGLint num_configs = 0;
+		{
+			EGLint attribs[40];
+			int index = 0;
+
+			SET_ATTRIB(EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT);
+			SET_ATTRIB(EGL_SURFACE_TYPE, EGL_PBUFFER_BIT);
+			SET_ATTRIB(EGL_RED_SIZE, fb_config->red_bits);
+			SET_ATTRIB(EGL_GREEN_SIZE, fb_config->green_bits);
+			SET_ATTRIB(EGL_BLUE_SIZE, fb_config->blue_bits);
+			SET_ATTRIB(EGL_ALPHA_SIZE, fb_config->alpha_bits);
+			SET_ATTRIB(EGL_NONE, EGL_NONE);
+
+			if (!eglChooseConfig(display_, attribs, &config, 1, &num_configs) || num_configs == 0)
+			{
+				Error("EGL: Failed to find a suitable config");
+				return false;
+			}
+		}
+
+		// Create context
+		{
+			EGLint attribs[40];
+			int index = 0, mask = 0;
+
+			if (context_config->profile == OpenGLContextProfile::kCore)
+				mask |= EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT;
+			else if (context_config->profile == OpenGLContextProfile::kCompatibility)
+				mask |= EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT;
+
+			if (context_config->major != 1 || context_config->minor != 0)
+			{
+				SET_ATTRIB(EGL_CONTEXT_MAJOR_VERSION, context_config->major);
+				SET_ATTRIB(EGL_CONTEXT_MINOR_VERSION, context_config->minor);
+			}
+
+			if (mask)
+				SET_ATTRIB(EGL_CONTEXT_OPENGL_PROFILE_MASK, mask);
+
+			if (context_config->forward)
+				SET_ATTRIB(EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE, EGL_TRUE);
+
+			if (context_config->debug)
+				SET_ATTRIB(EGL_CONTEXT_OPENGL_DEBUG, EGL_TRUE);
+
+			if (context_config->noerror && KHR_create_context_no_error)
+				SET_ATTRIB(EGL_CONTEXT_OPENGL_NO_ERROR_KHR, EGL_TRUE);
+
+			SET_ATTRIB(EGL_NONE, EGL_NONE);
+
+			window->context.handle = eglCreateContext(display_, config, EGL_NO_CONTEXT, attribs);
+			if (window->context.handle == EGL_NO_CONTEXT)
+			{
+				Error("EGL: Failed to create OpenGL %i.%i context: %s", context_config->major, context_config->minor,
+					::GetErrorString(eglGetError()));
+				return false;
+			}
+		}
+
+		// Pbuffer is only necessary when surfaceless contexts are not supported
+		window->context.surface = EGL_NO_SURFACE;
+		if (!KHR_surfaceless_context)
+		{
+			EGLint attribs[40];
+			int index = 0;
+
+			SET_ATTRIB(EGL_WIDTH, 1);
+			SET_ATTRIB(EGL_HEIGHT, 1);
+			SET_ATTRIB(EGL_NONE, EGL_NONE);
+
+			window->context.surface = eglCreatePbufferSurface(display_, config, attribs);
+			if (window->context.surface == EGL_NO_SURFACE)
+			{
+				Error("EGL: Failed to create pbuffer surface: %s", ::GetErrorString(eglGetError()));
+				DestroyContext();
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+#undef SET_ATTRIB
+
+	void LibraryEGL::DestroyContext()
+	{
+		platform::Window* window = ::GetMainWindow();
+
+		eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+		if (window->context.surface != EGL_NO_SURFACE)
+		{
+			eglDestroySurface(display_, window->context.surface);
+			window->context.surface = EGL_NO_SURFACE;
+		}
+		if (window->context.handle != EGL_NO_CONTEXT)
+		{
+			eglDestroyContext(display_, window->context.handle);
+			window->context.handle = EGL_NO_CONTEXT;
+		}
+	}
+	bool LibraryEGL::MakeContextCurrent()
+	{
+		platform::Window* window = ::GetMainWindow();
+
+		if (!eglMakeCurrent(display_, window->context.surface, window->context.surface, window->context.handle))
+		{
+			Error("EGL: Failed to make context current: %s", ::GetErrorString(eglGetError()));
+			return false;
+		}
+		return true;
+	}
+	bool LibraryEGL::IsExtensionSupported(const char* extension)
+	{
+		const char* extensions = eglQueryString(display_, EGL_EXTENSIONS);
+		if (!extensions)
+			return false;
+
+		return ::IsStringInExtensionString(extension, extensions);
+	}
+	LibraryEGL::Procedure LibraryEGL::GetProcedureAddress(const char* name)
+	{
+		const Procedure proc = (Procedure) eglGetProcAddress(name);
+		if (proc)
+			return proc;
+
+		return (Procedure) ::dlsym(RTLD_DEFAULT, name);
+	}
+
+} // namespace scythe
\ No newline at end of file
@@ -0,0 +1,139 @@
+#ifndef __SCYTHE_EGL_H__
+#define __SCYTHE_EGL_H__
+
+#include <stdint.h>
+
+#include <scythe/singleton.h>
+
+#include "../../graphics/opengl/opengl_context_config.h"
+#include "../../graphics/opengl/opengl_framebuffer_config.h"
+
+// EGL types
+typedef void* EGLDisplay;
+typedef void* EGLConfig;
+typedef void* EGLContext;
+typedef void* EGLSurface;
+typedef void* EGLDeviceEXT;
+typedef void* EGLNativeDisplayType;
+typedef unsigned int EGLBoolean;
+typedef unsigned int EGLenum;
+typedef int32_t EGLint;
+
+// EGL specific defines
+#define EGL_FALSE 0
+#define EGL_TRUE 1
+#define EGL_DEFAULT_DISPLAY ((EGLNativeDisplayType)0)
+#define EGL_NO_DISPLAY ((EGLDisplay)0)
+#define EGL_NO_CONTEXT ((EGLContext)0)
+#define EGL_NO_SURFACE ((EGLSurface)0)
+#define EGL_SUCCESS 0x3000
+#define EGL_NOT_INITIALIZED 0x3001
+#define EGL_BAD_ACCESS 0x3002
+#define EGL_BAD_ALLOC 0x3003
+#define EGL_BAD_ATTRIBUTE 0x3004
+#define EGL_BAD_CONFIG 0x3005
+#define EGL_BAD_CONTEXT 0x3006
+#define EGL_BAD_MATCH 0x3009
+#define EGL_RED_SIZE 0x3024
+#define EGL_GREEN_SIZE 0x3023
+#define EGL_BLUE_SIZE 0x3022
+#define EGL_ALPHA_SIZE 0x3021
+#define EGL_DEPTH_SIZE 0x3025
+#define EGL_STENCIL_SIZE 0x3026
+#define EGL_SURFACE_TYPE 0x3033
+#define EGL_NONE 0x3038
+#define EGL_RENDERABLE_TYPE 0x3040
+#define EGL_HEIGHT 0x3056
+#define EGL_WIDTH 0x3057
+#define EGL_EXTENSIONS 0x3055
+#define EGL_PBUFFER_BIT 0x0001
+#define EGL_OPENGL_BIT 0x0008
+#define EGL_OPENGL_API 0x30A2
+#define EGL_CONTEXT_MAJOR_VERSION 0x3098
+#define EGL_CONTEXT_MINOR_VERSION 0x30FB
+#define EGL_CONTEXT_OPENGL_PROFILE_MASK 0x30FD
+#define EGL_CONTEXT_OPENGL_DEBUG 0x31B0
+#define EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE 0x31B1
+#define EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT 0x00000001
+#define EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT 0x00000002
+#define EGL_CONTEXT_OPENGL_NO_ERROR_KHR 0x31B3
+#define EGL_PLATFORM_DEVICE_EXT 0x313F
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+
+// EGL function pointer typedefs
+typedef EGLint (* PFN_eglGetError)(void);
+typedef EGLDisplay (* PFN_eglGetDisplay)(EGLNativeDisplayType);
+typedef EGLBoolean (* PFN_eglInitialize)(EGLDisplay,EGLint*,EGLint*);
+typedef EGLBoolean (* PFN_eglTerminate)(EGLDisplay);
+typedef EGLBoolean (* PFN_eglBindAPI)(EGLenum);
+typedef const char* (* PFN_eglQueryString)(EGLDisplay,EGLint);
+typedef EGLBoolean (* PFN_eglChooseConfig)(EGLDisplay,const EGLint*,EGLConfig*,EGLint,EGLint*);
+typedef EGLContext (* PFN_eglCreateContext)(EGLDisplay,EGLConfig,EGLContext,const EGLint*);
+typedef EGLBoolean (* PFN_eglDestroyContext)(EGLDisplay,EGLContext);
+typedef EGLSurface (* PFN_eglCreatePbufferSurface)(EGLDisplay,EGLConfig,const EGLint*);
+typedef EGLBoolean (* PFN_eglDestroySurface)(EGLDisplay,EGLSurface);
+typedef EGLBoolean (* PFN_eglMakeCurrent)(EGLDisplay,EGLSurface,EGLSurface,EGLContext);
+typedef void (* (* PFN_eglGetProcAddress)(const char*))(void);
+
+// EGL extension pointer typedefs
+typedef EGLDisplay (* PFN_eglGetPlatformDisplayEXT)(EGLenum,void*,const EGLint*);
+typedef EGLBoolean (* PFN_eglQueryDevicesEXT)(EGLint,EGLDeviceEXT*,EGLint*);
+
+namespace scythe {
+
+	/**
+	 * @brief      This class describes a library EGL.
+	 * @details    Creates offscreen OpenGL context without any window. Surfaceless
+	 *             context is used when available and 1x1 pbuffer otherwise.
+	 */
+	class LibraryEGL final
+	: public Singleton<LibraryEGL>
+	{
+	public:
+		bool Initialize();
+		void Deinitialize();
+
+		bool CreateContext(const OpenGLContextConfiguration* context_config, const OpenGLFramebufferConfiguration* fb_config);
+		void DestroyContext();
+		bool MakeContextCurrent();
+
+		bool IsExtensionSupported(const char* extension);
+
+		typedef void (*Procedure)(void);
+		Procedure GetProcedureAddress(const char* name);
+
+	private:
+		EGLDisplay _GetDisplay();
+
+	public:
+		PFN_eglGetError                     eglGetError;
+		PFN_eglGetDisplay                   eglGetDisplay;
+		PFN_eglInitialize                   eglInitialize;
+		PFN_eglTerminate                    eglTerminate;
+		PFN_eglBindAPI                      eglBindAPI;
+		PFN_eglQueryString                  eglQueryString;
+		PFN_eglChooseConfig                 eglChooseConfig;
+		PFN_eglCreateContext                eglCreateContext;
+		PFN_eglDestroyContext               eglDestroyContext;
+		PFN_eglCreatePbufferSurface         eglCreatePbufferSurface;
+		PFN_eglDestroySurface               eglDestroySurface;
+		PFN_eglMakeCurrent                  eglMakeCurrent;
+		PFN_eglGetProcAddress               eglGetProcAddress;
+
+		PFN_eglGetPlatformDisplayEXT        eglGetPlatformDisplayEXT;
+		PFN_eglQueryDevicesEXT              eglQueryDevicesEXT;
+
+		bool                                EXT_platform_base;
+		bool                                EXT_platform_device;
+		bool                                MESA_platform_surfaceless;
+		bool                                KHR_surfaceless_context;
+		bool                                KHR_create_context_no_error;
+
+	private:
+		void*                               library_handle_;
+		EGLDisplay                          display_;
+	};
+
+} // namespace scythe
+
+#endif
\ No newline at end of file
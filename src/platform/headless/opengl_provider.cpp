@@ -0,0 +1,236 @@
+#include <scythe/opengl/opengl_provider.h>
+
+#include <scythe/defines.h>
+#include <scythe/opengl/opengl_include.h>
+#include <scythe/opengl/opengl_profiler.h>
+#include <scythe/desktop_application.h>
+#include <scythe/log.h>
+#include "platform_data.h"
+#include "../platform_inner.h"
+#include "egl.h"
+
+/**
+ * @brief      Gets the platform window.
+ *
+ * @param[in]  app   The application
+ *
+ * @return     The platform window.
+ */
+static inline scythe::platform::Window* GetMainWindow(scythe::Application* app)
+{
+	scythe::platform::Data* data = scythe::platform::GetData(app);
+	return data->main_window;
+}
+
+/**
+ * @brief      Gets the proc address.
+ *
+ * @param[in]  name  The name
+ *
+ * @return     The proc address.
+ */
+static GLADapiproc GetProcedureAddress(const char* name)
+{
+	scythe::LibraryEGL* egl = scythe::LibraryEGL::GetInstance();
+	return egl->GetProcedureAddress(name);
+}
+
+/**
+ * @brief      Destroys the framebuffer object used instead of default framebuffer.
+ *
+ * @param      context  The context
+ */
+static void DestroyFramebuffer(scythe::platform::RenderingContext* context)
+{
+	if (context->depth_buffer)
+	{
+		glDeleteRenderbuffers(1, &context->depth_buffer);
+		context->depth_buffer = 0;
+	}
+	if (context->color_buffer)
+	{
+		glDeleteRenderbuffers(1, &context->color_buffer);
+		context->color_buffer = 0;
+	}
+	if (context->framebuffer)
+	{
+		glDeleteFramebuffers(1, &context->framebuffer);
+		context->framebuffer = 0;
+	}
+	context->framebuffer_width = 0;
+	context->framebuffer_height = 0;
+}
+
+/**
+ * @brief      Creates the framebuffer object used instead of default framebuffer.
+ *
+ * @param      context         The context
+ * @param[in]  width           The width
+ * @param[in]  height          The height
+ * @param[in]  color_format    The color buffer internal format
+ * @param[in]  depth_format    The depth buffer internal format (0 means no depth buffer)
+ * @param[in]  samples         The MSAA samples count (0 means no multisampling)
+ *
+ * @return     True on success, false otherwise.
+ */
+static bool CreateFramebuffer(scythe::platform::RenderingContext* context, int width, int height,
+	GLenum color_format, GLenum depth_format, GLsizei samples)
+{
+	// Zero sized renderbuffers are incomplete
+	if (width < 1) width = 1;
+	if (height < 1) height = 1;
+
+	glGenFramebuffers(1, &context->framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, context->framebuffer);
+
+	glGenRenderbuffers(1, &context->color_buffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, context->color_buffer);
+	glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, color_format, width, height);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, context->color_buffer);
+
+	if (depth_format != 0)
+	{
+		GLenum attachment = (depth_format == GL_DEPTH24_STENCIL8) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+		glGenRenderbuffers(1, &context->depth_buffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, context->depth_buffer);
+		glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, depth_format, width, height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, context->depth_buffer);
+	}
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	context->framebuffer_width = width;
+	context->framebuffer_height = height;
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		scythe::Error("Headless framebuffer is incomplete");
+		::DestroyFramebuffer(context);
+		return false;
+	}
+	return true;
+}
+
+namespace scythe {
+
+	bool OpenGLGraphicsProvider::Initialize()
+	{
+		LibraryEGL* egl = LibraryEGL::GetInstance();
+		// Initialize EGL
+		if (!egl->Initialize())
+			return false;
+
+		// Context configuration
+		OpenGLContextConfiguration context_config;
+		context_config.major = context_major_version_;
+		context_config.minor = context_minor_version_;
+		context_config.profile = OpenGLContextProfile::kCore;
+		context_config.forward = true;
+		context_config.noerror = false;
+		context_config.debug = false;
+
+		// Framebuffer configuration
+		OpenGLFramebufferConfiguration fb_config;
+		fb_config.red_bits = red_bits_;
+		fb_config.green_bits = green_bits_;
+		fb_config.blue_bits = blue_bits_;
+		fb_config.alpha_bits = alpha_bits_;
+		fb_config.depth_bits = depth_bits_;
+		fb_config.stencil_bits = stencil_bits_;
+		fb_config.accum_red_bits = 0;
+		fb_config.accum_green_bits = 0;
+		fb_config.accum_blue_bits = 0;
+		fb_config.accum_alpha_bits = 0;
+		fb_config.aux_buffers = 0;
+		fb_config.samples = 0;
+		fb_config.stereo = false;
+		fb_config.sRGB = false;
+		fb_config.doublebuffer = false;
+		fb_config.transparent = false;
+
+		// Create OpenGL context
+		if (!egl->CreateContext(&context_config, &fb_config))
+		{
+			egl->Deinitialize();
+			return false;
+		}
+
+		MakeContextCurrent();
+
+		// Load GLAD
+		if (!gladLoadGL(::GetProcedureAddress))
+		{
+			Error("GLAD loading failed");
+			return false;
+		}
+
+		// Create framebuffer object instead of default one
+		platform::Window* window = ::GetMainWindow(application_);
+		platform::RenderingContext* context = &window->context;
+		context->framebuffer = 0;
+		context->color_buffer = 0;
+		context->depth_buffer = 0;
+		GLenum color_format = (alpha_bits_ != 0) ? GL_RGBA8 : GL_RGB8;
+		GLenum depth_format = (stencil_bits_ != 0) ? GL_DEPTH24_STENCIL8 : ((depth_bits_ != 0) ? GL_DEPTH_COMPONENT24 : 0);
+		GLsizei samples = is_multisample_ ? msaa_samples_ : 0;
+		if (!::CreateFramebuffer(context, window->base.width, window->base.height, color_format, depth_format, samples))
+			return false;
+
+#ifdef SCYTHE_USE_PROFILER
+		// GPU profiling is optional, so don't fail on it
+		OpenGLProfiler::GetInstance()->Initialize();
+#endif
+
+		// Finally
+		initialized_ = true;
+
+		return true;
+	}
+	void OpenGLGraphicsProvider::Deinitialize()
+	{
+		LibraryEGL* egl = LibraryEGL::GetInstance();
+		platform::Window* window = ::GetMainWindow(application_);
+		if (initialized_)
+			::DestroyFramebuffer(&window->context);
+#ifdef SCYTHE_USE_PROFILER
+		OpenGLProfiler::GetInstance()->Deinitialize();
+#endif
+		egl->DestroyContext();
+		egl->Deinitialize();
+	}
+	void OpenGLGraphicsProvider::BeginFrame()
+	{
+		platform::Window* window = ::GetMainWindow(application_);
+		platform::RenderingContext* context = &window->context;
+
+		// Recreate framebuffer when window has been resized
+		if (context->framebuffer_width != window->base.width ||
+			context->framebuffer_height != window->base.height)
+		{
+			GLenum color_format = (alpha_bits_ != 0) ? GL_RGBA8 : GL_RGB8;
+			GLenum depth_format = (stencil_bits_ != 0) ? GL_DEPTH24_STENCIL8 : ((depth_bits_ != 0) ? GL_DEPTH_COMPONENT24 : 0);
+			GLsizei samples = is_multisample_ ? msaa_samples_ : 0;
+			::DestroyFramebuffer(context);
+			::CreateFramebuffer(context, window->base.width, window->base.height, color_format, depth_format, samples);
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, context->framebuffer);
+	}
+	void OpenGLGraphicsProvider::EndFrame()
+	{
+#ifdef SCYTHE_USE_PROFILER
+		OpenGLProfiler::GetInstance()->EndFrame();
+#endif
+		// There is nothing to swap, just submit commands
+		glFlush();
+	}
+	void OpenGLGraphicsProvider::SetSwapInterval(int interval)
+	{
+		// There is no presentation, so frames aren't synchronized
+		SCYTHE_UNUSED(interval);
+	}
+	void OpenGLGraphicsProvider::MakeContextCurrent()
+	{
+		LibraryEGL* egl = LibraryEGL::GetInstance();
+		egl->MakeContextCurrent();
+	}
+
+} // namespace scythe
\ No newline at end of file
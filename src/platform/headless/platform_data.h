@@ -0,0 +1,98 @@
+#ifndef __SCYTHE_PLATFORM_DATA_H__
+#define __SCYTHE_PLATFORM_DATA_H__
+
+#include "../base_window.h"
+
+#include <scythe/keyboard.h>
+#include <scythe/mouse.h>
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+namespace scythe::platform {
+
+	/**
+	 * @brief      Synthetic event type for headless platform
+	 */
+	enum class EventType
+	{
+		kKeyDown,
+		kKeyUp,
+		kChar,
+		kMouseDown,
+		kMouseUp,
+		kMouseMove,
+		kScroll,
+		kResize,
+		kFocus,
+		kClose,
+	};
+
+	/**
+	 * @brief      Synthetic event for headless platform
+	 */
+	struct Event
+	{
+		EventType type;
+		KeyboardKey key;			//!< key for keyboard events
+		KeyModifiers modifiers;		//!< modifiers for keyboard events
+		KeyCode code;				//!< character code
+		MouseButton button;			//!< button for mouse events
+		float x;					//!< position or scroll delta in X direction
+		float y;					//!< position or scroll delta in Y direction
+		int width;					//!< new window width
+		int height;					//!< new window height
+		bool active;				//!< focus state
+	};
+
+#ifdef SCYTHE_USE_OPENGL
+	/**
+	 * @brief      Offscreen OpenGL rendering context.
+	 * @details    There is no default framebuffer, so rendering is done into
+	 *             framebuffer object of window size.
+	 */
+	struct RenderingContext
+	{
+		void* handle;					//!< EGLContext
+		void* surface;					//!< EGLSurface (1x1 pbuffer if surfaceless is not supported)
+		unsigned int framebuffer;		//!< framebuffer object
+		unsigned int color_buffer;		//!< color renderbuffer
+		unsigned int depth_buffer;		//!< depth-stencil renderbuffer
+		int framebuffer_width;
+		int framebuffer_height;
+	};
+#endif
+
+	/**
+	 * @brief      Window implementation for headless platform
+	 */
+	struct Window
+	{
+		// Base window struct to avoid inheritance
+		BaseWindow base;
+
+		std::wstring title;
+		float cursor_x;
+		float cursor_y;
+		bool cursor_visible;
+#ifdef SCYTHE_USE_OPENGL
+		RenderingContext context;
+#endif
+	};
+
+	/**
+	 * @brief      Describes data specific for headless platform.
+	 */
+	struct Data
+	{
+		Window* main_window;
+		std::string clipboard;
+		std::mutex events_mutex;
+		std::vector<Event> pending_events;		//!< events pushed by user (guarded by mutex)
+		std::vector<Event> processed_events;	//!< events being processed (main thread only)
+	};
+
+} // namespace scythe::platform
+
+#endif
\ No newline at end of file
@@ -0,0 +1,435 @@
+#include "../platform_inner.h"
+
+#include <scythe/desktop_application.h>
+#include <scythe/headless.h>
+
+#include "platform_data.h"
+
+static inline scythe::platform::Window* GetMainWindow()
+{
+	scythe::Application* app = scythe::Application::GetInstance();
+	scythe::platform::Data* data = scythe::platform::GetData(app);
+	return data->main_window;
+}
+static void ConfigureWindowSettings(scythe::platform::Window* window, scythe::DesktopApplication* app)
+{
+	int width = app->GetInitialWidth();
+	int height = app->GetInitialHeight();
+
+	// Base properties
+	window->base.width = width;
+	window->base.height = height;
+	window->base.aspect_ratio = static_cast<float>(width) / static_cast<float>(height);
+	window->base.active = true;
+	window->base.visible = false;
+	window->base.fullscreen = false;
+
+	window->title = app->GetInitialTitle();
+	window->cursor_x = 0.0f;
+	window->cursor_y = 0.0f;
+	window->cursor_visible = true;
+}
+static void ResizeWindow(scythe::platform::Window* window, int width, int height)
+{
+	scythe::DesktopApplication* app = scythe::DesktopApplication::GetInstance();
+	scythe::WindowController* window_controller = app->GetWindowController();
+
+	window->base.width = width;
+	window->base.height = height;
+	window->base.aspect_ratio = static_cast<float>(width) / static_cast<float>(height);
+	if (window_controller)
+		window_controller->OnResize(width, height);
+}
+static void PushEvent(const scythe::platform::Event& event)
+{
+	scythe::Application* app = scythe::Application::GetInstance();
+	if (app == nullptr)
+		return;
+	scythe::platform::Data* data = scythe::platform::GetData(app);
+	if (data == nullptr)
+		return;
+	std::lock_guard<std::mutex> lock(data->events_mutex);
+	data->pending_events.push_back(event);
+}
+static scythe::platform::Event MakeEvent(scythe::platform::EventType type)
+{
+	scythe::platform::Event event;
+	event.type = type;
+	event.key = scythe::KeyboardKey::kUnknown;
+	event.code = 0;
+	event.button = scythe::MouseButton::kUnknown;
+	event.x = 0.0f;
+	event.y = 0.0f;
+	event.width = 0;
+	event.height = 0;
+	event.active = false;
+	return event;
+}
+static void DispatchEvent(const scythe::platform::Event& event)
+{
+	scythe::DesktopApplication* desktop_app = scythe::DesktopApplication::GetInstance();
+	scythe::platform::Window* window = ::GetMainWindow();
+	scythe::KeyboardState& keyboard_state = desktop_app->GetKeyboardState();
+	scythe::MouseState& mouse_state = desktop_app->GetMouseState();
+	scythe::KeyboardController* keyboard_controller = desktop_app->GetKeyboardController();
+	scythe::MouseController* mouse_controller = desktop_app->GetMouseController();
+	scythe::WindowController* window_controller = desktop_app->GetWindowController();
+
+	switch (event.type)
+	{
+	case scythe::platform::EventType::kKeyDown:
+		keyboard_state.SetKeyDown(event.key, true);
+		keyboard_state.modifiers = event.modifiers;
+		if (keyboard_controller)
+			keyboard_controller->OnKeyDown(event.key, event.modifiers);
+		break;
+
+	case scythe::platform::EventType::kKeyUp:
+		keyboard_state.SetKeyDown(event.key, false);
+		keyboard_state.modifiers = event.modifiers;
+		if (keyboard_controller)
+			keyboard_controller->OnKeyUp(event.key, event.modifiers);
+		break;
+
+	case scythe::platform::EventType::kChar:
+		if (keyboard_controller && scythe::IsGoodChar(event.code))
+			keyboard_controller->OnChar(event.code);
+		break;
+
+	case scythe::platform::EventType::kMouseDown:
+		mouse_state.SetButtonDown(event.button, true);
+		if (mouse_controller)
+			mouse_controller->OnMouseDown(event.button);
+		break;
+
+	case scythe::platform::EventType::kMouseUp:
+		mouse_state.SetButtonDown(event.button, false);
+		if (mouse_controller)
+			mouse_controller->OnMouseUp(event.button);
+		break;
+
+	case scythe::platform::EventType::kMouseMove:
+		mouse_state.delta_x = event.x - window->cursor_x;
+		mouse_state.delta_y = event.y - window->cursor_y;
+		mouse_state.x = event.x;
+		mouse_state.y = event.y;
+		window->cursor_x = event.x;
+		window->cursor_y = event.y;
+		if (mouse_controller)
+			mouse_controller->OnMouseMove();
+		break;
+
+	case scythe::platform::EventType::kScroll:
+		if (mouse_controller)
+			mouse_controller->OnScroll(event.x, event.y);
+		break;
+
+	case scythe::platform::EventType::kResize:
+		::ResizeWindow(window, event.width, event.height);
+		break;
+
+	case scythe::platform::EventType::kFocus:
+		window->base.active = event.active;
+		if (window_controller)
+		{
+			if (event.active)
+				window_controller->OnGetFocus();
+			else
+				window_controller->OnLostFocus();
+		}
+		break;
+
+	case scythe::platform::EventType::kClose:
+		desktop_app->Terminate();
+		break;
+	}
+}
+
+namespace scythe {
+
+	const BaseWindow* GetBaseWindow(const Application* app)
+	{
+		const platform::Window* window = platform::GetWindow(app);
+		return &window->base;
+	}
+
+	namespace platform {
+
+		Data* CreateData()
+		{
+			Data* data = new Data();
+			data->main_window = nullptr;
+			return data;
+		}
+		void DestroyData(Data* data)
+		{
+			delete data;
+		}
+		Data* GetData(Application* app)
+		{
+			return reinterpret_cast<Data*>(app->platform_data_);
+		}
+		const Data* GetData(const Application* app)
+		{
+			return reinterpret_cast<const Data*>(app->platform_data_);
+		}
+		const Window* GetWindow(const Application* app)
+		{
+			const Data* data = GetData(app);
+			return data->main_window;
+		}
+
+		bool Initialize()
+		{
+			return true;
+		}
+		void Deinitialize()
+		{
+		}
+
+		void PollEvents()
+		{
+			Application* app = Application::GetInstance();
+			Data* data = GetData(app);
+
+			// Take all pending events at once to keep the lock short
+			{
+				std::lock_guard<std::mutex> lock(data->events_mutex);
+				data->processed_events.swap(data->pending_events);
+			}
+			for (const Event& event : data->processed_events)
+				::DispatchEvent(event);
+			data->processed_events.clear();
+		}
+		void ChangeDirectoryToResources()
+		{
+			// Headless applications are run from any directory, so keep the current one
+		}
+
+		// Window functions
+		namespace window {
+
+			bool Create()
+			{
+				DesktopApplication* app = DesktopApplication::GetInstance();
+				Data* data = GetData(app);
+
+				// Create window instance
+				Window* window = new Window();
+				data->main_window = window;
+
+				// Configure window size
+				::ConfigureWindowSettings(window, app);
+
+				if (app->IsInitialFullscreen())
+					MakeFullscreen();
+
+				return true;
+			}
+			void Destroy()
+			{
+				Application* app = Application::GetInstance();
+				Data* data = GetData(app);
+
+				if (data->main_window)
+				{
+					delete data->main_window;
+					data->main_window = nullptr;
+				}
+			}
+			void Terminate()
+			{
+				::PushEvent(::MakeEvent(EventType::kClose));
+			}
+
+			void ToggleFullscreen(void)
+			{
+				Window* window = ::GetMainWindow();
+				if (window->base.fullscreen)
+					MakeWindowed();
+				else
+					MakeFullscreen();
+			}
+			bool MakeFullscreen()
+			{
+				// There is no screen, so fullscreen just changes the state
+				Window* window = ::GetMainWindow();
+				window->base.fullscreen = true;
+				return true;
+			}
+			void MakeWindowed()
+			{
+				Window* window = ::GetMainWindow();
+				window->base.fullscreen = false;
+			}
+			void Center()
+			{
+			}
+			void Resize(int width, int height)
+			{
+				Window* window = ::GetMainWindow();
+				::ResizeWindow(window, width, height);
+			}
+			void Iconify()
+			{
+				Window* window = ::GetMainWindow();
+				window->base.visible = false;
+			}
+			void Restore()
+			{
+				Window* window = ::GetMainWindow();
+				window->base.visible = true;
+			}
+			void Show()
+			{
+				Window* window = ::GetMainWindow();
+				window->base.visible = true;
+			}
+			void Hide()
+			{
+				Window* window = ::GetMainWindow();
+				window->base.visible = false;
+			}
+			bool IsVisible()
+			{
+				Window* window = ::GetMainWindow();
+				return window->base.visible;
+			}
+			void SetTitle(const wchar_t* title)
+			{
+				Window* window = ::GetMainWindow();
+				window->title = title;
+			}
+			std::wstring GetTitle()
+			{
+				Window* window = ::GetMainWindow();
+				return window->title;
+			}
+
+		} // namespace window
+
+		// Cursor operations
+		namespace cursor {
+
+			void GetPos(float* x, float* y)
+			{
+				Window* window = ::GetMainWindow();
+				if (x)
+					*x = window->cursor_x;
+				if (y)
+					*y = window->cursor_y;
+			}
+			void SetPos(float x, float y)
+			{
+				Window* window = ::GetMainWindow();
+				window->cursor_x = x;
+				window->cursor_y = y;
+			}
+			void Center()
+			{
+				Window* window = ::GetMainWindow();
+				window->cursor_x = static_cast<float>(window->base.width / 2);
+				window->cursor_y = static_cast<float>(window->base.height / 2);
+			}
+			void Show()
+			{
+				Window* window = ::GetMainWindow();
+				window->cursor_visible = true;
+			}
+			void Hide()
+			{
+				Window* window = ::GetMainWindow();
+				window->cursor_visible = false;
+			}
+
+		} // namespace cursor
+
+		// Clipboard operations
+		namespace clipboard {
+
+			void SetText(const char *text)
+			{
+				Application* app = Application::GetInstance();
+				Data* data = GetData(app);
+				data->clipboard = text;
+			}
+			std::string GetText()
+			{
+				Application* app = Application::GetInstance();
+				Data* data = GetData(app);
+				return data->clipboard;
+			}
+
+		} // namespace clipboard
+
+	} // namespace platform
+
+	namespace headless {
+
+		void PushKeyDown(KeyboardKey key, KeyModifiers modifiers)
+		{
+			platform::Event event = ::MakeEvent(platform::EventType::kKeyDown);
+			event.key = key;
+			event.modifiers = modifiers;
+			::PushEvent(event);
+		}
+		void PushKeyUp(KeyboardKey key, KeyModifiers modifiers)
+		{
+			platform::Event event = ::MakeEvent(platform::EventType::kKeyUp);
+			event.key = key;
+			event.modifiers = modifiers;
+			::PushEvent(event);
+		}
+		void PushChar(KeyCode code)
+		{
+			platform::Event event = ::MakeEvent(platform::EventType::kChar);
+			event.code = code;
+			::PushEvent(event);
+		}
+		void PushMouseDown(MouseButton button)
+		{
+			platform::Event event = ::MakeEvent(platform::EventType::kMouseDown);
+			event.button = button;
+			::PushEvent(event);
+		}
+		void PushMouseUp(MouseButton button)
+		{
+			platform::Event event = ::MakeEvent(platform::EventType::kMouseUp);
+			event.button = button;
+			::PushEvent(event);
+		}
+		void PushMouseMove(float x, float y)
+		{
+			platform::Event event = ::MakeEvent(platform::EventType::kMouseMove);
+			event.x = x;
+			event.y = y;
+			::PushEvent(event);
+		}
+		void PushScroll(float delta_x, float delta_y)
+		{
+			platform::Event event = ::MakeEvent(platform::EventType::kScroll);
+			event.x = delta_x;
+			event.y = delta_y;
+			::PushEvent(event);
+		}
+		void PushResize(int width, int height)
+		{
+			platform::Event event = ::MakeEvent(platform::EventType::kResize);
+			event.width = width;
+			event.height = height;
+			::PushEvent(event);
+		}
+		void PushFocus(bool active)
+		{
+			platform::Event event = ::MakeEvent(platform::EventType::kFocus);
+			event.active = active;
+			::PushEvent(event);
+		}
+		void PushClose()
+		{
+			::PushEvent(::MakeEvent(platform::EventType::kClose));
+		}
+
+	} // namespace headless
+
+} // namespace scythe
\ No newline at end of file
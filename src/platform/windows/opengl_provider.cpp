@@ -1,6 +1,7 @@
 #include <scythe/opengl/opengl_provider.h>
 
 #include <scythe/opengl/opengl_include.h>
+#include <scythe/opengl/opengl_profiler.h>
 #include <scythe/desktop_application.h>
 #include <scythe/log.h>
 #include "platform_data.h"
@@ -86,6 +87,11 @@ namespace scythe {
 			return false;
 		}
 
+#ifdef SCYTHE_USE_PROFILER
+		// GPU profiling is optional, so don't fail on it
+		OpenGLProfiler::GetInstance()->Initialize();
+#endif
+
 		// Finally
 		initialized_ = true;
 
@@ -94,6 +100,9 @@ namespace scythe {
 	void OpenGLGraphicsProvider::Deinitialize()
 	{
 		LibraryWGL* wgl = LibraryWGL::GetInstance();
+#ifdef SCYTHE_USE_PROFILER
+		OpenGLProfiler::GetInstance()->Deinitialize();
+#endif
 		wgl->DestroyContext();
 		wgl->Deinitialize();
 	}
@@ -103,6 +112,9 @@ namespace scythe {
 	}
 	void OpenGLGraphicsProvider::EndFrame()
 	{
+#ifdef SCYTHE_USE_PROFILER
+		OpenGLProfiler::GetInstance()->EndFrame();
+#endif
 		// Swap buffers
 		platform::Window* window = ::GetMainWindow(application_);
 
@@ -0,0 +1,366 @@
+#include "glx.h"
+
+#include <cstring>
+#include <cassert>
+#include <dlfcn.h>
+
+#include <scythe/application.h>
+#include <scythe/log.h>
+#include "platform_data.h"
+#include "../platform_inner.h"
+
+/**
+ * @brief      Determines if string in extension string.
+ *
+ * @param[in]  string      The string
+ * @param[in]  extensions  The extensions
+ *
+ * @return     True if string in extension string, False otherwise.
+ */
+static bool IsStringInExtensionString(const char* string, const char* extensions)
+{
+	const char* start = extensions;
+
+	for (;;)
+	{
+		const char* where;
+		const char* terminator;
+
+		where = std::strstr(start, string);
+		if (!where)
+			return false;
+
+		terminator = where + std::strlen(string);
+		if (where == start || *(where - 1) == ' ')
+		{
+			if (*terminator == ' ' || *terminator == '\0')
+				break;
+		}
+
+		start = terminator;
+	}
+
+	return true;
+}
+
+static inline scythe::platform::Data* GetPlatformData()
+{
+	scythe::Application* app = scythe::Application::GetInstance();
+	return scythe::platform::GetData(app);
+}
+
+namespace scythe {
+
+	bool LibraryGLX::Initialize()
+	{
+		if (library_handle_)
+			return true;
+
+		library_handle_ = ::dlopen("libGL.so.1", RTLD_LAZY | RTLD_GLOBAL);
+		if (!library_handle_)
+			library_handle_ = ::dlopen("libGLX.so.0", RTLD_LAZY | RTLD_GLOBAL);
+		if (!library_handle_)
+		{
+			Error("GLX: Failed to load libGL.so.1");
+			return false;
+		}
+
+		glXQueryExtension        = (PFN_glXQueryExtension)        ::dlsym(library_handle_, "glXQueryExtension");
+		glXQueryVersion          = (PFN_glXQueryVersion)          ::dlsym(library_handle_, "glXQueryVersion");
+		glXQueryExtensionsString = (PFN_glXQueryExtensionsString) ::dlsym(library_handle_, "glXQueryExtensionsString");
+		glXChooseFBConfig        = (PFN_glXChooseFBConfig)        ::dlsym(library_handle_, "glXChooseFBConfig");
+		glXGetFBConfigAttrib     = (PFN_glXGetFBConfigAttrib)     ::dlsym(library_handle_, "glXGetFBConfigAttrib");
+		glXGetVisualFromFBConfig = (PFN_glXGetVisualFromFBConfig) ::dlsym(library_handle_, "glXGetVisualFromFBConfig");
+		glXCreateNewContext      = (PFN_glXCreateNewContext)      ::dlsym(library_handle_, "glXCreateNewContext");
+		glXDestroyContext        = (PFN_glXDestroyContext)        ::dlsym(library_handle_, "glXDestroyContext");
+		glXMakeCurrent           = (PFN_glXMakeCurrent)           ::dlsym(library_handle_, "glXMakeCurrent");
+		glXSwapBuffers           = (PFN_glXSwapBuffers)           ::dlsym(library_handle_, "glXSwapBuffers");
+		glXGetProcAddress        = (PFN_glXGetProcAddress)        ::dlsym(library_handle_, "glXGetProcAddressARB");
+
+		if (!glXQueryExtension || !glXQueryVersion || !glXQueryExtensionsString ||
+			!glXChooseFBConfig || !glXGetFBConfigAttrib || !glXGetVisualFromFBConfig ||
+			!glXCreateNewContext || !glXDestroyContext || !glXMakeCurrent ||
+			!glXSwapBuffers || !glXGetProcAddress)
+		{
+			Error("GLX: Failed to load required entry points");
+			Deinitialize();
+			return false;
+		}
+
+		platform::Data* data = ::GetPlatformData();
+
+		int error_base, event_base;
+		if (!glXQueryExtension(data->display, &error_base, &event_base))
+		{
+			Error("GLX: GLX extension not found");
+			Deinitialize();
+			return false;
+		}
+
+		int major, minor;
+		if (!glXQueryVersion(data->display, &major, &minor) || (major == 1 && minor < 3))
+		{
+			Error("GLX: GLX version 1.3 is required");
+			Deinitialize();
+			return false;
+		}
+
+		ARB_create_context = IsExtensionSupported("GLX_ARB_create_context");
+		ARB_create_context_profile = IsExtensionSupported("GLX_ARB_create_context_profile");
+		ARB_create_context_no_error = IsExtensionSupported("GLX_ARB_create_context_no_error");
+		ARB_framebuffer_sRGB = IsExtensionSupported("GLX_ARB_framebuffer_sRGB") ||
+			IsExtensionSupported("GLX_EXT_framebuffer_sRGB");
+		ARB_multisample = IsExtensionSupported("GLX_ARB_multisample");
+		EXT_swap_control = IsExtensionSupported("GLX_EXT_swap_control");
+		MESA_swap_control = IsExtensionSupported("GLX_MESA_swap_control");
+		SGI_swap_control = IsExtensionSupported("GLX_SGI_swap_control");
+
+		if (ARB_create_context)
+			glXCreateContextAttribsARB = (PFN_glXCreateContextAttribsARB) GetProcedureAddress("glXCreateContextAttribsARB");
+		if (EXT_swap_control)
+			glXSwapIntervalEXT = (PFN_glXSwapIntervalEXT) GetProcedureAddress("glXSwapIntervalEXT");
+		if (MESA_swap_control)
+			glXSwapIntervalMESA = (PFN_glXSwapIntervalMESA) GetProcedureAddress("glXSwapIntervalMESA");
+		if (SGI_swap_control)
+			glXSwapIntervalSGI = (PFN_glXSwapIntervalSGI) GetProcedureAddress("glXSwapIntervalSGI");
+
+		ARB_create_context = ARB_create_context && glXCreateContextAttribsARB;
+		EXT_swap_control = EXT_swap_control && glXSwapIntervalEXT;
+		MESA_swap_control = MESA_swap_control && glXSwapIntervalMESA;
+		SGI_swap_control = SGI_swap_control && glXSwapIntervalSGI;
+
+		return true;
+	}
+	void LibraryGLX::Deinitialize()
+	{
+		if (library_handle_)
+		{
+			::dlclose(library_handle_);
+			library_handle_ = nullptr;
+		}
+	}
+
+#define SET_ATTRIB(a, v) \
+{ \
+	assert(((size_t) index + 1) < sizeof(attribs) / sizeof(attribs[0])); \
+	attribs[index++] = a; \
+	attribs[index++] = v; \
+}
+
+	GLXFBConfig LibraryGLX::_ChooseFBConfig(const OpenGLFramebufferConfiguration* fb_config)
+	{
+		platform::Data* data = ::GetPlatformData();
+		int attribs[40];
+		int index = 0;
+
+		SET_ATTRIB(GLX_X_RENDERABLE, True);
+		SET_ATTRIB(GLX_DRAWABLE_TYPE, GLX_WINDOW_BIT);
+		SET_ATTRIB(GLX_RENDER_TYPE, GLX_RGBA_BIT);
+		SET_ATTRIB(GLX_X_VISUAL_TYPE, GLX_TRUE_COLOR);
+		SET_ATTRIB(GLX_RED_SIZE, fb_config->red_bits);
+		SET_ATTRIB(GLX_GREEN_SIZE, fb_config->green_bits);
+		SET_ATTRIB(GLX_BLUE_SIZE, fb_config->blue_bits);
+		SET_ATTRIB(GLX_ALPHA_SIZE, fb_config->alpha_bits);
+		SET_ATTRIB(GLX_DEPTH_SIZE, fb_config->depth_bits);
+		SET_ATTRIB(GLX_STENCIL_SIZE, fb_config->stencil_bits);
+		SET_ATTRIB(GLX_DOUBLEBUFFER, fb_config->doublebuffer ? True : False);
+		if (fb_config->stereo)
+			SET_ATTRIB(GLX_STEREO, True);
+		if (fb_config->aux_buffers)
+			SET_ATTRIB(GLX_AUX_BUFFERS, fb_config->aux_buffers);
+		if (fb_config->samples && ARB_multisample)
+			SET_ATTRIB(GLX_SAMPLES, fb_config->samples);
+		if (fb_config->sRGB && ARB_framebuffer_sRGB)
+			SET_ATTRIB(GLX_FRAMEBUFFER_SRGB_CAPABLE_ARB, True);
+		SET_ATTRIB(None, None);
+
+		int count = 0;
+		GLXFBConfig* configs = glXChooseFBConfig(data->display, data->screen, attribs, &count);
+		if (!configs || count == 0)
+		{
+			Error("GLX: Failed to find a suitable GLXFBConfig");
+			return nullptr;
+		}
+
+		// Configs are sorted by the best match, so take the first one
+		GLXFBConfig result = configs[0];
+		::XFree(configs);
+		return result;
+	}
+	bool LibraryGLX::ChooseVisual(const OpenGLFramebufferConfiguration* fb_config, Visual** visual, int* depth)
+	{
+		platform::Data* data = ::GetPlatformData();
+		platform::Window* window = data->main_window;
+
+		GLXFBConfig config = _ChooseFBConfig(fb_config);
+		if (!config)
+			return false;
+
+		XVisualInfo* info = glXGetVisualFromFBConfig(data->display, config);
+		if (!info)
+		{
+			Error("GLX: Failed to retrieve visual for GLXFBConfig");
+			return false;
+		}
+
+		window->context.fbconfig = config;
+		*visual = info->visual;
+		*depth = info->depth;
+		::XFree(info);
+		return true;
+	}
+	bool LibraryGLX::CreateContext(const OpenGLContextConfiguration* context_config)
+	{
+		platform::Data* data = ::GetPlatformData();
+		platform::Window* window = data->main_window;
+		GLXFBConfig config = (GLXFBConfig) window->context.fbconfig;
+		GLXContext share = NULL;
+
+		if (!config)
+		{
+			Error("GLX: Window has been created without GLXFBConfig");
+			return false;
+		}
+		if (context_config->forward)
+		{
+			if (!ARB_create_context)
+			{
+				Error("GLX: A forward compatible OpenGL context requested but GLX_ARB_create_context is unavailable");
+				return false;
+			}
+		}
+		if (context_config->profile != OpenGLContextProfile::kDefault)
+		{
+			if (!ARB_create_context_profile)
+			{
+				Error("GLX: OpenGL profile requested but GLX_ARB_create_context_profile is unavailable");
+				return false;
+			}
+		}
+
+		GLXContext context;
+		if (ARB_create_context)
+		{
+			int attribs[40];
+			int index = 0, mask = 0, flags = 0;
+
+			if (context_config->forward)
+				flags |= GLX_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB;
+
+			if (context_config->profile == OpenGLContextProfile::kCore)
+				mask |= GLX_CONTEXT_CORE_PROFILE_BIT_ARB;
+			else if (context_config->profile == OpenGLContextProfile::kCompatibility)
+				mask |= GLX_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB;
+
+			if (context_config->debug)
+				flags |= GLX_CONTEXT_DEBUG_BIT_ARB;
+
+			if (context_config->noerror)
+			{
+				if (ARB_create_context_no_error)
+					SET_ATTRIB(GLX_CONTEXT_OPENGL_NO_ERROR_ARB, True);
+			}
+
+			// NOTE: Only request an explicitly versioned context when necessary, as
+			//       explicitly requesting version 1.0 does not always return the
+			//       highest version supported by the driver
+			if (context_config->major != 1 || context_config->minor != 0)
+			{
+				SET_ATTRIB(GLX_CONTEXT_MAJOR_VERSION_ARB, context_config->major);
+				SET_ATTRIB(GLX_CONTEXT_MINOR_VERSION_ARB, context_config->minor);
+			}
+
+			if (flags)
+				SET_ATTRIB(GLX_CONTEXT_FLAGS_ARB, flags);
+
+			if (mask)
+				SET_ATTRIB(GLX_CONTEXT_PROFILE_MASK_ARB, mask);
+
+			SET_ATTRIB(None, None);
+
+			context = glXCreateContextAttribsARB(data->display, config, share, True, attribs);
+		}
+		else
+		{
+			context = glXCreateNewContext(data->display, config, GLX_RGBA_TYPE, share, True);
+		}
+
+		if (!context)
+		{
+			Error("GLX: Failed to create OpenGL %i.%i context", context_config->major, context_config->minor);
+			return false;
+		}
+
+		window->context.handle = context;
+		return true;
+	}
+
+#undef SET_ATTRIB
+
+	void LibraryGLX::DestroyContext()
+	{
+		platform::Data* data = ::GetPlatformData();
+		platform::Window* window = data->main_window;
+
+		if (window->context.handle)
+		{
+			glXMakeCurrent(data->display, None, NULL);
+			glXDestroyContext(data->display, (GLXContext) window->context.handle);
+			window->context.handle = nullptr;
+		}
+	}
+	bool LibraryGLX::MakeContextCurrent()
+	{
+		platform::Data* data = ::GetPlatformData();
+		platform::Window* window = data->main_window;
+
+		if (!glXMakeCurrent(data->display, window->handle, (GLXContext) window->context.handle))
+		{
+			Error("GLX: Failed to make context current");
+			return false;
+		}
+		return true;
+	}
+	void LibraryGLX::SwapBuffers()
+	{
+		platform::Data* data = ::GetPlatformData();
+		platform::Window* window = data->main_window;
+
+		glXSwapBuffers(data->display, window->handle);
+	}
+	void LibraryGLX::SetSwapInterval(int interval)
+	{
+		platform::Data* data = ::GetPlatformData();
+		platform::Window* window = data->main_window;
+
+		if (EXT_swap_control)
+			glXSwapIntervalEXT(data->display, window->handle, interval);
+		else if (MESA_swap_control)
+			glXSwapIntervalMESA(interval);
+		else if (SGI_swap_control)
+		{
+			// SGI version doesn't accept zero interval
+			if (interval > 0)
+				glXSwapIntervalSGI(interval);
+		}
+	}
+	bool LibraryGLX::IsExtensionSupported(const char* extension)
+	{
+		platform::Data* data = ::GetPlatformData();
+
+		const char* extensions = glXQueryExtensionsString(data->display, data->screen);
+		if (!extensions)
+			return false;
+
+		return ::IsStringInExtensionString(extension, extensions);
+	}
+	LibraryGLX::Procedure LibraryGLX::GetProcedureAddress(const char* name)
+	{
+		const Procedure proc = (Procedure) glXGetProcAddress((const unsigned char*) name);
+		if (proc)
+			return proc;
+
+		return (Procedure) ::dlsym(library_handle_, name);
+	}
+
+} // namespace scythe
\ No newline at end of file
@@ -0,0 +1,135 @@
+#ifndef __SCYTHE_GLX_H__
+#define __SCYTHE_GLX_H__
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+
+#include <scythe/singleton.h>
+
+#include "../../graphics/opengl/opengl_context_config.h"
+#include "../../graphics/opengl/opengl_framebuffer_config.h"
+
+// GLX types
+typedef XID GLXWindow;
+typedef XID GLXDrawable;
+typedef struct __GLXFBConfig* GLXFBConfig;
+typedef struct __GLXcontext* GLXContext;
+typedef void (*__GLXextproc)(void);
+
+// GLX specific defines
+#define GLX_DOUBLEBUFFER 5
+#define GLX_STEREO 6
+#define GLX_AUX_BUFFERS 7
+#define GLX_RED_SIZE 8
+#define GLX_GREEN_SIZE 9
+#define GLX_BLUE_SIZE 10
+#define GLX_ALPHA_SIZE 11
+#define GLX_DEPTH_SIZE 12
+#define GLX_STENCIL_SIZE 13
+#define GLX_ACCUM_RED_SIZE 14
+#define GLX_ACCUM_GREEN_SIZE 15
+#define GLX_ACCUM_BLUE_SIZE 16
+#define GLX_ACCUM_ALPHA_SIZE 17
+#define GLX_SAMPLES 0x186a1
+#define GLX_X_VISUAL_TYPE 0x22
+#define GLX_TRUE_COLOR 0x8002
+#define GLX_DRAWABLE_TYPE 0x8010
+#define GLX_RENDER_TYPE 0x8011
+#define GLX_X_RENDERABLE 0x8012
+#define GLX_RGBA_TYPE 0x8014
+#define GLX_RGBA_BIT 0x00000001
+#define GLX_WINDOW_BIT 0x00000001
+#define GLX_FRAMEBUFFER_SRGB_CAPABLE_ARB 0x20b2
+#define GLX_CONTEXT_MAJOR_VERSION_ARB 0x2091
+#define GLX_CONTEXT_MINOR_VERSION_ARB 0x2092
+#define GLX_CONTEXT_FLAGS_ARB 0x2094
+#define GLX_CONTEXT_PROFILE_MASK_ARB 0x9126
+#define GLX_CONTEXT_DEBUG_BIT_ARB 0x00000001
+#define GLX_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB 0x00000002
+#define GLX_CONTEXT_CORE_PROFILE_BIT_ARB 0x00000001
+#define GLX_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB 0x00000002
+#define GLX_CONTEXT_OPENGL_NO_ERROR_ARB 0x31b3
+
+// GLX function pointer typedefs
+typedef Bool (* PFN_glXQueryExtension)(Display*,int*,int*);
+typedef Bool (* PFN_glXQueryVersion)(Display*,int*,int*);
+typedef const char* (* PFN_glXQueryExtensionsString)(Display*,int);
+typedef GLXFBConfig* (* PFN_glXChooseFBConfig)(Display*,int,const int*,int*);
+typedef int (* PFN_glXGetFBConfigAttrib)(Display*,GLXFBConfig,int,int*);
+typedef XVisualInfo* (* PFN_glXGetVisualFromFBConfig)(Display*,GLXFBConfig);
+typedef GLXContext (* PFN_glXCreateNewContext)(Display*,GLXFBConfig,int,GLXContext,Bool);
+typedef void (* PFN_glXDestroyContext)(Display*,GLXContext);
+typedef Bool (* PFN_glXMakeCurrent)(Display*,GLXDrawable,GLXContext);
+typedef void (* PFN_glXSwapBuffers)(Display*,GLXDrawable);
+typedef __GLXextproc (* PFN_glXGetProcAddress)(const unsigned char*);
+
+// GLX extension pointer typedefs
+typedef GLXContext (* PFN_glXCreateContextAttribsARB)(Display*,GLXFBConfig,GLXContext,Bool,const int*);
+typedef void (* PFN_glXSwapIntervalEXT)(Display*,GLXDrawable,int);
+typedef int (* PFN_glXSwapIntervalMESA)(int);
+typedef int (* PFN_glXSwapIntervalSGI)(int);
+
+namespace scythe {
+
+	/**
+	 * @brief      This class describes a library GLX.
+	 * @details    Unlike WGL, framebuffer configuration should be chosen before
+	 *             window creation, because X11 window visual can't be changed.
+	 */
+	class LibraryGLX final
+	: public Singleton<LibraryGLX>
+	{
+	public:
+		bool Initialize();
+		void Deinitialize();
+
+		bool ChooseVisual(const OpenGLFramebufferConfiguration* fb_config, Visual** visual, int* depth);
+
+		bool CreateContext(const OpenGLContextConfiguration* context_config);
+		void DestroyContext();
+		bool MakeContextCurrent();
+		void SwapBuffers();
+		void SetSwapInterval(int interval);
+
+		bool IsExtensionSupported(const char* extension);
+
+		typedef void (*Procedure)(void);
+		Procedure GetProcedureAddress(const char* name);
+
+	private:
+		GLXFBConfig _ChooseFBConfig(const OpenGLFramebufferConfiguration* fb_config);
+
+	public:
+		PFN_glXQueryExtension               glXQueryExtension;
+		PFN_glXQueryVersion                 glXQueryVersion;
+		PFN_glXQueryExtensionsString        glXQueryExtensionsString;
+		PFN_glXChooseFBConfig               glXChooseFBConfig;
+		PFN_glXGetFBConfigAttrib            glXGetFBConfigAttrib;
+		PFN_glXGetVisualFromFBConfig        glXGetVisualFromFBConfig;
+		PFN_glXCreateNewContext             glXCreateNewContext;
+		PFN_glXDestroyContext               glXDestroyContext;
+		PFN_glXMakeCurrent                  glXMakeCurrent;
+		PFN_glXSwapBuffers                  glXSwapBuffers;
+		PFN_glXGetProcAddress               glXGetProcAddress;
+
+		PFN_glXCreateContextAttribsARB      glXCreateContextAttribsARB;
+		PFN_glXSwapIntervalEXT              glXSwapIntervalEXT;
+		PFN_glXSwapIntervalMESA             glXSwapIntervalMESA;
+		PFN_glXSwapIntervalSGI              glXSwapIntervalSGI;
+
+		bool                                ARB_create_context;
+		bool                                ARB_create_context_profile;
+		bool                                ARB_create_context_no_error;
+		bool                                ARB_framebuffer_sRGB;
+		bool                                ARB_multisample;
+		bool                                EXT_swap_control;
+		bool                                MESA_swap_control;
+		bool                                SGI_swap_control;
+
+	private:
+		void*                               library_handle_;
+	};
+
+} // namespace scythe
+
+#endif
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include <scythe/opengl/opengl_provider.h>
+
+#include <scythe/opengl/opengl_include.h>
+#include <scythe/opengl/opengl_profiler.h>
+#include <scythe/desktop_application.h>
+#include <scythe/log.h>
+#include "platform_data.h"
+#include "../platform_inner.h"
+#include "glx.h"
+
+/**
+ * @brief      Gets the proc address.
+ *
+ * @param[in]  name  The name
+ *
+ * @return     The proc address.
+ */
+static GLADapiproc GetProcedureAddress(const char* name)
+{
+	scythe::LibraryGLX* glx = scythe::LibraryGLX::GetInstance();
+	return glx->GetProcedureAddress(name);
+}
+
+namespace scythe {
+
+	bool OpenGLGraphicsProvider::Initialize()
+	{
+		LibraryGLX* glx = LibraryGLX::GetInstance();
+		// GLX has been initialized during window creation to choose visual
+		if (!glx->Initialize())
+			return false;
+
+		// Context configuration
+		OpenGLContextConfiguration context_config;
+		context_config.major = context_major_version_;
+		context_config.minor = context_minor_version_;
+		context_config.profile = OpenGLContextProfile::kCore;
+		context_config.forward = true;
+		context_config.noerror = false;
+		context_config.debug = false;
+
+		// Create OpenGL context
+		if (!glx->CreateContext(&context_config))
+		{
+			glx->Deinitialize();
+			return false;
+		}
+
+		MakeContextCurrent();
+
+		// Load GLAD
+		if (!gladLoadGL(::GetProcedureAddress))
+		{
+			Error("GLAD loading failed");
+			return false;
+		}
+
+#ifdef SCYTHE_USE_PROFILER
+		// GPU profiling is optional, so don't fail on it
+		OpenGLProfiler::GetInstance()->Initialize();
+#endif
+
+		// Finally
+		initialized_ = true;
+
+		return true;
+	}
+	void OpenGLGraphicsProvider::Deinitialize()
+	{
+		LibraryGLX* glx = LibraryGLX::GetInstance();
+#ifdef SCYTHE_USE_PROFILER
+		OpenGLProfiler::GetInstance()->Deinitialize();
+#endif
+		glx->DestroyContext();
+		glx->Deinitialize();
+	}
+	void OpenGLGraphicsProvider::BeginFrame()
+	{
+		// Nothing to do here
+	}
+	void OpenGLGraphicsProvider::EndFrame()
+	{
+#ifdef SCYTHE_USE_PROFILER
+		OpenGLProfiler::GetInstance()->EndFrame();
+#endif
+		LibraryGLX* glx = LibraryGLX::GetInstance();
+		glx->SwapBuffers();
+	}
+	void OpenGLGraphicsProvider::SetSwapInterval(int interval)
+	{
+		LibraryGLX* glx = LibraryGLX::GetInstance();
+		glx->SetSwapInterval(interval);
+	}
+	void OpenGLGraphicsProvider::MakeContextCurrent()
+	{
+		LibraryGLX* glx = LibraryGLX::GetInstance();
+		glx->MakeContextCurrent();
+	}
+
+} // namespace scythe
\ No newline at end of file
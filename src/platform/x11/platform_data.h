@@ -0,0 +1,82 @@
+#ifndef __SCYTHE_PLATFORM_DATA_H__
+#define __SCYTHE_PLATFORM_DATA_H__
+
+#include "../base_window.h"
+
+#include <string>
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+
+namespace scythe::platform {
+
+#ifdef SCYTHE_USE_OPENGL
+	/**
+	 * @brief      Rendering context implementation for X11 platform
+	 */
+	struct RenderingContext
+	{
+		void* fbconfig;			//!< GLXFBConfig chosen before window creation
+		void* handle;			//!< GLXContext
+	};
+#endif
+
+	/**
+	 * @brief      Window implementation for X11 platform
+	 */
+	struct Window
+	{
+		// Base window struct to avoid inheritance
+		BaseWindow base;
+
+#ifdef SCYTHE_USE_OPENGL
+		RenderingContext context;
+#endif
+		::Window handle;
+		Colormap colormap;
+		XIC ic;
+
+		std::wstring title;
+
+		int windowed_x;
+		int windowed_y;
+		int windowed_width;
+		int windowed_height;
+
+		int old_mouse_x;
+		int old_mouse_y;
+		bool cursor_hidden;
+	};
+
+	/**
+	 * @brief      Describes data specific for X11 platform.
+	 */
+	struct Data
+	{
+		Display* display;
+		int screen;
+		::Window root;
+		XIM im;
+		Cursor hidden_cursor;
+
+		// Atoms
+		Atom WM_PROTOCOLS;
+		Atom WM_DELETE_WINDOW;
+		Atom NET_WM_NAME;
+		Atom NET_WM_ICON_NAME;
+		Atom NET_WM_STATE;
+		Atom NET_WM_STATE_FULLSCREEN;
+		Atom MOTIF_WM_HINTS;
+		Atom UTF8_STRING;
+		Atom CLIPBOARD;
+		Atom TARGETS;
+		Atom SCYTHE_SELECTION;
+
+		std::string clipboard_string;	//!< text we own in CLIPBOARD selection
+
+		Window* main_window;
+	};
+
+} // namespace scythe::platform
+
+#endif
\ No newline at end of file
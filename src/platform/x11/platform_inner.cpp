@@ -0,0 +1,995 @@
+#include "../platform_inner.h"
+
+#include <cstring>
+#include <climits>
+#include <unistd.h>
+#include <poll.h>
+
+#include <scythe/desktop_application.h>
+#include <scythe/log.h>
+
+#include "platform_data.h"
+
+#include <X11/Xatom.h>
+#include <X11/XKBlib.h>
+
+#ifdef SCYTHE_USE_OPENGL
+# include "glx.h"
+#endif
+
+static constexpr long kEventMask = StructureNotifyMask | KeyPressMask | KeyReleaseMask |
+	PointerMotionMask | ButtonPressMask | ButtonReleaseMask | ExposureMask |
+	FocusChangeMask | VisibilityChangeMask | PropertyChangeMask;
+static constexpr int kSelectionTimeout = 1000; //!< clipboard request timeout in milliseconds
+
+static inline scythe::platform::Data* GetPlatformData()
+{
+	scythe::Application* app = scythe::Application::GetInstance();
+	return scythe::platform::GetData(app);
+}
+static inline scythe::platform::Window* GetMainWindow()
+{
+	scythe::platform::Data* data = ::GetPlatformData();
+	return data->main_window;
+}
+
+// Converts wide string to UTF-8 one
+static std::string WideToUtf8(const wchar_t* text)
+{
+	std::string result;
+	for (; *text; ++text)
+	{
+		const unsigned int c = static_cast<unsigned int>(*text);
+		if (c < 0x80)
+			result += static_cast<char>(c);
+		else if (c < 0x800)
+		{
+			result += static_cast<char>(0xC0 | (c >> 6));
+			result += static_cast<char>(0x80 | (c & 0x3F));
+		}
+		else if (c < 0x10000)
+		{
+			result += static_cast<char>(0xE0 | (c >> 12));
+			result += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+			result += static_cast<char>(0x80 | (c & 0x3F));
+		}
+		else if (c < 0x110000)
+		{
+			result += static_cast<char>(0xF0 | (c >> 18));
+			result += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+			result += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+			result += static_cast<char>(0x80 | (c & 0x3F));
+		}
+	}
+	return result;
+}
+
+// Decodes a single code point from UTF-8 string and advances the pointer
+static unsigned int DecodeUtf8(const char** s)
+{
+	static const unsigned int offsets[] =
+	{
+		0x00000000u, 0x00003080u, 0x000e2080u,
+		0x03c82080u, 0xfa082080u, 0x82082080u
+	};
+	unsigned int codepoint = 0, count = 0;
+	do
+	{
+		codepoint = (codepoint << 6) + (unsigned char) **s;
+		(*s)++;
+		count++;
+	} while ((**s & 0xC0) == 0x80 && count < 6);
+	return codepoint - offsets[count - 1];
+}
+
+// Translates X11 key modifiers to engine ones
+static scythe::KeyModifiers TranslateKeyboardModifiers(unsigned int state)
+{
+	scythe::KeyModifiers modifiers;
+	if (state & ShiftMask)
+		modifiers |= scythe::KeyboardKeyModifier::kShift;
+	if (state & ControlMask)
+		modifiers |= scythe::KeyboardKeyModifier::kControl;
+	if (state & Mod1Mask)
+		modifiers |= scythe::KeyboardKeyModifier::kAlt;
+	if (state & Mod4Mask)
+		modifiers |= scythe::KeyboardKeyModifier::kSuper;
+	return modifiers;
+}
+static scythe::KeyboardKey TranslateKey(unsigned int keycode)
+{
+	if (keycode >= scythe::KeyboardState::kTableSize)
+		return scythe::KeyboardKey::kUnknown;
+
+	scythe::DesktopApplication* desktop_app = scythe::DesktopApplication::GetInstance();
+	scythe::KeyboardState& keyboard_state = desktop_app->GetKeyboardState();
+	return keyboard_state.GetKeyByCode(static_cast<scythe::KeyCode>(keycode));
+}
+static void SendCharacter(unsigned int codepoint)
+{
+	scythe::DesktopApplication* desktop_app = scythe::DesktopApplication::GetInstance();
+	scythe::KeyboardController* keyboard_controller = desktop_app->GetKeyboardController();
+
+	// Key code is limited by basic multilingual plane
+	if (codepoint > 0xFFFF)
+		return;
+	scythe::KeyCode code = static_cast<scythe::KeyCode>(codepoint);
+	if (keyboard_controller && scythe::IsGoodChar(code))
+		keyboard_controller->OnChar(code);
+}
+static void ProcessCharacters(scythe::platform::Window* window, XKeyEvent* event)
+{
+	char buffer[100];
+	if (window->ic)
+	{
+		Status status;
+		char* chars = buffer;
+		int count = ::Xutf8LookupString(window->ic, event, buffer, sizeof(buffer) - 1, NULL, &status);
+		std::string long_buffer;
+		if (status == XBufferOverflow)
+		{
+			long_buffer.resize(count + 1);
+			chars = long_buffer.data();
+			count = ::Xutf8LookupString(window->ic, event, chars, count, NULL, &status);
+		}
+		if (status == XLookupChars || status == XLookupBoth)
+		{
+			chars[count] = '\0';
+			const char* c = chars;
+			while (c - chars < count)
+				::SendCharacter(::DecodeUtf8(&c));
+		}
+	}
+	else
+	{
+		// Fallback to Latin-1 characters
+		KeySym keysym;
+		int count = ::XLookupString(event, buffer, sizeof(buffer) - 1, &keysym, NULL);
+		for (int i = 0; i < count; ++i)
+			::SendCharacter(static_cast<unsigned char>(buffer[i]));
+	}
+}
+static void HandleSelectionRequest(scythe::platform::Data* data, XSelectionRequestEvent* request)
+{
+	XSelectionEvent reply;
+	std::memset(&reply, 0, sizeof(reply));
+	reply.type = SelectionNotify;
+	reply.requestor = request->requestor;
+	reply.selection = request->selection;
+	reply.target = request->target;
+	reply.time = request->time;
+	reply.property = None;
+
+	// Obsolete clients may not set property
+	Atom property = (request->property != None) ? request->property : request->target;
+
+	if (request->target == data->TARGETS)
+	{
+		const Atom targets[] = { data->TARGETS, data->UTF8_STRING, XA_STRING };
+		::XChangeProperty(data->display, request->requestor, property, XA_ATOM, 32, PropModeReplace,
+			(const unsigned char*) targets, sizeof(targets) / sizeof(targets[0]));
+		reply.property = property;
+	}
+	else if (request->target == data->UTF8_STRING || request->target == XA_STRING)
+	{
+		::XChangeProperty(data->display, request->requestor, property, request->target, 8, PropModeReplace,
+			(const unsigned char*) data->clipboard_string.c_str(), (int) data->clipboard_string.size());
+		reply.property = property;
+	}
+
+	::XSendEvent(data->display, request->requestor, False, 0, (XEvent*) &reply);
+}
+static void ResizeWindow(scythe::platform::Window* window, int width, int height)
+{
+	scythe::DesktopApplication* app = scythe::DesktopApplication::GetInstance();
+	scythe::WindowController* window_controller = app->GetWindowController();
+
+	window->base.width = width;
+	window->base.height = height;
+	window->base.aspect_ratio = static_cast<float>(width) / static_cast<float>(height);
+	if (window_controller)
+		window_controller->OnResize(width, height);
+}
+static void ProcessEvent(scythe::platform::Data* data, XEvent* event)
+{
+	scythe::DesktopApplication* desktop_app = scythe::DesktopApplication::GetInstance();
+	scythe::platform::Window* window = data->main_window;
+	scythe::KeyboardState& keyboard_state = desktop_app->GetKeyboardState();
+	scythe::MouseState& mouse_state = desktop_app->GetMouseState();
+	scythe::KeyboardController* keyboard_controller = desktop_app->GetKeyboardController();
+	scythe::MouseController* mouse_controller = desktop_app->GetMouseController();
+	scythe::WindowController* window_controller = desktop_app->GetWindowController();
+
+	// Input method may consume some key events
+	if (::XFilterEvent(event, None))
+		return;
+
+	// Clipboard requests are addressed to our window but not related to main window state
+	if (event->type == SelectionRequest)
+	{
+		::HandleSelectionRequest(data, &event->xselectionrequest);
+		return;
+	}
+
+	if (window == nullptr || event->xany.window != window->handle)
+		return;
+
+	switch (event->type)
+	{
+	case ClientMessage:
+		if (event->xclient.message_type == data->WM_PROTOCOLS &&
+			static_cast<Atom>(event->xclient.data.l[0]) == data->WM_DELETE_WINDOW)
+		{
+			desktop_app->Terminate();
+		}
+		break;
+
+	case FocusIn:
+		// Ignore focus events from grabs
+		if (event->xfocus.mode == NotifyGrab || event->xfocus.mode == NotifyUngrab)
+			break;
+		if (window->ic)
+			::XSetICFocus(window->ic);
+		window->base.active = true;
+		if (window_controller)
+			window_controller->OnGetFocus();
+		break;
+	case FocusOut:
+		if (event->xfocus.mode == NotifyGrab || event->xfocus.mode == NotifyUngrab)
+			break;
+		if (window->ic)
+			::XUnsetICFocus(window->ic);
+		window->base.active = false;
+		if (window_controller)
+			window_controller->OnLostFocus();
+		break;
+
+	case MapNotify:
+		window->base.visible = true;
+		break;
+	case UnmapNotify:
+		// Window is unmapped without Hide call only when it's been iconified
+		if (window->base.visible)
+		{
+			window->base.visible = false;
+			if (window_controller)
+				window_controller->OnMinimized();
+		}
+		break;
+
+	case ConfigureNotify:
+		if (!window->base.fullscreen)
+		{
+			window->windowed_x = event->xconfigure.x;
+			window->windowed_y = event->xconfigure.y;
+		}
+		if (event->xconfigure.width != window->base.width ||
+			event->xconfigure.height != window->base.height)
+		{
+			if (!window->base.fullscreen)
+			{
+				window->windowed_width = event->xconfigure.width;
+				window->windowed_height = event->xconfigure.height;
+			}
+			::ResizeWindow(window, event->xconfigure.width, event->xconfigure.height);
+		}
+		break;
+
+	case KeyPress:
+	{
+		const scythe::KeyboardKey translated_key = ::TranslateKey(event->xkey.keycode);
+		const scythe::KeyModifiers modifiers = ::TranslateKeyboardModifiers(event->xkey.state);
+
+		if (translated_key != scythe::KeyboardKey::kUnknown)
+		{
+			if (keyboard_controller)
+				keyboard_controller->OnKeyDown(translated_key, modifiers);
+
+			keyboard_state.SetKeyDown(translated_key, true);
+			keyboard_state.modifiers = modifiers;
+		}
+
+		::ProcessCharacters(window, &event->xkey);
+		break;
+	}
+	case KeyRelease:
+	{
+		const scythe::KeyboardKey translated_key = ::TranslateKey(event->xkey.keycode);
+		if (translated_key == scythe::KeyboardKey::kUnknown)
+			break;
+		const scythe::KeyModifiers modifiers = ::TranslateKeyboardModifiers(event->xkey.state);
+
+		if (keyboard_controller)
+			keyboard_controller->OnKeyUp(translated_key, modifiers);
+
+		keyboard_state.SetKeyDown(translated_key, false);
+		keyboard_state.modifiers = modifiers;
+		break;
+	}
+
+	case ButtonPress:
+	case ButtonRelease:
+	{
+		const bool down = (event->type == ButtonPress);
+		scythe::MouseButton button = scythe::MouseButton::kUnknown;
+		keyboard_state.modifiers = ::TranslateKeyboardModifiers(event->xbutton.state);
+		switch (event->xbutton.button)
+		{
+		case Button1: button = scythe::MouseButton::kLeft; break;
+		case Button2: button = scythe::MouseButton::kMiddle; break;
+		case Button3: button = scythe::MouseButton::kRight; break;
+		// Scroll is reported as buttons press
+		case Button4:
+			if (down && mouse_controller)
+				mouse_controller->OnScroll(0.0f, 1.0f);
+			break;
+		case Button5:
+			if (down && mouse_controller)
+				mouse_controller->OnScroll(0.0f, -1.0f);
+			break;
+		case 6:
+			if (down && mouse_controller)
+				mouse_controller->OnScroll(1.0f, 0.0f);
+			break;
+		case 7:
+			if (down && mouse_controller)
+				mouse_controller->OnScroll(-1.0f, 0.0f);
+			break;
+		}
+		if (button != scythe::MouseButton::kUnknown)
+		{
+			mouse_state.SetButtonDown(button, down);
+			if (mouse_controller)
+			{
+				if (down)
+					mouse_controller->OnMouseDown(button);
+				else
+					mouse_controller->OnMouseUp(button);
+			}
+		}
+		break;
+	}
+
+	case MotionNotify:
+	{
+		const int x = event->xmotion.x;
+		const int y = event->xmotion.y;
+		if (x != window->old_mouse_x || y != window->old_mouse_y)
+		{
+			mouse_state.delta_x = static_cast<float>(x - window->old_mouse_x);
+			mouse_state.delta_y = static_cast<float>(y - window->old_mouse_y);
+			window->old_mouse_x = x;
+			window->old_mouse_y = y;
+
+			mouse_state.x = static_cast<float>(x);
+			mouse_state.y = static_cast<float>(window->base.height - y - 1);
+			if (mouse_controller)
+				mouse_controller->OnMouseMove();
+		}
+		break;
+	}
+	}
+}
+static void ConfigureWindowSettings(scythe::platform::Window* window, scythe::DesktopApplication* app)
+{
+	int width = app->GetInitialWidth();
+	int height = app->GetInitialHeight();
+
+	// Base properties
+	window->base.width = width;
+	window->base.height = height;
+	window->base.aspect_ratio = static_cast<float>(width) / static_cast<float>(height);
+	window->base.active = true;
+	window->base.visible = false;
+	window->base.fullscreen = false;
+
+	window->handle = 0;
+	window->colormap = 0;
+	window->ic = nullptr;
+	window->title = app->GetInitialTitle();
+	window->windowed_x = 0;
+	window->windowed_y = 0;
+	window->windowed_width = width;
+	window->windowed_height = height;
+	window->old_mouse_x = 0;
+	window->old_mouse_y = 0;
+	window->cursor_hidden = false;
+#ifdef SCYTHE_USE_OPENGL
+	window->context.fbconfig = nullptr;
+	window->context.handle = nullptr;
+#endif
+}
+static void ChooseVisual(scythe::platform::Data* data, Visual** visual, int* depth)
+{
+	*visual = DefaultVisual(data->display, data->screen);
+	*depth = DefaultDepth(data->display, data->screen);
+
+#ifdef SCYTHE_USE_OPENGL
+	// Visual should match GLX framebuffer configuration
+	scythe::DesktopApplication* app = scythe::DesktopApplication::GetInstance();
+	scythe::GraphicsProvider* graphics_provider = app->GetGraphicsProvider();
+	scythe::LibraryGLX* glx = scythe::LibraryGLX::GetInstance();
+	if (!glx->Initialize())
+		return;
+
+	scythe::OpenGLFramebufferConfiguration fb_config;
+	fb_config.red_bits = graphics_provider->GetRedBits();
+	fb_config.green_bits = graphics_provider->GetGreenBits();
+	fb_config.blue_bits = graphics_provider->GetBlueBits();
+	fb_config.alpha_bits = graphics_provider->GetAlphaBits();
+	fb_config.depth_bits = graphics_provider->GetDepthBits();
+	fb_config.stencil_bits = graphics_provider->GetStencilBits();
+	fb_config.accum_red_bits = 0;
+	fb_config.accum_green_bits = 0;
+	fb_config.accum_blue_bits = 0;
+	fb_config.accum_alpha_bits = 0;
+	fb_config.aux_buffers = 0;
+	fb_config.samples = 0;
+	fb_config.stereo = false;
+	fb_config.sRGB = false;
+	fb_config.doublebuffer = true;
+	fb_config.transparent = false;
+
+	Visual* glx_visual;
+	int glx_depth;
+	if (glx->ChooseVisual(&fb_config, &glx_visual, &glx_depth))
+	{
+		*visual = glx_visual;
+		*depth = glx_depth;
+	}
+#endif
+}
+static void SetDecorations(scythe::platform::Data* data, scythe::platform::Window* window, bool decorated)
+{
+	// Motif hints are respected by most window managers
+	struct
+	{
+		unsigned long flags;
+		unsigned long functions;
+		unsigned long decorations;
+		long input_mode;
+		unsigned long status;
+	} hints;
+	std::memset(&hints, 0, sizeof(hints));
+	hints.flags = 2; // MWM_HINTS_DECORATIONS
+	hints.decorations = decorated ? 1 : 0; // MWM_DECOR_ALL
+
+	::XChangeProperty(data->display, window->handle, data->MOTIF_WM_HINTS, data->MOTIF_WM_HINTS, 32,
+		PropModeReplace, (unsigned char*) &hints, sizeof(hints) / sizeof(long));
+}
+static void SetSizeHints(scythe::platform::Data* data, scythe::platform::Window* window, bool resizable)
+{
+	XSizeHints* hints = ::XAllocSizeHints();
+	if (!resizable)
+	{
+		hints->flags |= (PMinSize | PMaxSize);
+		hints->min_width = hints->max_width = window->base.width;
+		hints->min_height = hints->max_height = window->base.height;
+	}
+	::XSetWMNormalHints(data->display, window->handle, hints);
+	::XFree(hints);
+}
+static void SetFullscreenState(scythe::platform::Data* data, scythe::platform::Window* window, bool fullscreen)
+{
+	XWindowAttributes attributes;
+	::XGetWindowAttributes(data->display, window->handle, &attributes);
+	if (attributes.map_state == IsUnmapped)
+	{
+		// Window manager reads the state on mapping
+		if (fullscreen)
+			::XChangeProperty(data->display, window->handle, data->NET_WM_STATE, XA_ATOM, 32,
+				PropModeReplace, (unsigned char*) &data->NET_WM_STATE_FULLSCREEN, 1);
+		else
+			::XDeleteProperty(data->display, window->handle, data->NET_WM_STATE);
+		return;
+	}
+
+	XEvent event;
+	std::memset(&event, 0, sizeof(event));
+	event.type = ClientMessage;
+	event.xclient.window = window->handle;
+	event.xclient.format = 32;
+	event.xclient.message_type = data->NET_WM_STATE;
+	event.xclient.data.l[0] = fullscreen ? 1 : 0; // _NET_WM_STATE_ADD : _NET_WM_STATE_REMOVE
+	event.xclient.data.l[1] = static_cast<long>(data->NET_WM_STATE_FULLSCREEN);
+	event.xclient.data.l[2] = 0;
+	event.xclient.data.l[3] = 1; // source is normal application
+
+	::XSendEvent(data->display, data->root, False,
+		SubstructureNotifyMask | SubstructureRedirectMask, &event);
+	::XFlush(data->display);
+}
+static bool WaitForEvent(scythe::platform::Data* data, int timeout)
+{
+	struct pollfd fd = { ConnectionNumber(data->display), POLLIN, 0 };
+	return ::poll(&fd, 1, timeout) > 0;
+}
+
+namespace scythe {
+
+	const BaseWindow* GetBaseWindow(const Application* app)
+	{
+		const platform::Window* window = platform::GetWindow(app);
+		return &window->base;
+	}
+
+	namespace platform {
+
+		Data* CreateData()
+		{
+			Data* data = new Data();
+			data->display = nullptr;
+			data->screen = 0;
+			data->root = 0;
+			data->im = nullptr;
+			data->hidden_cursor = 0;
+			data->main_window = nullptr;
+			return data;
+		}
+		void DestroyData(Data* data)
+		{
+			delete data;
+		}
+		Data* GetData(Application* app)
+		{
+			return reinterpret_cast<Data*>(app->platform_data_);
+		}
+		const Data* GetData(const Application* app)
+		{
+			return reinterpret_cast<const Data*>(app->platform_data_);
+		}
+		const Window* GetWindow(const Application* app)
+		{
+			const Data* data = GetData(app);
+			return data->main_window;
+		}
+
+		bool Initialize()
+		{
+			Application* app = Application::GetInstance();
+			Data* data = GetData(app);
+
+			data->display = ::XOpenDisplay(NULL);
+			if (!data->display)
+			{
+				Error("Failed to open X display");
+				return false;
+			}
+			data->screen = DefaultScreen(data->display);
+			data->root = RootWindow(data->display, data->screen);
+
+			// Atoms
+			data->WM_PROTOCOLS = ::XInternAtom(data->display, "WM_PROTOCOLS", False);
+			data->WM_DELETE_WINDOW = ::XInternAtom(data->display, "WM_DELETE_WINDOW", False);
+			data->NET_WM_NAME = ::XInternAtom(data->display, "_NET_WM_NAME", False);
+			data->NET_WM_ICON_NAME = ::XInternAtom(data->display, "_NET_WM_ICON_NAME", False);
+			data->NET_WM_STATE = ::XInternAtom(data->display, "_NET_WM_STATE", False);
+			data->NET_WM_STATE_FULLSCREEN = ::XInternAtom(data->display, "_NET_WM_STATE_FULLSCREEN", False);
+			data->MOTIF_WM_HINTS = ::XInternAtom(data->display, "_MOTIF_WM_HINTS", False);
+			data->UTF8_STRING = ::XInternAtom(data->display, "UTF8_STRING", False);
+			data->CLIPBOARD = ::XInternAtom(data->display, "CLIPBOARD", False);
+			data->TARGETS = ::XInternAtom(data->display, "TARGETS", False);
+			data->SCYTHE_SELECTION = ::XInternAtom(data->display, "SCYTHE_SELECTION", False);
+
+			// Don't send release events for key auto repeat
+			Bool supported;
+			::XkbSetDetectableAutoRepeat(data->display, True, &supported);
+
+			// Input method for characters input
+			::XSetLocaleModifiers("");
+			data->im = ::XOpenIM(data->display, 0, NULL, NULL);
+
+			// Invisible cursor to hide the cursor
+			{
+				char bitmap_data[1] = { 0 };
+				XColor color;
+				std::memset(&color, 0, sizeof(color));
+				Pixmap bitmap = ::XCreateBitmapFromData(data->display, data->root, bitmap_data, 1, 1);
+				data->hidden_cursor = ::XCreatePixmapCursor(data->display, bitmap, bitmap, &color, &color, 0, 0);
+				::XFreePixmap(data->display, bitmap);
+			}
+
+			return true;
+		}
+		void Deinitialize()
+		{
+			Application* app = Application::GetInstance();
+			Data* data = GetData(app);
+
+			if (!data->display)
+				return;
+
+			if (data->hidden_cursor)
+			{
+				::XFreeCursor(data->display, data->hidden_cursor);
+				data->hidden_cursor = 0;
+			}
+			if (data->im)
+			{
+				::XCloseIM(data->im);
+				data->im = nullptr;
+			}
+			::XCloseDisplay(data->display);
+			data->display = nullptr;
+		}
+
+		void PollEvents()
+		{
+			Application* app = Application::GetInstance();
+			Data* data = GetData(app);
+
+			// XPending flushes requests and reads everything available from the connection
+			// once without blocking. Queued events are drained then without any I/O.
+			int count = ::XPending(data->display);
+			while (count > 0)
+			{
+				while (count-- > 0)
+				{
+					XEvent event;
+					::XNextEvent(data->display, &event);
+					::ProcessEvent(data, &event);
+				}
+				count = ::XEventsQueued(data->display, QueuedAlready);
+			}
+			::XFlush(data->display);
+		}
+		void ChangeDirectoryToResources()
+		{
+			if (::chdir("..") != 0)
+				Error("Failed to change directory to resources");
+		}
+
+		// Window functions
+		namespace window {
+
+			bool Create()
+			{
+				DesktopApplication* app = DesktopApplication::GetInstance();
+				Data* data = GetData(app);
+
+				// Create window instance
+				Window* window = new Window();
+				data->main_window = window;
+
+				// Configure window size
+				::ConfigureWindowSettings(window, app);
+
+				Visual* visual;
+				int depth;
+				::ChooseVisual(data, &visual, &depth);
+
+				window->colormap = ::XCreateColormap(data->display, data->root, visual, AllocNone);
+
+				XSetWindowAttributes wa;
+				std::memset(&wa, 0, sizeof(wa));
+				wa.colormap = window->colormap;
+				wa.border_pixel = 0;
+				wa.event_mask = kEventMask;
+
+				window->handle = ::XCreateWindow(data->display, data->root,
+					0, 0, window->base.width, window->base.height,
+					0,										// Border width
+					depth,									// Color depth
+					InputOutput,
+					visual,
+					CWBorderPixel | CWColormap | CWEventMask,
+					&wa);
+				if (!window->handle)
+				{
+					Error("XCreateWindow Failed!");
+					return false;
+				}
+
+				// Receive close button event instead of connection termination
+				::XSetWMProtocols(data->display, window->handle, &data->WM_DELETE_WINDOW, 1);
+
+				if (!app->IsDecorated())
+					::SetDecorations(data, window, false);
+				::SetSizeHints(data, window, app->IsResizable());
+
+				XClassHint* class_hint = ::XAllocClassHint();
+				class_hint->res_name = const_cast<char*>("scythe");
+				class_hint->res_class = const_cast<char*>("scythe");
+				::XSetClassHint(data->display, window->handle, class_hint);
+				::XFree(class_hint);
+
+				SetTitle(window->title.c_str());
+
+				// Input context for characters input
+				if (data->im)
+				{
+					window->ic = ::XCreateIC(data->im,
+						XNInputStyle, XIMPreeditNothing | XIMStatusNothing,
+						XNClientWindow, window->handle,
+						XNFocusWindow, window->handle,
+						NULL);
+					if (window->ic)
+					{
+						unsigned long filter = 0;
+						if (::XGetICValues(window->ic, XNFilterEvents, &filter, NULL) == NULL)
+							::XSelectInput(data->display, window->handle, kEventMask | filter);
+					}
+				}
+
+				// Enter fullscreen if necessary
+				if (app->IsInitialFullscreen())
+					MakeFullscreen();
+
+				return true;
+			}
+			void Destroy()
+			{
+				Application* app = Application::GetInstance();
+				Data* data = GetData(app);
+				Window* window = data->main_window;
+
+				if (!window)
+					return;
+
+				if (window->ic)
+				{
+					::XDestroyIC(window->ic);
+					window->ic = nullptr;
+				}
+				if (window->handle)
+				{
+					::XDestroyWindow(data->display, window->handle);
+					window->handle = 0;
+				}
+				if (window->colormap)
+				{
+					::XFreeColormap(data->display, window->colormap);
+					window->colormap = 0;
+				}
+				::XFlush(data->display);
+
+				delete window;
+				data->main_window = nullptr;
+			}
+			void Terminate()
+			{
+				// Emulate close button press to handle it the same way
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+
+				XEvent event;
+				std::memset(&event, 0, sizeof(event));
+				event.type = ClientMessage;
+				event.xclient.window = window->handle;
+				event.xclient.format = 32;
+				event.xclient.message_type = data->WM_PROTOCOLS;
+				event.xclient.data.l[0] = static_cast<long>(data->WM_DELETE_WINDOW);
+				::XSendEvent(data->display, window->handle, False, NoEventMask, &event);
+				::XFlush(data->display);
+			}
+
+			void ToggleFullscreen(void)
+			{
+				Window* window = ::GetMainWindow();
+				if (window->base.fullscreen) // fullscreen -> windowed
+				{
+					MakeWindowed();
+				}
+				else // windowed -> fullscreen
+				{
+					MakeFullscreen();
+				}
+			}
+			bool MakeFullscreen()
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+
+				if (window->base.fullscreen)
+					return true;
+
+				// Video mode isn't changed, so exclusive mode works like windowed fullscreen one.
+				// Window manager resizes window and new size comes with ConfigureNotify event.
+				window->base.fullscreen = true;
+				::SetFullscreenState(data, window, true);
+				return true;
+			}
+			void MakeWindowed()
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+
+				if (!window->base.fullscreen)
+					return;
+
+				window->base.fullscreen = false;
+				::SetFullscreenState(data, window, false);
+			}
+			void Center()
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+
+				// No need to center fullscreen window
+				if (window->base.fullscreen)
+					return;
+
+				int screen_width = DisplayWidth(data->display, data->screen);
+				int screen_height = DisplayHeight(data->display, data->screen);
+				window->windowed_x = (screen_width - window->base.width) / 2;
+				window->windowed_y = (screen_height - window->base.height) / 2;
+				::XMoveWindow(data->display, window->handle, window->windowed_x, window->windowed_y);
+				::XFlush(data->display);
+			}
+			void Resize(int width, int height)
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+				::XResizeWindow(data->display, window->handle, width, height);
+				::XFlush(data->display);
+			}
+			void Iconify()
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+				::XIconifyWindow(data->display, window->handle, data->screen);
+				::XFlush(data->display);
+			}
+			void Restore()
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+				::XMapRaised(data->display, window->handle);
+				::XFlush(data->display);
+			}
+			void Show()
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+				::XMapRaised(data->display, window->handle);
+				::XFlush(data->display);
+				window->base.visible = true;
+			}
+			void Hide()
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+				window->base.visible = false;
+				::XUnmapWindow(data->display, window->handle);
+				::XFlush(data->display);
+			}
+			bool IsVisible()
+			{
+				Window* window = ::GetMainWindow();
+				return window->base.visible;
+			}
+			void SetTitle(const wchar_t* title)
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+
+				window->title = title;
+				std::string utf8_title = ::WideToUtf8(title);
+
+				::Xutf8SetWMProperties(data->display, window->handle,
+					utf8_title.c_str(), utf8_title.c_str(), NULL, 0, NULL, NULL, NULL);
+				::XChangeProperty(data->display, window->handle, data->NET_WM_NAME, data->UTF8_STRING, 8,
+					PropModeReplace, (const unsigned char*) utf8_title.c_str(), (int) utf8_title.size());
+				::XChangeProperty(data->display, window->handle, data->NET_WM_ICON_NAME, data->UTF8_STRING, 8,
+					PropModeReplace, (const unsigned char*) utf8_title.c_str(), (int) utf8_title.size());
+				::XFlush(data->display);
+			}
+			std::wstring GetTitle()
+			{
+				Window* window = ::GetMainWindow();
+				return window->title;
+			}
+
+		} // namespace window
+
+		// Cursor operations
+		namespace cursor {
+
+			void GetPos(float* x, float* y)
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+				::Window root, child;
+				int root_x, root_y, child_x, child_y;
+				unsigned int mask;
+				::XQueryPointer(data->display, window->handle, &root, &child,
+					&root_x, &root_y, &child_x, &child_y, &mask);
+				if (x)
+					*x = static_cast<float>(child_x);
+				if (y)
+					*y = static_cast<float>(window->base.height - child_y - 1);
+			}
+			void SetPos(float x, float y)
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+				int pos_x = static_cast<int>(x);
+				int pos_y = static_cast<int>(window->base.height - y - 1);
+				::XWarpPointer(data->display, None, window->handle, 0, 0, 0, 0, pos_x, pos_y);
+				::XFlush(data->display);
+			}
+			void Center()
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+				::XWarpPointer(data->display, None, window->handle, 0, 0, 0, 0,
+					window->base.width / 2, window->base.height / 2);
+				::XFlush(data->display);
+			}
+			void Show()
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+				::XUndefineCursor(data->display, window->handle);
+				::XFlush(data->display);
+				window->cursor_hidden = false;
+			}
+			void Hide()
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+				::XDefineCursor(data->display, window->handle, data->hidden_cursor);
+				::XFlush(data->display);
+				window->cursor_hidden = true;
+			}
+
+		} // namespace cursor
+
+		// Clipboard operations
+		namespace clipboard {
+
+			void SetText(const char *text)
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+
+				// Text is sent on request from other clients
+				data->clipboard_string = text;
+				::XSetSelectionOwner(data->display, data->CLIPBOARD, window->handle, CurrentTime);
+				::XFlush(data->display);
+			}
+			std::string GetText()
+			{
+				Data* data = ::GetPlatformData();
+				Window* window = data->main_window;
+
+				if (::XGetSelectionOwner(data->display, data->CLIPBOARD) == window->handle)
+					return data->clipboard_string;
+
+				::XConvertSelection(data->display, data->CLIPBOARD, data->UTF8_STRING,
+					data->SCYTHE_SELECTION, window->handle, CurrentTime);
+				::XFlush(data->display);
+
+				// Wait for selection owner response
+				XEvent event;
+				bool received = false;
+				while (!received)
+				{
+					if (::XCheckTypedWindowEvent(data->display, window->handle, SelectionNotify, &event))
+						received = true;
+					else if (!::WaitForEvent(data, kSelectionTimeout))
+						break;
+				}
+				if (!received || event.xselection.property == None)
+					return std::string();
+
+				std::string result;
+				Atom actual_type;
+				int actual_format;
+				unsigned long item_count, bytes_after;
+				unsigned char* value = nullptr;
+				::XGetWindowProperty(data->display, window->handle, data->SCYTHE_SELECTION,
+					0, LONG_MAX, True, AnyPropertyType,
+					&actual_type, &actual_format, &item_count, &bytes_after, &value);
+				// Incremental transfer of large data isn't supported
+				if (value && (actual_type == data->UTF8_STRING || actual_type == XA_STRING))
+					result.assign(reinterpret_cast<const char*>(value), item_count);
+				if (value)
+					::XFree(value);
+				return result;
+			}
+
+		} // namespace clipboard
+
+	} // namespace platform
+} // namespace scythe
\ No newline at end of file
@@ -0,0 +1,313 @@
+#include <scythe/profiler.h>
+
+#include <scythe/log.h>
+#include <scythe/perf_counters.h>
+#include <scythe/clock.h>
+#include <scythe/memory_tracker.h>
+
+#include <atomic>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @brief      Writes string as quoted JSON string.
+ *
+ * @param      file    The file
+ * @param[in]  string  The string
+ */
+static void WriteJsonString(FILE* file, const char* string)
+{
+	std::fputc('"', file);
+	for (const char* c = string; *c != '\0'; ++c)
+	{
+		const unsigned char symbol = static_cast<unsigned char>(*c);
+		if (symbol == '"' || symbol == '\\')
+		{
+			std::fputc('\\', file);
+			std::fputc(symbol, file);
+		}
+		else if (symbol < 0x20)
+			std::fprintf(file, "\\u%04x", symbol);
+		else
+			std::fputc(symbol, file);
+	}
+	std::fputc('"', file);
+}
+
+namespace scythe {
+
+	/**
+	 * @brief      Completed zone.
+	 */
+	struct ProfileEvent
+	{
+		StringID name;
+		uint32_t depth;
+		uint64_t start;			//!< start timestamp in nanoseconds
+		uint64_t end;			//!< end timestamp in nanoseconds
+	};
+
+	/**
+	 * @brief      Per-thread profiler data.
+	 * @details    Single producer (owning thread) writes events and advances head.
+	 *             Consumer (exporter) may read it from any thread without locking
+	 *             and discards events that have been overwritten during reading.
+	 */
+	struct Profiler::ThreadData
+	{
+		uint32_t thread_id;
+		std::string name;
+
+		std::vector<ProfileEvent, TaggedStlAllocator<ProfileEvent, MemoryTag::kProfiler>> events; //!< ring buffer of kEventsPerThread events
+		std::atomic<uint64_t> head;						//!< total number of written events
+
+		// Active zones stack
+		std::atomic<StringID> stack_names[kMaxDepth];
+		uint64_t stack_starts[kMaxDepth];
+		std::atomic<uint32_t> depth;
+		uint32_t overflow;								//!< number of zones beyond maximum depth
+
+		// Performance counters (optional)
+		PerfCounters perf_counters;
+		bool perf_counters_tried;						//!< opening has been tried
+		std::vector<PerfCounterValues, TaggedStlAllocator<PerfCounterValues, MemoryTag::kProfiler>> event_counters; //!< counters deltas parallel to events ring
+		std::atomic<bool> has_counters;					//!< event counters are allocated
+		PerfCounterValues stack_counters[kMaxDepth];
+	};
+
+	static thread_local Profiler::ThreadData* s_thread_data = nullptr;
+
+	uint64_t Profiler::GetTimestamp()
+	{
+		return Clock::Now();
+	}
+	Profiler::Profiler()
+	: start_time_(GetTimestamp())
+	, perf_counters_enabled_(false)
+	{
+	}
+	Profiler::~Profiler()
+	{
+		for (ThreadData* data : threads_)
+			delete data;
+	}
+	Profiler::ThreadData* Profiler::CreateThreadData()
+	{
+		ThreadData* data = new ThreadData();
+		data->events.resize(kEventsPerThread);
+		data->head.store(0, std::memory_order_relaxed);
+		data->depth.store(0, std::memory_order_relaxed);
+		data->overflow = 0;
+		data->perf_counters_tried = false;
+		data->has_counters.store(false, std::memory_order_relaxed);
+		{
+			std::lock_guard<std::mutex> lock(threads_mutex_);
+			data->thread_id = static_cast<uint32_t>(threads_.size()) + 1u;
+			threads_.push_back(data);
+		}
+		return data;
+	}
+	Profiler::ThreadData* Profiler::GetThreadData()
+	{
+		ThreadData* data = s_thread_data;
+		if (data != nullptr)
+			return data;
+
+		// First zone on this thread, register it
+		data = CreateThreadData();
+		s_thread_data = data;
+		return data;
+	}
+	void Profiler::RegisterName(StringID id, const char* name)
+	{
+		std::lock_guard<std::mutex> lock(names_mutex_);
+		auto it = names_.find(id);
+		if (it == names_.end())
+			names_.emplace(id, name);
+		else if (std::strcmp(it->second, name) != 0)
+			Error("Profiler: zone names \"%s\" and \"%s\" have the same ID", it->second, name);
+	}
+	void Profiler::BeginZone(StringID id)
+	{
+		ThreadData* data = GetThreadData();
+		uint32_t depth = data->depth.load(std::memory_order_relaxed);
+		if (depth == kMaxDepth)
+		{
+			++data->overflow;
+			return;
+		}
+		data->stack_names[depth].store(id, std::memory_order_relaxed);
+		if (perf_counters_enabled_.load(std::memory_order_relaxed))
+		{
+			if (!data->perf_counters_tried)
+			{
+				// Open counters on the owning thread, ring memory is allocated only for them
+				data->perf_counters_tried = true;
+				if (data->perf_counters.Open())
+				{
+					data->event_counters.resize(kEventsPerThread, PerfCounterValues());
+					data->has_counters.store(true, std::memory_order_release);
+				}
+			}
+			data->perf_counters.Read(&data->stack_counters[depth]);
+		}
+		data->stack_starts[depth] = GetTimestamp();
+		data->depth.store(depth + 1, std::memory_order_release);
+	}
+	void Profiler::EndZone()
+	{
+		const uint64_t end = GetTimestamp();
+		ThreadData* data = GetThreadData();
+		if (data->overflow != 0)
+		{
+			--data->overflow;
+			return;
+		}
+		uint32_t depth = data->depth.load(std::memory_order_relaxed);
+		if (depth == 0)
+			return;
+		--depth;
+
+		if (!data->event_counters.empty())
+		{
+			// Zones begun before opening counters have zero start values
+			PerfCounterValues values;
+			data->perf_counters.Read(&values);
+			const uint64_t head = data->head.load(std::memory_order_relaxed);
+			PerfCounters::Subtract(values, data->stack_counters[depth], &data->event_counters[head & (kEventsPerThread - 1)]);
+		}
+		AddEvent(data, data->stack_names[depth].load(std::memory_order_relaxed), depth, data->stack_starts[depth], end);
+		data->depth.store(depth, std::memory_order_release);
+	}
+	void Profiler::SetThreadName(const char* name)
+	{
+		ThreadData* data = GetThreadData();
+		std::lock_guard<std::mutex> lock(threads_mutex_);
+		data->name = name;
+	}
+	void Profiler::SetPerfCountersEnabled(bool enabled)
+	{
+		perf_counters_enabled_.store(enabled, std::memory_order_relaxed);
+	}
+	Profiler::ThreadData* Profiler::CreateTrack(const char* name)
+	{
+		ThreadData* data = CreateThreadData();
+		std::lock_guard<std::mutex> lock(threads_mutex_);
+		data->name = name;
+		return data;
+	}
+	void Profiler::AddEvent(ThreadData* track, StringID id, uint32_t depth, uint64_t start, uint64_t end)
+	{
+		uint64_t head = track->head.load(std::memory_order_relaxed);
+		ProfileEvent& event = track->events[head & (kEventsPerThread - 1)];
+		event.name = id;
+		event.depth = depth;
+		event.start = start;
+		event.end = end;
+		track->head.store(head + 1, std::memory_order_release);
+	}
+	uint32_t Profiler::GetZoneStack(const ThreadData* thread, StringID* ids, uint32_t max_count)
+	{
+		uint32_t depth = thread->depth.load(std::memory_order_acquire);
+		if (depth > max_count)
+			depth = max_count;
+		for (uint32_t i = 0; i < depth; ++i)
+			ids[i] = thread->stack_names[i].load(std::memory_order_relaxed);
+		return depth;
+	}
+	const char* Profiler::GetName(StringID id)
+	{
+		std::lock_guard<std::mutex> lock(names_mutex_);
+		auto it = names_.find(id);
+		return (it != names_.end()) ? it->second : nullptr;
+	}
+	bool Profiler::ExportChromeTrace(const char* filename)
+	{
+		FILE* file = std::fopen(filename, "w");
+		if (!file)
+		{
+			Error("Profiler: failed to open file %s", filename);
+			return false;
+		}
+
+		std::vector<ProfileEvent> events;
+		std::vector<PerfCounterValues> counters;
+		events.reserve(kEventsPerThread);
+
+		std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+		std::fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"scythe\"}}");
+
+		std::lock_guard<std::mutex> threads_lock(threads_mutex_);
+		std::lock_guard<std::mutex> names_lock(names_mutex_);
+		for (ThreadData* data : threads_)
+		{
+			if (!data->name.empty())
+			{
+				std::fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+					data->thread_id);
+				::WriteJsonString(file, data->name.c_str());
+				std::fprintf(file, "}}");
+			}
+
+			// Copy events that are still in the ring
+			const bool has_counters = data->has_counters.load(std::memory_order_acquire);
+			const uint64_t head = data->head.load(std::memory_order_acquire);
+			uint64_t first = (head > kEventsPerThread) ? head - kEventsPerThread : 0;
+			events.clear();
+			counters.clear();
+			for (uint64_t i = first; i < head; ++i)
+			{
+				events.push_back(data->events[i & (kEventsPerThread - 1)]);
+				if (has_counters)
+					counters.push_back(data->event_counters[i & (kEventsPerThread - 1)]);
+			}
+
+			// Drop the ones overwritten while copying. Writer may be filling
+			// the slot next to the head, so that one is considered overwritten too.
+			std::atomic_thread_fence(std::memory_order_acquire);
+			const uint64_t new_head = data->head.load(std::memory_order_relaxed);
+			uint64_t new_first = (new_head >= kEventsPerThread) ? new_head - kEventsPerThread + 1 : 0;
+			size_t skip = static_cast<size_t>(std::min<uint64_t>(new_first - std::min(new_first, first), events.size()));
+
+			for (size_t i = skip; i < events.size(); ++i)
+			{
+				const ProfileEvent& event = events[i];
+				auto it = names_.find(event.name);
+				const uint64_t start = (event.start > start_time_) ? event.start - start_time_ : 0;
+				const uint64_t duration = event.end - event.start;
+				if (it != names_.end())
+				{
+					std::fprintf(file, ",\n{\"name\":");
+					::WriteJsonString(file, it->second);
+				}
+				else
+					std::fprintf(file, ",\n{\"name\":\"0x%08X\"", event.name);
+				std::fprintf(file, ",\"cat\":\"zone\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+					data->thread_id, static_cast<double>(start) * 1e-3, static_cast<double>(duration) * 1e-3);
+				if (has_counters)
+				{
+					// Counters are shown as event arguments
+					const char* separator = "";
+					std::fprintf(file, ",\"args\":{");
+					for (int c = 0; c < PerfCounters::kNumCounters; ++c)
+					{
+						const PerfCounter counter = static_cast<PerfCounter>(c);
+						if (!data->perf_counters.IsAvailable(counter))
+							continue;
+						std::fprintf(file, "%s\"%s\":%llu", separator, PerfCounters::GetName(counter),
+							static_cast<unsigned long long>(counters[i].values[c]));
+						separator = ",";
+					}
+					std::fprintf(file, "}");
+				}
+				std::fprintf(file, "}");
+			}
+		}
+
+		std::fprintf(file, "\n]}\n");
+		std::fclose(file);
+		return true;
+	}
+
+} // namespace scythe
\ No newline at end of file
@@ -1,91 +1,320 @@
 #include <scythe/resource_manager.h>
 
 #include <scythe/defines.h>
+#include <scythe/profiler.h>
+#include <scythe/log.h>
+#include <scythe/clock.h>
+
+#include <atomic>
+#include <algorithm>
+#include <unordered_set>
+
+static constexpr float kDefaultFinalizeBudget = 0.004f;
+
+static constexpr uint32_t kIndexBits = 20;
+static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+static constexpr uint32_t kMaxGeneration = (1u << (32 - kIndexBits)) - 1;
+static constexpr uint32_t kNoSlot = UINT32_MAX;
 
 namespace scythe {
 
-	ResourceManager::ResourceManager()
-	: unique_resource_id_(0)
+	/**
+	 * Asynchronous loading of a single resource.
+	 */
+	struct ResourceManager::LoadJob
 	{
+		ResourceID id;
+		void* user_data;
+		ResourceLoadingTaskFunc task_func;
+		ResourceDiscardingFunc discarding_func;
+		std::atomic<bool> cancelled;	//!< task is skipped if it hasn't been started yet
+		bool skipped;
+		void* data;
+	};
 
+	ResourceManager::ResourceManager()
+	: free_slots_head_(kNoSlot)
+	, free_slots_tail_(kNoSlot)
+	, pending_count_(0)
+	, jobs_count_(0)
+	, finalize_budget_(Clock::FromSeconds(kDefaultFinalizeBudget))
+	, memory_budget_(0)
+	, memory_size_(0)
+	{
+		for (int i = 0; i < static_cast<int>(ResidencyPriority::kCount); ++i)
+		{
+			cache_head_[i] = kInvalidResourceID;
+			cache_tail_[i] = kInvalidResourceID;
+		}
 	}
 	ResourceManager::~ResourceManager()
 	{
+		// Cached resources aren't used by anyone
+		EvictCached(true);
+
 		// Debug check for all resources to be unloaded
-		for (auto& pair : container_)
+		for (ResourceInfo& info : container_)
 		{
-			ResourceInfo& info = pair.second;
 			SCYTHE_ASSERT(info.resource == nullptr);
+			if (info.job != nullptr)
+				info.job->cancelled.store(true, std::memory_order_relaxed);
+		}
+		// Workers finish their current tasks and skip the rest
+		thread_pool_.reset();
+		while (!completed_jobs_.empty())
+		{
+			LoadJob* job = completed_jobs_.front();
+			completed_jobs_.pop_front();
+			if (job->data != nullptr)
+				job->discarding_func(job->user_data, job->data);
+			delete job;
 		}
 	}
 	void ResourceManager::CleanUp()
 	{
-		for (auto& pair : container_)
+		// Unfinished job is discarded on completion, no new loading is started
+		for (ResourceInfo& info : container_)
+			if (info.job != nullptr)
+				info.job->cancelled.store(true, std::memory_order_relaxed);
+
+		// Resources are unloaded before their dependencies, so passes are repeated
+		// until every dependents chain is unloaded (graph has no cycles)
+		bool unloaded = true;
+		while (unloaded)
 		{
-			ResourceInfo& info = pair.second;
-			if (info.resource != nullptr)
+			unloaded = false;
+			for (size_t i = 0; i < container_.size(); ++i)
 			{
+				if (container_[i].resource == nullptr || CountLoaded(container_[i].dependents) != 0)
+					continue;
+				unloaded = true;
+				if (container_[i].cached)
+					RemoveCached(container_[i]);
 				// Unload resource
-				info.unloading_func(info.user_data, info.resource);
-				info.resource = nullptr;
+				container_[i].unloading_func(container_[i].user_data, container_[i].resource);
+				ResourceInfo& info = container_[i];
+				SetLoaded(info, nullptr);
+				// Queued identifier becomes stale and is skipped later
+				if (info.pending == Pending::kUnload)
+				{
+					info.pending = Pending::kNone;
+					--pending_count_;
+				}
 			}
 		}
 	}
 	ResourceID ResourceManager::RegisterResource(StringID string_id, void* user_data, ResourceLoadingFunc loading_func, ResourceUnloadingFunc unloading_func)
 	{
-		ResourceID id = unique_resource_id_++;
-		// Insert a new ID into container
-		ResourceInfo& info = container_[id];
+		// Name should identify a single resource
+		auto result = name_index_.emplace(string_id, kInvalidResourceID);
+		if (!result.second)
+		{
+			Error("Resource with name %u has been already registered", string_id);
+			return kInvalidResourceID;
+		}
+		// Take the oldest free slot or make a new one
+		uint32_t slot_index = free_slots_head_;
+		if (slot_index != kNoSlot)
+		{
+			free_slots_head_ = slots_[slot_index].index;
+			if (free_slots_head_ == kNoSlot)
+				free_slots_tail_ = kNoSlot;
+		}
+		else if (slots_.size() <= kIndexMask)
+		{
+			slot_index = static_cast<uint32_t>(slots_.size());
+			slots_.push_back(Slot{1, 0});
+		}
+		else
+		{
+			Error("Resources limit has been reached");
+			name_index_.erase(result.first);
+			return kInvalidResourceID;
+		}
+		Slot& slot = slots_[slot_index];
+		slot.index = static_cast<uint32_t>(container_.size());
+		const ResourceID id = (slot.generation << kIndexBits) | slot_index;
+		result.first->second = id;
+		// Insert a new resource into container
+		container_.emplace_back();
+		ResourceInfo& info = container_.back();
+		info.id = id;
 		info.counter = 0;
+		info.priority = 0;
+		info.pending = Pending::kNone;
 		info.string_id = string_id;
 		info.resource = nullptr;
 		info.user_data = user_data;
 		info.loading_func = loading_func;
 		info.unloading_func = unloading_func;
+		info.task_func = nullptr;
+		info.finalizing_func = nullptr;
+		info.discarding_func = nullptr;
+		info.job = nullptr;
+		info.size = 0;
+		info.residency = ResidencyPriority::kNormal;
+		info.cached = false;
+		info.cache_prev = kInvalidResourceID;
+		info.cache_next = kInvalidResourceID;
+		return id;
+	}
+	ResourceID ResourceManager::RegisterAsyncResource(StringID string_id, void* user_data, ResourceLoadingTaskFunc task_func,
+		ResourceFinalizingFunc finalizing_func, ResourceDiscardingFunc discarding_func, ResourceUnloadingFunc unloading_func)
+	{
+		ResourceID id = RegisterResource(string_id, user_data, nullptr, unloading_func);
+		if (id != kInvalidResourceID)
+		{
+			ResourceInfo& info = *Find(id);
+			info.task_func = task_func;
+			info.finalizing_func = finalizing_func;
+			info.discarding_func = discarding_func;
+		}
 		return id;
 	}
+	bool ResourceManager::AddDependency(ResourceID id, ResourceID dependency_id)
+	{
+		ResourceInfo* info_pointer = Find(id);
+		ResourceInfo* dependency_info = Find(dependency_id);
+		if (info_pointer == nullptr || dependency_info == nullptr)
+		{
+			SCYTHE_ASSERT(!"Resource hasn't been registered yet");
+			return false;
+		}
+		if (id == dependency_id || DependsOn(dependency_id, id))
+		{
+			Error("Dependency of resource %u on %u makes a cycle", info_pointer->string_id, dependency_info->string_id);
+			return false;
+		}
+		ResourceInfo& info = *info_pointer;
+		info.dependencies.push_back(dependency_id);
+		dependency_info->dependents.push_back(id);
+		// Requested resource holds its dependencies
+		if (info.counter > 0)
+			RequestLoad(dependency_id, info.priority);
+		UpdatePending(id, info);
+		return true;
+	}
+	size_t ResourceManager::RegisterResources(const ResourceDescription* descriptions, size_t count, ResourceID* ids)
+	{
+		// Containers are grown once for the whole batch
+		container_.reserve(container_.size() + count);
+		slots_.reserve(slots_.size() + count);
+		name_index_.reserve(name_index_.size() + count);
+		size_t registered = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const ResourceDescription& description = descriptions[i];
+			ids[i] = RegisterResource(description.string_id, description.user_data,
+				description.loading_func, description.unloading_func);
+			if (ids[i] != kInvalidResourceID)
+				++registered;
+		}
+		return registered;
+	}
 	void ResourceManager::UnregisterResource(ResourceID id)
 	{
-		auto it = container_.find(id);
-		if (it != container_.end())
+		ResourceInfo* info_pointer = Find(id);
+		if (info_pointer != nullptr && info_pointer->cached)
+		{
+			// Cached resource is unused, so it's unloaded right away
+			RemoveCached(*info_pointer);
+			info_pointer->unloading_func(info_pointer->user_data, info_pointer->resource);
+			info_pointer = Find(id);
+			SetLoaded(*info_pointer, nullptr);
+		}
+		if (info_pointer != nullptr)
 		{
-			ResourceInfo& info = it->second;
+			ResourceInfo& info = *info_pointer;
 			SCYTHE_ASSERT(info.resource == nullptr);
+			// Queued identifier becomes stale and is skipped later
+			if (info.pending != Pending::kNone)
+				--pending_count_;
+			// Unfinished job is discarded on completion
+			if (info.job != nullptr)
+				info.job->cancelled.store(true, std::memory_order_relaxed);
+			// Remove resource from the graph
+			const bool requested = info.counter > 0;
+			DependencyList dependencies, dependents;
+			dependencies.swap(info.dependencies);
+			dependents.swap(info.dependents);
+			name_index_.erase(info.string_id);
+			// The last resource is moved into the hole
+			Slot& slot = slots_[id & kIndexMask];
+			const uint32_t index = slot.index;
+			if (index + 1 != container_.size())
+			{
+				container_[index] = std::move(container_.back());
+				slots_[container_[index].id & kIndexMask].index = index;
+			}
+			container_.pop_back();
+			// Slot generation is changed to make its identifiers stale
+			slot.generation = (slot.generation == kMaxGeneration) ? 1 : slot.generation + 1;
+			slot.index = kNoSlot;
+			if (free_slots_tail_ != kNoSlot)
+				slots_[free_slots_tail_].index = id & kIndexMask;
+			else
+				free_slots_head_ = id & kIndexMask;
+			free_slots_tail_ = id & kIndexMask;
+			for (ResourceID dependency_id : dependencies)
+			{
+				DependencyList& list = Find(dependency_id)->dependents;
+				list.erase(std::find(list.begin(), list.end(), id));
+				if (requested)
+					RequestUnload(dependency_id);
+			}
+			for (ResourceID dependent_id : dependents)
+			{
+				DependencyList& list = Find(dependent_id)->dependencies;
+				list.erase(std::find(list.begin(), list.end(), id));
+			}
+			UpdatePending(dependencies);
+			UpdatePending(dependents);
 		}
-		container_.erase(it);
 	}
 	ResourceID ResourceManager::GetResourceIdByName(StringID string_id)
 	{
-		for (auto& pair : container_)
-		{
-			ResourceInfo& info = pair.second;
-			if (info.string_id == string_id)
-				return pair.first;
-		}
+		auto it = name_index_.find(string_id);
+		if (it != name_index_.end())
+			return it->second;
 		SCYTHE_ASSERT(!"Resource hasn't been registered yet");
-		return -1;
+		return kInvalidResourceID;
 	}
-	Resource * ResourceManager::GetResource(ResourceID id)
+	size_t ResourceManager::GetResourceIdsByNames(const StringID* string_ids, size_t count, ResourceID* ids)
 	{
-		auto it = container_.find(id);
-		if (it != container_.end())
+		size_t found = 0;
+		for (size_t i = 0; i < count; ++i)
 		{
-			ResourceInfo& info = it->second;
-			return info.resource;
+			auto it = name_index_.find(string_ids[i]);
+			ids[i] = (it != name_index_.end()) ? it->second : kInvalidResourceID;
+			if (it != name_index_.end())
+				++found;
 		}
+		return found;
+	}
+	Resource * ResourceManager::GetResource(ResourceID id)
+	{
+		ResourceInfo* info = Find(id);
+		if (info != nullptr)
+			return info->resource;
 		else
 		{
 			SCYTHE_ASSERT(!"Resource hasn't been registered yet");
 			return nullptr;
 		}
 	}
-	void ResourceManager::RequestLoad(ResourceID id)
+	void ResourceManager::RequestLoad(ResourceID id, int priority)
 	{
-		auto it = container_.find(id);
-		if (it != container_.end())
+		ResourceInfo* info_pointer = Find(id);
+		if (info_pointer != nullptr)
 		{
-			ResourceInfo& info = it->second;
+			ResourceInfo& info = *info_pointer;
 			++info.counter;
+			info.priority = priority;
+			// The first request holds dependencies
+			if (info.counter == 1)
+				for (ResourceID dependency_id : info.dependencies)
+					RequestLoad(dependency_id, priority);
+			UpdatePending(id, info);
 		}
 		else
 		{
@@ -94,11 +323,16 @@ namespace scythe {
 	}
 	void ResourceManager::RequestUnload(ResourceID id)
 	{
-		auto it = container_.find(id);
-		if (it != container_.end())
+		ResourceInfo* info_pointer = Find(id);
+		if (info_pointer != nullptr)
 		{
-			ResourceInfo& info = it->second;
+			ResourceInfo& info = *info_pointer;
 			--info.counter;
+			UpdatePending(id, info);
+			// The last request releases dependencies
+			if (info.counter == 0)
+				for (ResourceID dependency_id : info.dependencies)
+					RequestUnload(dependency_id);
 		}
 		else
 		{
@@ -107,61 +341,384 @@ namespace scythe {
 	}
 	void ResourceManager::Perform()
 	{
-		for (auto& pair : container_)
+		SCYTHE_PROFILE_SCOPE("ResourceManager::Perform");
+		EvictCached(false);
+		if (unload_queue_.empty() && load_queue_.empty() && jobs_count_ == 0)
+			return;
+
+		// Unloading goes first to free memory for loaded resources.
+		// Failed loads are retried on the next call like before.
+		// Synchronous loading runs in parallel with asynchronous one.
+		std::deque<ResourceID> failed_queue;
+		for (;;)
 		{
-			ResourceInfo& info = pair.second;
-			if (info.counter == 0 && info.resource != nullptr)
+			while (ProcessPending(unload_queue_, Pending::kUnload, nullptr) ||
+				ProcessPending(load_queue_, Pending::kLoad, &failed_queue))
 			{
-				// Unload resource
-				info.unloading_func(info.user_data, info.resource);
-				info.resource = nullptr;
 			}
-			else if (info.counter > 0 && info.resource == nullptr)
+			if (jobs_count_ == 0)
+				break;
+			FinishLoadJob(PopCompletedJob(true));
+		}
+		load_queue_.swap(failed_queue);
+	}
+	bool ResourceManager::PerformStep()
+	{
+		EvictCached(false);
+		if (ProcessPending(unload_queue_, Pending::kUnload, nullptr))
+			return false;
+		if (ProcessPending(load_queue_, Pending::kLoad, &load_queue_))
+			return false;
+		if (jobs_count_ != 0)
+		{
+			LoadJob* job = PopCompletedJob(false);
+			if (job != nullptr)
+				FinishLoadJob(job);
+			return false;
+		}
+		return true;
+	}
+	void ResourceManager::Update()
+	{
+		EvictCached(false);
+		if (jobs_count_ == 0)
+			return;
+
+		SCYTHE_PROFILE_SCOPE("ResourceManager::Update");
+		const uint64_t start = Clock::Now();
+		do
+		{
+			LoadJob* job = PopCompletedJob(false);
+			if (job == nullptr)
+				break;
+			FinishLoadJob(job);
+		}
+		while (Clock::Now() - start < finalize_budget_);
+	}
+	void ResourceManager::SetFinalizeBudget(float seconds)
+	{
+		finalize_budget_ = Clock::FromSeconds(seconds);
+	}
+	void ResourceManager::SetMemoryBudget(size_t size)
+	{
+		// Resources over the new budget are evicted on the next update
+		memory_budget_ = size;
+	}
+	void ResourceManager::SetResidencyPriority(ResourceID id, ResidencyPriority priority)
+	{
+		ResourceInfo* info = Find(id);
+		if (info == nullptr)
+		{
+			SCYTHE_ASSERT(!"Resource hasn't been registered yet");
+			return;
+		}
+		if (info->cached)
+		{
+			RemoveCached(*info);
+			info->residency = priority;
+			InsertCached(*info);
+		}
+		else
+			info->residency = priority;
+	}
+	size_t ResourceManager::GetMemorySize() const
+	{
+		return memory_size_;
+	}
+	int ResourceManager::GetResourcesCountToProcess()
+	{
+		return pending_count_ + jobs_count_;
+	}
+	ResourceManager::ResourceInfo* ResourceManager::Find(ResourceID id)
+	{
+		const uint32_t slot_index = id & kIndexMask;
+		if (slot_index >= slots_.size())
+			return nullptr;
+		const Slot& slot = slots_[slot_index];
+		if (slot.generation != (id >> kIndexBits) || slot.index == kNoSlot)
+			return nullptr;
+		return &container_[slot.index];
+	}
+	void ResourceManager::UpdatePending(ResourceID id, ResourceInfo& info)
+	{
+		if (info.job != nullptr)
+		{
+			// Loading is cancelled until the job has started and resumed by a new request
+			info.job->cancelled.store(info.counter <= 0, std::memory_order_relaxed);
+			return;
+		}
+
+		// Requested cached resource is used again without loading
+		if (info.counter > 0 && info.cached)
+			RemoveCached(info);
+
+		// Resource waits for its dependencies to load and dependents to unload
+		Pending needed = Pending::kNone;
+		if (info.counter > 0 && info.resource == nullptr)
+		{
+			if (CountLoaded(info.dependencies) == info.dependencies.size())
+				needed = Pending::kLoad;
+		}
+		else if (info.counter <= 0 && info.resource != nullptr && CountLoaded(info.dependents) == 0)
+		{
+			// Unused resource is either unloaded or cached until eviction.
+			// Cached one is left to eviction even if budget has been reset.
+			if (!info.cached)
+			{
+				if (memory_budget_ == 0)
+					needed = Pending::kUnload;
+				else
+					InsertCached(info);
+			}
+		}
+		if (needed == Pending::kLoad && info.task_func != nullptr)
+		{
+			// Asynchronous loading isn't queued, job tracks it instead
+			StartLoadJob(id, info);
+			needed = Pending::kNone;
+		}
+		if (needed == info.pending)
+			return;
+
+		// Identifier of cancelled action stays in its queue and is skipped later
+		if (info.pending != Pending::kNone)
+			--pending_count_;
+		if (needed != Pending::kNone)
+		{
+			++pending_count_;
+			if (needed == Pending::kLoad)
+				load_queue_.push_back(id);
+			else
+				unload_queue_.push_back(id);
+		}
+		info.pending = needed;
+	}
+	void ResourceManager::UpdatePending(const DependencyList& ids)
+	{
+		for (ResourceID id : ids)
+			UpdatePending(id, *Find(id));
+	}
+	size_t ResourceManager::CountLoaded(const DependencyList& ids)
+	{
+		size_t count = 0;
+		for (ResourceID id : ids)
+			if (Find(id)->resource != nullptr)
+				++count;
+		return count;
+	}
+	bool ResourceManager::DependsOn(ResourceID id, ResourceID dependency_id)
+	{
+		// Depth-first search visiting shared dependencies once
+		std::vector<ResourceID> stack(1, id);
+		std::unordered_set<ResourceID> visited;
+		while (!stack.empty())
+		{
+			const ResourceID current_id = stack.back();
+			stack.pop_back();
+			for (ResourceID direct_id : Find(current_id)->dependencies)
 			{
-				// Load resource
-				ResourceID id = pair.first;
-				info.resource = info.loading_func(info.user_data, id);
+				if (direct_id == dependency_id)
+					return true;
+				if (visited.insert(direct_id).second)
+					stack.push_back(direct_id);
 			}
 		}
+		return false;
 	}
-	bool ResourceManager::PerformStep()
+	bool ResourceManager::ProcessPending(std::deque<ResourceID>& queue, Pending action, std::deque<ResourceID>* failed_queue)
 	{
-		for (auto& pair : container_)
+		while (!queue.empty())
 		{
-			ResourceInfo& info = pair.second;
-			if (info.counter == 0 && info.resource != nullptr)
+			const ResourceID id = queue.front();
+			queue.pop_front();
+			ResourceInfo* info_pointer = Find(id);
+			if (info_pointer == nullptr || info_pointer->pending != action)
+				continue; // stale
+
+			info_pointer->pending = Pending::kNone;
+			--pending_count_;
+			// Functions may register resources, so info is found again after them
+			if (action == Pending::kUnload)
 			{
-				// Unload resource
-				info.unloading_func(info.user_data, info.resource);
-				info.resource = nullptr;
-				return false;
+				// Resource may have been unloaded by eviction or clean up in the meantime
+				if (info_pointer->resource != nullptr)
+				{
+					// Unload resource
+					info_pointer->unloading_func(info_pointer->user_data, info_pointer->resource);
+					info_pointer = Find(id);
+					SetLoaded(*info_pointer, nullptr);
+					UpdatePending(info_pointer->dependencies);
+				}
 			}
-			else if (info.counter > 0 && info.resource == nullptr)
+			else
 			{
 				// Load resource
-				ResourceID id = pair.first;
-				info.resource = info.loading_func(info.user_data, id);
-				return false;
+				Resource* resource = info_pointer->loading_func(info_pointer->user_data, id);
+				info_pointer = Find(id);
+				SetLoaded(*info_pointer, resource);
+				if (resource != nullptr)
+					UpdatePending(info_pointer->dependents);
 			}
+			ResourceInfo& info = *info_pointer;
+			if (info.resource == nullptr && info.counter > 0 && failed_queue != nullptr)
+			{
+				// Loading has failed, so it's tried again later
+				info.pending = Pending::kLoad;
+				++pending_count_;
+				failed_queue->push_back(id);
+			}
+			else
+				UpdatePending(id, info);
+			return true;
 		}
-		return true;
+		return false;
 	}
-	int ResourceManager::GetResourcesCountToProcess()
+	void ResourceManager::StartLoadJob(ResourceID id, ResourceInfo& info)
 	{
-		int count = 0;
-		for (auto& pair : container_)
+		if (!thread_pool_)
+			thread_pool_.reset(new ThreadPool(0, "ResourceLoader"));
+
+		LoadJob* job = new LoadJob();
+		job->id = id;
+		job->user_data = info.user_data;
+		job->task_func = info.task_func;
+		job->discarding_func = info.discarding_func;
+		job->cancelled.store(false, std::memory_order_relaxed);
+		job->skipped = false;
+		job->data = nullptr;
+		info.job = job;
+		++jobs_count_;
+
+		thread_pool_->Submit([this, job]()
 		{
-			ResourceInfo& info = pair.second;
-			if (info.counter == 0 && info.resource != nullptr)
+			if (job->cancelled.load(std::memory_order_relaxed))
+				job->skipped = true;
+			else
 			{
-				++count;
+				SCYTHE_PROFILE_SCOPE("ResourceLoadingTask");
+				job->data = job->task_func(job->user_data, job->id);
 			}
-			else if (info.counter > 0 && info.resource == nullptr)
 			{
-				++count;
+				std::lock_guard<std::mutex> lock(completed_mutex_);
+				completed_jobs_.push_back(job);
 			}
+			completed_condition_.notify_one();
+		}, info.priority);
+	}
+	ResourceManager::LoadJob* ResourceManager::PopCompletedJob(bool wait)
+	{
+		std::unique_lock<std::mutex> lock(completed_mutex_);
+		if (wait)
+			completed_condition_.wait(lock, [this]{ return !completed_jobs_.empty(); });
+		else if (completed_jobs_.empty())
+			return nullptr;
+		LoadJob* job = completed_jobs_.front();
+		completed_jobs_.pop_front();
+		return job;
+	}
+	void ResourceManager::FinishLoadJob(LoadJob* job)
+	{
+		--jobs_count_;
+		ResourceInfo* info_pointer = Find(job->id);
+		if (info_pointer == nullptr)
+		{
+			// Resource has been unregistered
+			if (job->data != nullptr)
+				job->discarding_func(job->user_data, job->data);
+			delete job;
+			return;
+		}
+
+		// Functions may register resources, so info is found again after them
+		info_pointer->job = nullptr;
+		if (job->cancelled.load(std::memory_order_relaxed))
+		{
+			// Loading has been cancelled by clean up or release, a new request restarts it
+			if (job->data != nullptr)
+				job->discarding_func(job->user_data, job->data);
+		}
+		else if (info_pointer->counter <= 0 || job->skipped ||
+			CountLoaded(info_pointer->dependencies) != info_pointer->dependencies.size())
+		{
+			// Loading has been cancelled, skipped job is restarted if it's been requested again.
+			// Job is also restarted if dependencies have been unloaded in the meantime.
+			if (job->data != nullptr)
+				job->discarding_func(job->user_data, job->data);
+			UpdatePending(job->id, *Find(job->id));
+		}
+		else if (job->data == nullptr)
+		{
+			// Failed loading is retried on the next request only
+			Error("Failed to load resource %u", info_pointer->string_id);
+		}
+		else
+		{
+			SCYTHE_PROFILE_SCOPE("ResourceFinalizing");
+			Resource* resource = info_pointer->finalizing_func(info_pointer->user_data, job->id, job->data);
+			info_pointer = Find(job->id);
+			SetLoaded(*info_pointer, resource);
+			if (resource == nullptr)
+				Error("Failed to finalize resource %u", info_pointer->string_id);
+			else
+				UpdatePending(info_pointer->dependents);
+		}
+		delete job;
+	}
+	void ResourceManager::SetLoaded(ResourceInfo& info, Resource* resource)
+	{
+		memory_size_ -= info.size;
+		info.resource = resource;
+		info.size = (resource != nullptr) ? resource->GetSize() : 0;
+		memory_size_ += info.size;
+	}
+	void ResourceManager::InsertCached(ResourceInfo& info)
+	{
+		// The most recently used resource goes to the tail
+		const int residency = static_cast<int>(info.residency);
+		info.cached = true;
+		info.cache_prev = cache_tail_[residency];
+		info.cache_next = kInvalidResourceID;
+		if (cache_tail_[residency] != kInvalidResourceID)
+			Find(cache_tail_[residency])->cache_next = info.id;
+		else
+			cache_head_[residency] = info.id;
+		cache_tail_[residency] = info.id;
+	}
+	void ResourceManager::RemoveCached(ResourceInfo& info)
+	{
+		const int residency = static_cast<int>(info.residency);
+		if (info.cache_prev != kInvalidResourceID)
+			Find(info.cache_prev)->cache_next = info.cache_next;
+		else
+			cache_head_[residency] = info.cache_next;
+		if (info.cache_next != kInvalidResourceID)
+			Find(info.cache_next)->cache_prev = info.cache_prev;
+		else
+			cache_tail_[residency] = info.cache_prev;
+		info.cached = false;
+		info.cache_prev = kInvalidResourceID;
+		info.cache_next = kInvalidResourceID;
+	}
+	void ResourceManager::EvictCached(bool all)
+	{
+		while (all || memory_budget_ == 0 || memory_size_ > memory_budget_)
+		{
+			// Least recently used resource of the lowest priority is evicted first
+			int residency = 0;
+			while (residency < static_cast<int>(ResidencyPriority::kCount) && cache_head_[residency] == kInvalidResourceID)
+				++residency;
+			if (residency == static_cast<int>(ResidencyPriority::kCount))
+				break;
+
+			const ResourceID id = cache_head_[residency];
+			ResourceInfo* info = Find(id);
+			RemoveCached(*info);
+			info->unloading_func(info->user_data, info->resource);
+			info = Find(id);
+			SetLoaded(*info, nullptr);
+			// Dependencies may become cached in turn
+			UpdatePending(info->dependencies);
 		}
-		return count;
 	}
 
 } // namespace scythe
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include <scythe/thread_pool.h>
+
+#include <scythe/profiler.h>
+
+namespace scythe {
+
+	ThreadPool::ThreadPool(uint32_t threads_count, const char* name)
+	: sequence_(0)
+	, running_(true)
+	, name_(name)
+	{
+		if (threads_count == 0)
+		{
+			const uint32_t cores = std::thread::hardware_concurrency();
+			threads_count = (cores > 1) ? cores - 1 : 1;
+		}
+		threads_.reserve(threads_count);
+		for (uint32_t i = 0; i < threads_count; ++i)
+			threads_.emplace_back(&ThreadPool::ThreadFunc, this);
+	}
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			running_ = false;
+		}
+		condition_.notify_all();
+		for (std::thread& thread : threads_)
+			thread.join();
+	}
+	void ThreadPool::Submit(Task task, int priority)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			tasks_.push(Entry{priority, sequence_++, std::move(task)});
+		}
+		condition_.notify_one();
+	}
+	uint32_t ThreadPool::GetThreadsCount() const
+	{
+		return static_cast<uint32_t>(threads_.size());
+	}
+	void ThreadPool::ThreadFunc()
+	{
+		SCYTHE_PROFILE_THREAD(name_);
+		for (;;)
+		{
+			Task task;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				condition_.wait(lock, [this]{ return !tasks_.empty() || !running_; });
+				// Remaining tasks are executed before exit
+				if (tasks_.empty())
+					return;
+				task = std::move(const_cast<Entry&>(tasks_.top()).task);
+				tasks_.pop();
+			}
+			task();
+		}
+	}
+
+} // namespace scythe
\ No newline at end of file
@@ -1,19 +1,233 @@
 #include <scythe/clock.h>
 
+#include <atomic>
+#include <chrono>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__SIZEOF_INT128__) || defined(_MSC_VER))
+# define SCYTHE_USE_TSC
+# ifdef _MSC_VER
+#  include <intrin.h>
+# else
+#  include <x86intrin.h>
+#  include <cpuid.h>
+# endif
+#endif
+
+static constexpr int64_t kCalibrationTime = 10000000; //!< 10 ms
+
+/**
+ * @brief      Gets the steady clock time.
+ *
+ * @return     The time in nanoseconds.
+ */
+static uint64_t GetSteadyTime()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#ifdef SCYTHE_USE_TSC
+
+/**
+ * @brief      Determines if TSC runs at constant rate in all power states.
+ *
+ * @return     True if TSC is invariant, False otherwise.
+ */
+static bool IsInvariantTsc()
+{
+	unsigned int max_leaf, edx;
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0x80000000);
+	max_leaf = static_cast<unsigned int>(info[0]);
+	if (max_leaf < 0x80000007)
+		return false;
+	__cpuid(info, 0x80000007);
+	edx = static_cast<unsigned int>(info[3]);
+#else
+	unsigned int eax, ebx, ecx;
+	max_leaf = __get_cpuid_max(0x80000000, nullptr);
+	if (max_leaf < 0x80000007 || !__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+		return false;
+#endif
+	return (edx & (1u << 8)) != 0;
+}
+
+/**
+ * @brief      Gets the multiplier that converts TSC ticks to nanoseconds.
+ *
+ * @param[in]  tsc_ticks    The TSC ticks
+ * @param[in]  nanoseconds  The nanoseconds passed
+ *
+ * @return     The multiplier in 32.32 fixed point.
+ */
+static uint64_t GetMultiplier(uint64_t tsc_ticks, uint64_t nanoseconds)
+{
+	return static_cast<uint64_t>(static_cast<double>(nanoseconds) * 4294967296.0 / static_cast<double>(tsc_ticks));
+}
+
+/**
+ * @brief      Multiplies 64-bit values and shifts 128-bit result right by 32 bits.
+ */
+static uint64_t MultiplyShift32(uint64_t a, uint64_t b)
+{
+#ifdef _MSC_VER
+	uint64_t high;
+	const uint64_t low = _umul128(a, b, &high);
+	return __shiftright128(low, high, 32);
+#else
+	return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 32);
+#endif
+}
+
+/**
+ * @brief      Conversion of TSC into nanoseconds.
+ * @details    Short initial calibration gives rate error of about 1e-4, so rate is
+ *             refined against steady clock at growing intervals (1 s, 4 s, 16 s, ...).
+ *             Every refinement starts from the current converted time, so time stays
+ *             continuous. Conversion parameters are guarded by sequence lock.
+ */
+class TscSource
+{
+public:
+	TscSource()
+	: sequence_(0)
+	, base_tsc_(0)
+	, base_time_(0)
+	, multiplier_(0)
+	, next_refine_tsc_(UINT64_MAX)
+	, reference_tsc_(0)
+	, reference_time_(0)
+	, refine_interval_(0)
+	, valid_(false)
+	{
+		if (!::IsInvariantTsc())
+			return;
+
+		// Counters are sampled close to each other at both ends of calibration interval
+		reference_time_ = ::GetSteadyTime();
+		reference_tsc_ = __rdtsc();
+		uint64_t end_time, end_tsc;
+		do
+		{
+			end_time = ::GetSteadyTime();
+			end_tsc = __rdtsc();
+		}
+		while (static_cast<int64_t>(end_time - reference_time_) < kCalibrationTime);
+		if (end_tsc <= reference_tsc_)
+			return;
+
+		const uint64_t multiplier = ::GetMultiplier(end_tsc - reference_tsc_, end_time - reference_time_);
+		base_tsc_.store(end_tsc, std::memory_order_relaxed);
+		base_time_.store(end_time, std::memory_order_relaxed);
+		multiplier_.store(multiplier, std::memory_order_relaxed);
+		refine_interval_ = (end_tsc - reference_tsc_) * (kFirstRefineTime / kCalibrationTime);
+		next_refine_tsc_.store(end_tsc + refine_interval_, std::memory_order_relaxed);
+		valid_ = true;
+	}
+	bool IsValid() const
+	{
+		return valid_;
+	}
+	uint64_t Convert(uint64_t tsc)
+	{
+		if (tsc >= next_refine_tsc_.load(std::memory_order_relaxed))
+			Refine(tsc);
+		uint32_t sequence;
+		uint64_t base_tsc, base_time, multiplier;
+		do
+		{
+			sequence = sequence_.load(std::memory_order_acquire);
+			base_tsc = base_tsc_.load(std::memory_order_relaxed);
+			base_time = base_time_.load(std::memory_order_relaxed);
+			multiplier = multiplier_.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+		}
+		while ((sequence & 1) != 0 || sequence != sequence_.load(std::memory_order_relaxed));
+		// TSC read on other core may be slightly behind the base
+		const uint64_t delta = (tsc > base_tsc) ? tsc - base_tsc : 0;
+		return base_time + ::MultiplyShift32(delta, multiplier);
+	}
+
+private:
+	static constexpr int64_t kFirstRefineTime = 1000000000; //!< 1 s
+
+	void Refine(uint64_t tsc)
+	{
+		// Only one thread refines, others use current parameters
+		uint64_t expected = next_refine_tsc_.load(std::memory_order_relaxed);
+		if (tsc < expected || !next_refine_tsc_.compare_exchange_strong(expected, UINT64_MAX, std::memory_order_acquire))
+			return;
+
+		const uint64_t time = ::GetSteadyTime();
+		const uint64_t now_tsc = __rdtsc();
+		const uint64_t base_tsc = base_tsc_.load(std::memory_order_relaxed);
+		const uint64_t base_time = base_time_.load(std::memory_order_relaxed);
+		const uint64_t old_multiplier = multiplier_.load(std::memory_order_relaxed);
+		const uint64_t current_time = base_time + ::MultiplyShift32(now_tsc - base_tsc, old_multiplier);
+		const uint64_t multiplier = ::GetMultiplier(now_tsc - reference_tsc_, time - reference_time_);
+
+		const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+		sequence_.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		base_tsc_.store(now_tsc, std::memory_order_relaxed);
+		base_time_.store(current_time, std::memory_order_relaxed);
+		multiplier_.store(multiplier, std::memory_order_relaxed);
+		sequence_.store(sequence + 2, std::memory_order_release);
+
+		refine_interval_ *= 4;
+		next_refine_tsc_.store(now_tsc + refine_interval_, std::memory_order_release);
+	}
+
+	std::atomic<uint32_t> sequence_;
+	std::atomic<uint64_t> base_tsc_;
+	std::atomic<uint64_t> base_time_;
+	std::atomic<uint64_t> multiplier_;			//!< nanoseconds per TSC tick in 32.32 fixed point
+	std::atomic<uint64_t> next_refine_tsc_;
+	uint64_t reference_tsc_;					//!< start of initial calibration
+	uint64_t reference_time_;
+	uint64_t refine_interval_;					//!< in TSC ticks (guarded by next refine TSC)
+	bool valid_;
+};
+
+#endif // SCYTHE_USE_TSC
+
 namespace scythe {
 
 	Clock::Clock()
+	: start_ticks_(Now())
 	{
-		end_time_ = start_time_ = clock::now();
 	}
 	void Clock::MakeStartPoint()
 	{
-		start_time_ = clock::now();
+		start_ticks_ = Now();
+	}
+	uint64_t Clock::GetTicks() const
+	{
+		return Now() - start_ticks_;
 	}
 	float Clock::GetTime() const
 	{
-		end_time_ = clock::now();
-		return std::chrono::duration_cast<seconds>(end_time_ - start_time_).count();
+		return ToSeconds(GetTicks());
+	}
+	uint64_t Clock::Now() noexcept
+	{
+#ifdef SCYTHE_USE_TSC
+		static TscSource source;
+		if (source.IsValid())
+			return source.Convert(__rdtsc());
+#endif
+		return ::GetSteadyTime();
+	}
+	float Clock::ToSeconds(uint64_t ticks)
+	{
+		return static_cast<float>(static_cast<double>(ticks) / static_cast<double>(kTicksPerSecond));
+	}
+	uint64_t Clock::FromSeconds(float seconds)
+	{
+		if (!(seconds > 0.0f)) // also filters NaN
+			return 0;
+		return static_cast<uint64_t>(static_cast<double>(seconds) * static_cast<double>(kTicksPerSecond) + 0.5);
 	}
 
 } // namespace scythe
\ No newline at end of file
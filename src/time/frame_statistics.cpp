@@ -0,0 +1,198 @@
+#include <scythe/frame_statistics.h>
+
+#include <cstring>
+#include <cmath>
+
+#ifdef _MSC_VER
+# include <intrin.h>
+#endif
+
+static constexpr float kDefaultHitchThreshold = 0.05f;
+
+/**
+ * @brief      Gets the index of the most significant bit.
+ *
+ * @param[in]  value  The value (non-zero)
+ *
+ * @return     The index of the most significant bit.
+ */
+static uint32_t GetMostSignificantBit(uint32_t value)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanReverse(&index, value);
+	return static_cast<uint32_t>(index);
+#else
+	return 31u - static_cast<uint32_t>(__builtin_clz(value));
+#endif
+}
+
+/**
+ * @brief      Converts seconds to microseconds.
+ *
+ * @param[in]  seconds  The seconds
+ *
+ * @return     The microseconds.
+ */
+static uint32_t SecondsToMicroseconds(float seconds)
+{
+	if (!(seconds > 0.0f)) // also filters NaN
+		return 0u;
+	const float max_value = static_cast<float>((1u << scythe::FrameStatistics::kMaxValueBits) - 1u);
+	return static_cast<uint32_t>(std::fmin(seconds * 1e6f, max_value));
+}
+
+namespace scythe {
+
+	FrameStatistics::FrameStatistics()
+	: hitch_threshold_(::SecondsToMicroseconds(kDefaultHitchThreshold))
+	, dump_callback_(nullptr)
+	, dump_user_data_(nullptr)
+	, dump_period_(0.0f)
+	, dump_time_(0.0f)
+	{
+		Reset();
+	}
+	uint32_t FrameStatistics::GetBucketIndex(uint32_t value)
+	{
+		if (value < kSubBuckets)
+			return value;
+		// Values in range [2^(shift+kSubBucketBits), 2^(shift+kSubBucketBits+1)) share bucket width 2^shift
+		const uint32_t shift = ::GetMostSignificantBit(value) - kSubBucketBits;
+		return (shift + 1) * kSubBuckets + ((value >> shift) - kSubBuckets);
+	}
+	uint32_t FrameStatistics::GetBucketUpperValue(uint32_t index)
+	{
+		if (index < kSubBuckets)
+			return index;
+		const uint32_t shift = index / kSubBuckets - 1;
+		const uint32_t sub_bucket = index % kSubBuckets + kSubBuckets;
+		return ((sub_bucket + 1) << shift) - 1;
+	}
+	void FrameStatistics::AddFrame(float frame_time)
+	{
+		const uint32_t value = ::SecondsToMicroseconds(frame_time);
+		const bool is_hitch = value > hitch_threshold_;
+
+		// Evict the oldest frame from window
+		if (window_count_ == kWindowFrames)
+		{
+			const uint32_t old_value = window_[window_head_];
+			--buckets_[GetBucketIndex(old_value)];
+			window_sum_ -= old_value;
+			if (old_value > hitch_threshold_)
+				--window_hitches_;
+		}
+		else
+			++window_count_;
+
+		window_[window_head_] = value;
+		window_head_ = (window_head_ + 1) % kWindowFrames;
+		++buckets_[GetBucketIndex(value)];
+		window_sum_ += value;
+		++total_frames_;
+		if (is_hitch)
+		{
+			++window_hitches_;
+			++total_hitches_;
+		}
+
+		// Periodic dump
+		if (dump_callback_ != nullptr)
+		{
+			dump_time_ += frame_time;
+			if (dump_time_ >= dump_period_)
+			{
+				dump_time_ = 0.0f;
+				FrameTimeSummary summary;
+				GetSummary(&summary);
+				dump_callback_(summary, dump_user_data_);
+			}
+		}
+	}
+	void FrameStatistics::Reset()
+	{
+		std::memset(buckets_, 0, sizeof(buckets_));
+		std::memset(window_, 0, sizeof(window_));
+		window_head_ = 0;
+		window_count_ = 0;
+		window_hitches_ = 0;
+		window_sum_ = 0;
+		total_frames_ = 0;
+		total_hitches_ = 0;
+		dump_time_ = 0.0f;
+	}
+	void FrameStatistics::SetHitchThreshold(float threshold)
+	{
+		// Window hitches are counted against the new threshold
+		hitch_threshold_ = ::SecondsToMicroseconds(threshold);
+		window_hitches_ = 0;
+		for (uint32_t i = 0; i < window_count_; ++i)
+			if (window_[i] > hitch_threshold_)
+				++window_hitches_;
+	}
+	float FrameStatistics::GetHitchThreshold() const
+	{
+		return static_cast<float>(hitch_threshold_) * 1e-6f;
+	}
+	void FrameStatistics::SetDumpCallback(FrameStatisticsCallback callback, void* user_data, float period)
+	{
+		dump_callback_ = callback;
+		dump_user_data_ = user_data;
+		dump_period_ = period;
+		dump_time_ = 0.0f;
+	}
+	float FrameStatistics::GetPercentile(float percentile) const
+	{
+		if (window_count_ == 0)
+			return 0.0f;
+		if (percentile < 0.0f)
+			percentile = 0.0f;
+		else if (percentile > 100.0f)
+			percentile = 100.0f;
+
+		uint32_t rank = static_cast<uint32_t>(std::ceil(percentile * 0.01f * static_cast<float>(window_count_)));
+		if (rank == 0)
+			rank = 1;
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < kBucketCount; ++i)
+		{
+			count += buckets_[i];
+			if (count >= rank)
+			{
+				// Bucket bound may exceed the actual maximum
+				const float value = static_cast<float>(GetBucketUpperValue(i)) * 1e-6f;
+				const float max_value = GetMaxFrameTime();
+				return (value < max_value) ? value : max_value;
+			}
+		}
+		return GetMaxFrameTime();
+	}
+	float FrameStatistics::GetMaxFrameTime() const
+	{
+		uint32_t max_value = 0;
+		for (uint32_t i = 0; i < window_count_; ++i)
+			if (window_[i] > max_value)
+				max_value = window_[i];
+		return static_cast<float>(max_value) * 1e-6f;
+	}
+	uint64_t FrameStatistics::GetHitchCount() const
+	{
+		return total_hitches_;
+	}
+	void FrameStatistics::GetSummary(FrameTimeSummary* summary) const
+	{
+		summary->p50 = GetPercentile(50.0f);
+		summary->p95 = GetPercentile(95.0f);
+		summary->p99 = GetPercentile(99.0f);
+		summary->max = GetMaxFrameTime();
+		summary->average = (window_count_ != 0)
+			? static_cast<float>(static_cast<double>(window_sum_) / static_cast<double>(window_count_) * 1e-6)
+			: 0.0f;
+		summary->frames = window_count_;
+		summary->hitches = window_hitches_;
+		summary->total_frames = total_frames_;
+		summary->total_hitches = total_hitches_;
+	}
+
+} // namespace scythe
\ No newline at end of file
@@ -1,5 +1,10 @@
 #include <scythe/time_manager.h>
 
+#include <cstring>
+#include <new>
+
+static constexpr uint64_t kWheelTickDuration = 1000000;	//!< timer wheel resolution (1 ms)
+
 namespace scythe {
 
 	const Clock& TimeManager::GetClock() const
@@ -9,78 +14,84 @@ namespace scythe {
 	void TimeManager::SetFixedFrameTime(float fixed_frame_time)
 	{
 		fixed_frame_time_ = fixed_frame_time;
+		fixed_frame_ticks_ = Clock::FromSeconds(fixed_frame_time);
 	}
 	void TimeManager::Update()
 	{
-		float current_time = clock_.GetTime();
-		frame_time_ = current_time - last_time_;
-		last_time_ = current_time;
+		const uint64_t current_ticks = clock_.GetTicks();
+		uint64_t frame_ticks = current_ticks - last_ticks_;
+		last_ticks_ = current_ticks;
+
+		frame_statistics_.AddFrame(Clock::ToSeconds(frame_ticks));
 
 #if defined(_DEBUG) || defined(DEBUG)
 		// Clamp update value when debugging step by step
-		if (frame_time_ > 1.0f)
-			frame_time_ = 0.0166f;
+		if (frame_ticks > Clock::kTicksPerSecond)
+			frame_ticks = Clock::kTicksPerSecond / 60;
 #endif
 
-		// Update all timers
-		Timer * timer = timer_head_;
-		while (timer)
-		{
-			if (timer->enabled_)
-				timer->time_ += frame_time_;
-			timer = timer->next_;
-		}
+		Advance(frame_ticks);
+	}
+	void TimeManager::UpdateFixed()
+	{
+		last_ticks_ += fixed_frame_ticks_;
+		Advance(fixed_frame_ticks_);
+	}
+	void TimeManager::Advance(uint64_t frame_ticks)
+	{
+		frame_ticks_ = frame_ticks;
+
+		timer_ticks_ += frame_ticks;
+		ProcessTimers();
 
 		// Compute current frame rate
-		if (fps_counter_time_ < 1.0f)
+		if (fps_counter_ticks_ < Clock::kTicksPerSecond)
 		{
-			fps_counter_count_ += 1.0f;
-			fps_counter_time_ += frame_time_;
+			++fps_counter_count_;
+			fps_counter_ticks_ += frame_ticks;
 		}
 		else
 		{
-			frame_rate_ = fps_counter_count_ / fps_counter_time_;
-			fps_counter_count_ = 0.0f;
-			fps_counter_time_ = 0.0f;
+			frame_rate_ = static_cast<float>(static_cast<double>(fps_counter_count_) * static_cast<double>(Clock::kTicksPerSecond)
+				/ static_cast<double>(fps_counter_ticks_));
+			fps_counter_count_ = 0;
+			fps_counter_ticks_ = 0;
 		}
 	}
-	Timer * TimeManager::AddTimer(float interval)
+	Timer * TimeManager::AddTimer(float interval, TimerCallback callback, void * user_data, bool repeating)
 	{
-		Timer * timer = new Timer(interval);
-		if (timer == nullptr)
+		void * memory = timer_pool_.Allocate();
+		if (memory == nullptr)
 			return nullptr;
-		timer->next_ = timer_head_;
-		timer_head_ = timer;
+		Timer * timer = new (memory) Timer(this, interval);
+		timer->callback_ = callback;
+		timer->user_data_ = user_data;
+		timer->repeating_ = repeating;
 		return timer;
 	}
 	void TimeManager::RemoveTimer(Timer * removed_timer)
 	{
 		if (removed_timer == nullptr)
 			return;
-		Timer * prev = nullptr;
-		Timer * timer = timer_head_;
-		while (timer)
-		{
-			if (timer == removed_timer)
-			{
-				if (prev)
-					prev->next_ = timer->next_;
-				else
-					timer_head_ = timer->next_;
-				delete timer;
-				break;
-			}
-			prev = timer;
-			timer = timer->next_;
-		}
+		Unschedule(removed_timer);
+		removed_timer->~Timer();
+		timer_pool_.Free(removed_timer);
 	}
 	float TimeManager::GetTime() const
 	{
-		return last_time_;
+		return Clock::ToSeconds(last_ticks_);
+	}
+	uint64_t TimeManager::GetTicks() const
+	{
+		return last_ticks_;
+	}
+	uint64_t TimeManager::GetFrameTicks() const
+	{
+		return frame_ticks_;
 	}
 	float TimeManager::GetFrameTime() const
 	{
-		return frame_time_;
+		return Clock::ToSeconds(frame_ticks_);
 	}
 	float TimeManager::GetFixedFrameTime() const
 	{
@@ -90,27 +101,132 @@ namespace scythe {
 	{
 		return frame_rate_;
 	}
+	FrameStatistics& TimeManager::GetFrameStatistics()
+	{
+		return frame_statistics_;
+	}
+	const FrameStatistics& TimeManager::GetFrameStatistics() const
+	{
+		return frame_statistics_;
+	}
 	TimeManager::TimeManager()
 	: clock_()
-	, timer_head_(nullptr)
+	, frame_statistics_()
+	, expiring_(nullptr)
+	, timer_pool_(sizeof(Timer), alignof(Timer), 256, MemoryTag::kTime)
+	, current_tick_(0)
+	, timer_ticks_(0)
+	, fixed_frame_ticks_(Clock::FromSeconds(1.0f/60.0f))
+	, last_ticks_(0)
+	, frame_ticks_(0)
+	, fps_counter_ticks_(0)
+	, fps_counter_count_(0)
 	, fixed_frame_time_(1.0f/60.0f)
-	, last_time_(0.0f)
-	, frame_time_(0.0f)
 	, frame_rate_(0.0f)
-	, fps_counter_time_(0.0f)
-	, fps_counter_count_(0.0f)
 	{
-
+		std::memset(wheel_, 0, sizeof(wheel_));
 	}
 	TimeManager::~TimeManager()
 	{
-		Timer * timer_to_delete = nullptr;
-		Timer * timer = timer_head_;
-		while (timer)
+		// Timers have trivial destructor, so storage is just freed with the pool
+	}
+	uint64_t TimeManager::GetTimerTicks() const
+	{
+		return timer_ticks_;
+	}
+	void TimeManager::UpdateSchedule(Timer * timer)
+	{
+		Unschedule(timer);
+		if (timer->enabled_ && timer->callback_ != nullptr)
+		{
+			timer->expiration_tick_ = (timer->GetExpirationTicks() + kWheelTickDuration - 1) / kWheelTickDuration;
+			Schedule(timer);
+		}
+	}
+	void TimeManager::Schedule(Timer * timer)
+	{
+		constexpr uint64_t kMaxDelta = (1ull << (kWheelBits * kWheelLevels)) - 1;
+
+		// Timers in the past expire on the next processed tick
+		uint64_t tick = (timer->expiration_tick_ > current_tick_) ? timer->expiration_tick_ : current_tick_;
+		uint64_t delta = tick - current_tick_;
+		if (delta > kMaxDelta)
 		{
-			timer_to_delete = timer;
-			timer = timer->next_;
-			delete timer_to_delete;
+			// Too far timer is put into the last slot and gets rescheduled from there
+			delta = kMaxDelta;
+			tick = current_tick_ + kMaxDelta;
+		}
+		int level = 0;
+		while (level < kWheelLevels - 1 && delta >= (1ull << (kWheelBits * (level + 1))))
+			++level;
+
+		Timer ** link = &wheel_[level][(tick >> (kWheelBits * level)) & (kWheelSize - 1)];
+		timer->next_ = *link;
+		if (timer->next_)
+			timer->next_->link_ = &timer->next_;
+		timer->link_ = link;
+		*link = timer;
+	}
+	void TimeManager::Unschedule(Timer * timer)
+	{
+		if (timer->link_ == nullptr)
+			return;
+		*timer->link_ = timer->next_;
+		if (timer->next_)
+			timer->next_->link_ = timer->link_;
+		timer->next_ = nullptr;
+		timer->link_ = nullptr;
+	}
+	void TimeManager::ProcessTimers()
+	{
+		const uint64_t target_tick = timer_ticks_ / kWheelTickDuration;
+		while (current_tick_ <= target_tick)
+		{
+			const uint64_t tick = current_tick_;
+
+			// When lower level wraps around, timers of the next level slot are moved down
+			for (int level = 1; level < kWheelLevels; ++level)
+			{
+				if ((tick & ((1ull << (kWheelBits * level)) - 1)) != 0)
+					break;
+				Timer ** slot = &wheel_[level][(tick >> (kWheelBits * level)) & (kWheelSize - 1)];
+				Timer * timer = *slot;
+				*slot = nullptr;
+				while (timer)
+				{
+					Timer * next = timer->next_;
+					timer->link_ = nullptr;
+					Schedule(timer);
+					timer = next;
+				}
+			}
+
+			// Callbacks may add and remove timers, so expired ones are unlinked one by one
+			Timer ** slot = &wheel_[0][tick & (kWheelSize - 1)];
+			expiring_ = *slot;
+			*slot = nullptr;
+			if (expiring_)
+				expiring_->link_ = &expiring_;
+			++current_tick_;
+
+			while (expiring_)
+			{
+				Timer * timer = expiring_;
+				Unschedule(timer);
+				if (timer->expiration_tick_ > tick)
+				{
+					Schedule(timer);
+					continue;
+				}
+				if (timer->repeating_)
+				{
+					// Next period starts at expiration time, so it doesn't drift
+					timer->start_ticks_ = timer->GetExpirationTicks();
+					timer->elapsed_ticks_ = 0;
+					UpdateSchedule(timer);
+				}
+				timer->callback_(timer, timer->user_data_);
+			}
 		}
 	}
 
@@ -1,22 +1,33 @@
 #include <scythe/timer.h>
+#include <scythe/time_manager.h>
 
 namespace scythe {
 
 	void Timer::Reset()
 	{
-		time_ = 0.0f;
+		elapsed_ticks_ = 0;
+		start_ticks_ = manager_->GetTimerTicks();
+		manager_->UpdateSchedule(this);
 	}
 	void Timer::Start()
 	{
+		if (enabled_)
+			return;
 		enabled_ = true;
+		start_ticks_ = manager_->GetTimerTicks();
+		manager_->UpdateSchedule(this);
 	}
 	void Timer::Stop()
 	{
+		if (!enabled_)
+			return;
+		elapsed_ticks_ = GetElapsedTicks();
 		enabled_ = false;
+		manager_->UpdateSchedule(this);
 	}
 	bool Timer::IsExpired() const
 	{
-		return time_ >= interval_;
+		return GetElapsedTicks() >= interval_ticks_;
 	}
 	bool Timer::IsEnabled() const
 	{
@@ -24,17 +35,50 @@ namespace scythe {
 	}
 	float Timer::GetInterval() const
 	{
-		return interval_;
+		return Clock::ToSeconds(interval_ticks_);
 	}
 	float Timer::GetTime() const
 	{
-		return time_;
+		return Clock::ToSeconds(GetElapsedTicks());
 	}
-	Timer::Timer(float interval)
-	: next_(nullptr)
-	, interval_(interval)
-	, time_(0.0f)
+	void Timer::SetCallback(TimerCallback callback, void* user_data)
+	{
+		callback_ = callback;
+		user_data_ = user_data;
+		manager_->UpdateSchedule(this);
+	}
+	void Timer::SetRepeating(bool repeating)
+	{
+		repeating_ = repeating;
+	}
+	bool Timer::IsRepeating() const
+	{
+		return repeating_;
+	}
+	uint64_t Timer::GetElapsedTicks() const
+	{
+		// Elapsed time is computed on demand, so timers aren't touched every frame
+		if (enabled_)
+			return elapsed_ticks_ + (manager_->GetTimerTicks() - start_ticks_);
+		else
+			return elapsed_ticks_;
+	}
+	uint64_t Timer::GetExpirationTicks() const
+	{
+		return start_ticks_ + ((interval_ticks_ > elapsed_ticks_) ? interval_ticks_ - elapsed_ticks_ : 0);
+	}
+	Timer::Timer(TimeManager * manager, float interval)
+	: manager_(manager)
+	, next_(nullptr)
+	, link_(nullptr)
+	, callback_(nullptr)
+	, user_data_(nullptr)
+	, expiration_tick_(0)
+	, start_ticks_(0)
+	, interval_ticks_(Clock::FromSeconds(interval))
+	, elapsed_ticks_(0)
 	, enabled_(false)
+	, repeating_(false)
 	{
 	}
 	Timer::~Timer()
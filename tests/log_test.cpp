@@ -0,0 +1,103 @@
+#include <scythe/log.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static constexpr int kMessagesCount = 2000; // enough to wrap thread queue several times
+static constexpr int kFlushPeriod = 50;
+
+static std::string MakeString(int index)
+{
+	return std::string(static_cast<size_t>(index % 61), static_cast<char>('a' + index % 26));
+}
+
+static void LogBinaryMessages()
+{
+	for (int i = 0; i < kMessagesCount; ++i)
+	{
+		const std::string str = ::MakeString(i);
+		SCYTHE_LOG_BINARY(scythe::LogLevel::kInfo, "%d %s", i, str.c_str());
+		if ((i + 1) % kFlushPeriod == 0)
+			scythe::FlushLog();
+	}
+	scythe::FlushLog();
+}
+
+TEST(Log, BinaryMessagesWrapQueue)
+{
+	const char* filename = "log_test.txt";
+	scythe::SetLogRateLimit(0);
+	ASSERT_TRUE(scythe::SetLogFile(filename));
+	::LogBinaryMessages();
+	scythe::SetLogFile(nullptr);
+	scythe::SetLogRateLimit(100);
+
+	std::ifstream file(filename);
+	std::string line;
+	int count = 0;
+	while (std::getline(file, line))
+	{
+		const std::string expected = "[info] " + std::to_string(count) + " " + ::MakeString(count);
+		ASSERT_GE(line.size(), expected.size());
+		EXPECT_EQ(line.substr(line.size() - expected.size()), expected);
+		++count;
+	}
+	file.close();
+	std::remove(filename);
+	EXPECT_EQ(count, kMessagesCount);
+}
+
+TEST(Log, BinaryFileHasExactDataSize)
+{
+	const char* filename = "log_test.bin";
+	scythe::SetLogRateLimit(0);
+	ASSERT_TRUE(scythe::SetBinaryLogFile(filename));
+	::LogBinaryMessages();
+	scythe::SetBinaryLogFile(nullptr);
+	scythe::SetLogRateLimit(100);
+
+	std::ifstream file(filename, std::ios::binary);
+	std::vector<char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	file.close();
+	std::remove(filename);
+
+	const size_t kHeaderSize = sizeof(scythe::kBinaryLogMagic) + sizeof(uint32_t) * 2;
+	ASSERT_GE(contents.size(), kHeaderSize);
+	const char* data = contents.data() + kHeaderSize;
+	const char* end = contents.data() + contents.size();
+	int count = 0;
+	while (data < end)
+	{
+		const uint8_t type = static_cast<uint8_t>(*data);
+		if (type == static_cast<uint8_t>(scythe::BinaryLogRecord::kFormat))
+		{
+			uint16_t format_length, signature_length;
+			std::memcpy(&format_length, data + 5, sizeof(format_length));
+			std::memcpy(&signature_length, data + 7, sizeof(signature_length));
+			data += 9 + format_length + signature_length;
+			continue;
+		}
+		ASSERT_EQ(type, static_cast<uint8_t>(scythe::BinaryLogRecord::kMessage));
+		uint16_t size;
+		std::memcpy(&size, data + 14, sizeof(size));
+		data += 16;
+		ASSERT_LE(data + size, end);
+
+		// Packed int, string length, string and terminating zero
+		const std::string str = ::MakeString(count);
+		ASSERT_EQ(size, sizeof(int) + sizeof(uint32_t) + str.size() + 1);
+		int value;
+		std::memcpy(&value, data, sizeof(value));
+		EXPECT_EQ(value, count);
+		EXPECT_EQ(std::string(data + sizeof(int) + sizeof(uint32_t), str.size()), str);
+		data += size;
+		++count;
+	}
+	EXPECT_EQ(count, kMessagesCount);
+}
\ No newline at end of file
@@ -0,0 +1,186 @@
+// Compares allocation latency of scythe::TlsfAllocator and the system allocator.
+// Usage: allocator_benchmark [operations count] [maximum live allocations]
+
+#include <scythe/tlsf_allocator.h>
+#include <scythe/clock.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/**
+ * @brief      Single operation of the workload.
+ */
+struct Operation
+{
+	size_t size;		//!< allocation size or 0 for freeing
+	size_t slot;		//!< index of live allocation
+};
+
+/**
+ * @brief      Latency statistics in nanoseconds.
+ */
+struct Latency
+{
+	double mean;
+	uint64_t p50;
+	uint64_t p99;
+	uint64_t p999;
+	uint64_t max;
+};
+
+/**
+ * @brief      Generates reproducible workload of mixed small and large allocations.
+ *
+ * @param[in]  count      The operations count
+ * @param[in]  max_live   The maximum live allocations
+ *
+ * @return     The operations.
+ */
+static std::vector<Operation> GenerateWorkload(size_t count, size_t max_live)
+{
+	std::mt19937 random(12345);
+	std::vector<Operation> operations;
+	operations.reserve(count);
+	std::vector<size_t> live_slots;
+	std::vector<size_t> free_slots;
+	for (size_t i = max_live; i > 0; --i)
+		free_slots.push_back(i - 1);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const bool allocate = live_slots.empty() || (!free_slots.empty() && random() % 2 == 0);
+		Operation operation;
+		if (allocate)
+		{
+			// Mostly small objects with occasional big buffers
+			const uint32_t kind = random() % 100;
+			operation.size = (kind < 80) ? 16 + random() % 256
+				: (kind < 98) ? 256 + random() % 4096
+				: 4096 + random() % (256 * 1024);
+			operation.slot = free_slots.back();
+			free_slots.pop_back();
+			live_slots.push_back(operation.slot);
+		}
+		else
+		{
+			const size_t index = random() % live_slots.size();
+			operation.size = 0;
+			operation.slot = live_slots[index];
+			live_slots[index] = live_slots.back();
+			live_slots.pop_back();
+			free_slots.push_back(operation.slot);
+		}
+		operations.push_back(operation);
+	}
+	// Everything is freed at the end
+	for (size_t slot : live_slots)
+		operations.push_back(Operation{0, slot});
+	return operations;
+}
+
+/**
+ * @brief      Runs workload and measures every operation.
+ *
+ * @param[in]  operations  The operations
+ * @param[in]  max_live    The maximum live allocations
+ * @param[in]  allocate    The allocation function
+ * @param[in]  free        The free function
+ * @param      latencies   The latencies of operations
+ */
+template <class AllocateFunc, class FreeFunc>
+static void RunWorkload(const std::vector<Operation>& operations, size_t max_live,
+	AllocateFunc allocate, FreeFunc free, std::vector<uint64_t>* latencies)
+{
+	std::vector<void *> slots(max_live, nullptr);
+	latencies->clear();
+	latencies->reserve(operations.size());
+	for (const Operation& operation : operations)
+	{
+		const uint64_t start = scythe::Clock::Now();
+		if (operation.size != 0)
+			slots[operation.slot] = allocate(operation.size);
+		else
+			free(slots[operation.slot]);
+		const uint64_t end = scythe::Clock::Now();
+		latencies->push_back(end - start);
+
+		// Touch memory like a real user would
+		if (operation.size != 0 && slots[operation.slot] != nullptr)
+			static_cast<char *>(slots[operation.slot])[0] = 1;
+	}
+}
+
+/**
+ * @brief      Calculates latency statistics.
+ *
+ * @param      latencies  The latencies (get sorted)
+ *
+ * @return     The latency statistics.
+ */
+static Latency CalculateLatency(std::vector<uint64_t>& latencies)
+{
+	Latency latency = {};
+	if (latencies.empty())
+		return latency;
+	std::sort(latencies.begin(), latencies.end());
+	double sum = 0.0;
+	for (uint64_t value : latencies)
+		sum += static_cast<double>(value);
+	const size_t last = latencies.size() - 1;
+	latency.mean = sum / static_cast<double>(latencies.size());
+	latency.p50 = latencies[last * 50 / 100];
+	latency.p99 = latencies[last * 99 / 100];
+	latency.p999 = latencies[last * 999 / 1000];
+	latency.max = latencies[last];
+	return latency;
+}
+
+/**
+ * @brief      Prints latency statistics row.
+ *
+ * @param[in]  name     The allocator name
+ * @param[in]  latency  The latency
+ */
+static void PrintLatency(const char* name, const Latency& latency)
+{
+	std::printf("%-10s %10.1f %10llu %10llu %10llu %12llu\n", name, latency.mean,
+		static_cast<unsigned long long>(latency.p50), static_cast<unsigned long long>(latency.p99),
+		static_cast<unsigned long long>(latency.p999), static_cast<unsigned long long>(latency.max));
+}
+
+int main(int argc, char** argv)
+{
+	const size_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	const size_t max_live = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 10000;
+	if (count == 0 || max_live == 0)
+	{
+		std::fprintf(stderr, "Usage: %s [operations count] [maximum live allocations]\n", argv[0]);
+		return 1;
+	}
+
+	const std::vector<Operation> operations = ::GenerateWorkload(count, max_live);
+	std::vector<uint64_t> latencies;
+
+	std::printf("%zu operations, up to %zu live allocations, latency in ns\n", operations.size(), max_live);
+	std::printf("%-10s %10s %10s %10s %10s %12s\n", "allocator", "mean", "p50", "p99", "p99.9", "max");
+
+	// Every workload is run twice and the second run is measured, so page faults are excluded
+	auto system_allocate = [](size_t size) { return std::malloc(size); };
+	auto system_free = [](void* memory) { std::free(memory); };
+	::RunWorkload(operations, max_live, system_allocate, system_free, &latencies);
+	::RunWorkload(operations, max_live, system_allocate, system_free, &latencies);
+	::PrintLatency("system", ::CalculateLatency(latencies));
+
+	// Region is created beforehand, so that measured operations never grow the heap
+	scythe::TlsfAllocator heap(max_live * 8 * 1024, true);
+	auto tlsf_allocate = [&heap](size_t size) { return heap.Allocate(size); };
+	auto tlsf_free = [&heap](void* memory) { heap.Free(memory); };
+	::RunWorkload(operations, max_live, tlsf_allocate, tlsf_free, &latencies);
+	::RunWorkload(operations, max_live, tlsf_allocate, tlsf_free, &latencies);
+	::PrintLatency("tlsf", ::CalculateLatency(latencies));
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,429 @@
+// Converts binary log written by scythe::SetBinaryLogFile into text.
+// Usage: log_decoder <binary log> [output text file]
+
+#include <scythe/log.h>
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+static const char* kLevelNames[] = {
+	"debug",
+	"info",
+	"warning",
+	"error",
+};
+
+/**
+ * @brief      Registered message format.
+ */
+struct Format
+{
+	std::string format;
+	std::string signature;
+};
+
+/**
+ * @brief      Decoded argument value.
+ */
+struct Value
+{
+	char code;
+	int64_t signed_value;
+	uint64_t unsigned_value;
+	double double_value;
+	const char* string_value;
+};
+
+/**
+ * @brief      Sequential reader of memory.
+ */
+class Reader
+{
+public:
+	Reader(const char* data, size_t size)
+	: data_(data)
+	, size_(size)
+	, position_(0)
+	{
+	}
+	bool Read(void* value, size_t size)
+	{
+		if (position_ + size > size_)
+			return false;
+		std::memcpy(value, data_ + position_, size);
+		position_ += size;
+		return true;
+	}
+	const char* Skip(size_t size)
+	{
+		if (position_ + size > size_)
+			return nullptr;
+		const char* data = data_ + position_;
+		position_ += size;
+		return data;
+	}
+	bool IsEnd() const
+	{
+		return position_ >= size_;
+	}
+
+private:
+	const char* data_;
+	size_t size_;
+	size_t position_;
+};
+
+/**
+ * @brief      Reads argument value of the type code.
+ *
+ * @param      reader        The arguments reader
+ * @param[in]  code          The type code
+ * @param[in]  pointer_size  The pointer size of the writer
+ * @param      value         The value
+ *
+ * @return     True on success and false otherwise.
+ */
+static bool ReadValue(Reader& reader, char code, uint32_t pointer_size, Value* value)
+{
+	value->code = code;
+	value->signed_value = 0;
+	value->unsigned_value = 0;
+	value->double_value = 0.0;
+	value->string_value = "";
+	switch (code)
+	{
+	case 'b': { int8_t v; if (!reader.Read(&v, sizeof(v))) return false; value->signed_value = v; break; }
+	case 'B': { uint8_t v; if (!reader.Read(&v, sizeof(v))) return false; value->unsigned_value = v; break; }
+	case 'h': { int16_t v; if (!reader.Read(&v, sizeof(v))) return false; value->signed_value = v; break; }
+	case 'H': { uint16_t v; if (!reader.Read(&v, sizeof(v))) return false; value->unsigned_value = v; break; }
+	case 'i': { int32_t v; if (!reader.Read(&v, sizeof(v))) return false; value->signed_value = v; break; }
+	case 'I': { uint32_t v; if (!reader.Read(&v, sizeof(v))) return false; value->unsigned_value = v; break; }
+	case 'q': { int64_t v; if (!reader.Read(&v, sizeof(v))) return false; value->signed_value = v; break; }
+	case 'Q': { uint64_t v; if (!reader.Read(&v, sizeof(v))) return false; value->unsigned_value = v; break; }
+	case 'f': { float v; if (!reader.Read(&v, sizeof(v))) return false; value->double_value = v; break; }
+	case 'd': { double v; if (!reader.Read(&v, sizeof(v))) return false; value->double_value = v; break; }
+	case 'p':
+		if (pointer_size == 4)
+		{
+			uint32_t v;
+			if (!reader.Read(&v, sizeof(v))) return false;
+			value->unsigned_value = v;
+		}
+		else
+		{
+			uint64_t v;
+			if (!reader.Read(&v, sizeof(v))) return false;
+			value->unsigned_value = v;
+		}
+		break;
+	case 's':
+	{
+		// Length, characters and terminating zero
+		uint32_t length;
+		if (!reader.Read(&length, sizeof(length)))
+			return false;
+		value->string_value = reader.Skip(length + 1);
+		if (value->string_value == nullptr)
+			return false;
+		break;
+	}
+	default:
+		return false;
+	}
+	// Integers are converted to each other like printf does with mismatched types
+	if (code == 'b' || code == 'h' || code == 'i' || code == 'q')
+		value->unsigned_value = static_cast<uint64_t>(value->signed_value);
+	else
+		value->signed_value = static_cast<int64_t>(value->unsigned_value);
+	return true;
+}
+
+/**
+ * @brief      Appends formatted value to string.
+ *
+ * @param      out    The output string
+ * @param[in]  spec   The conversion specification
+ * @param[in]  value  The value
+ */
+template <typename T>
+static void AppendFormatted(std::string* out, const std::string& spec, T value)
+{
+	const int length = std::snprintf(nullptr, 0, spec.c_str(), value);
+	if (length <= 0)
+		return;
+	const size_t offset = out->size();
+	out->resize(offset + static_cast<size_t>(length) + 1);
+	std::snprintf(&(*out)[offset], static_cast<size_t>(length) + 1, spec.c_str(), value);
+	out->resize(offset + static_cast<size_t>(length));
+}
+
+/**
+ * @brief      Formats message like printf does.
+ * @details    Every conversion is formatted separately with length modifier
+ *             replaced by one that matches decoded value.
+ *
+ * @param[in]  format        The format
+ * @param[in]  data          The packed arguments
+ * @param[in]  size          The packed arguments size
+ * @param[in]  pointer_size  The pointer size of the writer
+ * @param      out           The output string
+ */
+static void FormatBinaryMessage(const Format& format, const char* data, size_t size, uint32_t pointer_size, std::string* out)
+{
+	Reader reader(data, size);
+	size_t argument = 0;
+	auto next_value = [&](Value* value) -> bool {
+		if (argument >= format.signature.size())
+			return false;
+		return ::ReadValue(reader, format.signature[argument++], pointer_size, value);
+	};
+
+	out->clear();
+	for (const char* p = format.format.c_str(); *p != '\0'; ++p)
+	{
+		if (*p != '%')
+		{
+			out->push_back(*p);
+			continue;
+		}
+		if (p[1] == '%')
+		{
+			out->push_back('%');
+			++p;
+			continue;
+		}
+
+		std::string spec("%");
+		++p;
+		while (*p != '\0' && std::strchr("-+ #0", *p) != nullptr)
+			spec.push_back(*p++);
+		// Width and precision may be passed as arguments
+		for (int part = 0; part < 2; ++part)
+		{
+			if (part == 1)
+			{
+				if (*p != '.')
+					break;
+				spec.push_back(*p++);
+			}
+			if (*p == '*')
+			{
+				Value value;
+				if (!next_value(&value))
+				{
+					*out += "<missing argument>";
+					return;
+				}
+				spec += std::to_string(value.signed_value);
+				++p;
+			}
+			else
+			{
+				while (std::isdigit(static_cast<unsigned char>(*p)))
+					spec.push_back(*p++);
+			}
+		}
+		while (*p != '\0' && std::strchr("hljztL", *p) != nullptr)
+			++p;
+		const char conversion = *p;
+		if (conversion == '\0')
+			break;
+		if (conversion == 'n')
+			continue;
+
+		Value value;
+		if (!next_value(&value))
+		{
+			*out += "<missing argument>";
+			return;
+		}
+		switch (conversion)
+		{
+		case 'd':
+		case 'i':
+			spec += "lld";
+			::AppendFormatted(out, spec, static_cast<long long>(value.signed_value));
+			break;
+		case 'o':
+		case 'u':
+		case 'x':
+		case 'X':
+			spec += "ll";
+			spec.push_back(conversion);
+			::AppendFormatted(out, spec, static_cast<unsigned long long>(value.unsigned_value));
+			break;
+		case 'c':
+			spec.push_back('c');
+			::AppendFormatted(out, spec, static_cast<int>(value.signed_value));
+			break;
+		case 'e':
+		case 'E':
+		case 'f':
+		case 'F':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+			spec.push_back(conversion);
+			::AppendFormatted(out, spec, value.double_value);
+			break;
+		case 's':
+			spec.push_back('s');
+			::AppendFormatted(out, spec, (value.code == 's') ? value.string_value : "<not a string>");
+			break;
+		case 'p':
+			// Pointer of the writer may not fit into pointer of the decoder
+			spec += "#llx";
+			::AppendFormatted(out, spec, static_cast<unsigned long long>(value.unsigned_value));
+			break;
+		default:
+			spec.push_back(conversion);
+			*out += spec;
+			break;
+		}
+	}
+	while (!out->empty() && (out->back() == '\n' || out->back() == '\r'))
+		out->pop_back();
+}
+
+/**
+ * @brief      Reads whole file.
+ *
+ * @param[in]  filename  The filename
+ * @param      data      The data
+ *
+ * @return     True on success and false otherwise.
+ */
+static bool ReadFile(const char* filename, std::vector<char>* data)
+{
+	FILE* file = std::fopen(filename, "rb");
+	if (!file)
+		return false;
+	char buffer[1 << 16];
+	size_t count;
+	while ((count = std::fread(buffer, 1, sizeof(buffer), file)) != 0)
+		data->insert(data->end(), buffer, buffer + count);
+	std::fclose(file);
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2 || argc > 3)
+	{
+		std::fprintf(stderr, "Usage: %s <binary log> [output file]\n", argv[0]);
+		return 1;
+	}
+
+	std::vector<char> data;
+	if (!::ReadFile(argv[1], &data))
+	{
+		std::fprintf(stderr, "Failed to read file %s\n", argv[1]);
+		return 1;
+	}
+	Reader reader(data.data(), data.size());
+
+	char magic[sizeof(scythe::kBinaryLogMagic)];
+	uint32_t version = 0;
+	uint32_t pointer_size = 0;
+	if (!reader.Read(magic, sizeof(magic)) ||
+		std::memcmp(magic, scythe::kBinaryLogMagic, sizeof(magic)) != 0 ||
+		!reader.Read(&version, sizeof(version)) ||
+		!reader.Read(&pointer_size, sizeof(pointer_size)))
+	{
+		std::fprintf(stderr, "%s is not a binary log\n", argv[1]);
+		return 1;
+	}
+	if (version != scythe::kBinaryLogVersion)
+	{
+		std::fprintf(stderr, "Unsupported binary log version %u\n", version);
+		return 1;
+	}
+
+	FILE* output = stdout;
+	if (argc == 3)
+	{
+		output = std::fopen(argv[2], "w");
+		if (!output)
+		{
+			std::fprintf(stderr, "Failed to open file %s\n", argv[2]);
+			return 1;
+		}
+	}
+
+	std::unordered_map<scythe::StringID, Format> formats;
+	std::string message;
+	bool corrupted = false;
+	while (!reader.IsEnd())
+	{
+		uint8_t type;
+		scythe::StringID id;
+		if (!reader.Read(&type, sizeof(type)) || !reader.Read(&id, sizeof(id)))
+		{
+			corrupted = true;
+			break;
+		}
+		if (type == static_cast<uint8_t>(scythe::BinaryLogRecord::kFormat))
+		{
+			uint16_t format_length, signature_length;
+			const char* format_data;
+			const char* signature_data;
+			if (!reader.Read(&format_length, sizeof(format_length)) ||
+				!reader.Read(&signature_length, sizeof(signature_length)) ||
+				(format_data = reader.Skip(format_length)) == nullptr ||
+				(signature_data = reader.Skip(signature_length)) == nullptr)
+			{
+				corrupted = true;
+				break;
+			}
+			Format& format = formats[id];
+			format.format.assign(format_data, format_length);
+			format.signature.assign(signature_data, signature_length);
+		}
+		else if (type == static_cast<uint8_t>(scythe::BinaryLogRecord::kMessage))
+		{
+			uint8_t level;
+			uint64_t timestamp;
+			uint16_t size;
+			const char* arguments;
+			if (!reader.Read(&level, sizeof(level)) ||
+				!reader.Read(&timestamp, sizeof(timestamp)) ||
+				!reader.Read(&size, sizeof(size)) ||
+				(arguments = reader.Skip(size)) == nullptr)
+			{
+				corrupted = true;
+				break;
+			}
+			auto it = formats.find(id);
+			if (it != formats.end())
+				::FormatBinaryMessage(it->second, arguments, size, pointer_size, &message);
+			else
+			{
+				char buffer[64];
+				std::snprintf(buffer, sizeof(buffer), "<unknown format 0x%08X>", id);
+				message = buffer;
+			}
+			const char* level_name = (level < _countof(kLevelNames)) ? kLevelNames[level] : "unknown";
+			std::fprintf(output, "[%10.4f] [%s] %s\n", static_cast<double>(timestamp) * 1e-9, level_name, message.c_str());
+		}
+		else
+		{
+			corrupted = true;
+			break;
+		}
+	}
+
+	if (output != stdout)
+		std::fclose(output);
+	if (corrupted)
+	{
+		// Log may be truncated if application has crashed
+		std::fprintf(stderr, "Binary log is truncated or corrupted\n");
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+// Builds package file read by scythe::Package.
+// Usage: package_builder [-c] <output package> <[name=]file>...
+// Blob name defaults to the file path as given, blob is found by RuntimeStringId(name).
+// With -c blobs are compressed by independent LZ4 blocks unless that doesn't save space.
+
+#include <scythe/package.h>
+#include <scythe/endianness.h>
+#include <scythe/lz4.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * @brief      Input file of the package.
+ */
+struct Input
+{
+	std::string name;
+	std::string filename;
+	scythe::StringID string_id;
+	std::vector<char> data;
+	std::vector<char> stored;	//!< compressed blob or empty
+};
+
+/**
+ * @brief      Reads the whole file.
+ *
+ * @param[in]  filename  The filename
+ * @param      data      The data
+ *
+ * @return     True on success and false otherwise.
+ */
+static bool ReadFile(const char* filename, std::vector<char>& data)
+{
+	FILE * file = fopen(filename, "rb");
+	if (file == nullptr)
+		return false;
+	fseek(file, 0, SEEK_END);
+	const long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	bool result = size >= 0;
+	if (result)
+	{
+		data.resize(static_cast<size_t>(size));
+		result = fread(data.data(), 1, data.size(), file) == data.size();
+	}
+	fclose(file);
+	return result;
+}
+
+/**
+ * @brief      Compresses data by independent blocks.
+ *
+ * @param[in]  data        The data
+ * @param[in]  block_size  The block size
+ * @param      stored      Blocks ends table followed by blocks
+ */
+static void Compress(const std::vector<char>& data, size_t block_size, std::vector<char>& stored)
+{
+	const size_t blocks_count = (data.size() + block_size - 1) / block_size;
+	std::vector<uint32_t> block_ends(blocks_count);
+	std::vector<char> blocks;
+	std::vector<char> buffer(scythe::Lz4CompressBound(block_size));
+	for (size_t i = 0; i < blocks_count; ++i)
+	{
+		const char* block = data.data() + i * block_size;
+		const size_t size = std::min(block_size, data.size() - i * block_size);
+		size_t compressed_size = scythe::Lz4Compress(block, size, buffer.data(), buffer.size());
+		// Incompressible block is stored as is
+		if (compressed_size == 0 || compressed_size >= size)
+			blocks.insert(blocks.end(), block, block + size);
+		else
+			blocks.insert(blocks.end(), buffer.data(), buffer.data() + compressed_size);
+		block_ends[i] = static_cast<uint32_t>(blocks.size());
+	}
+	stored.resize(block_ends.size() * sizeof(uint32_t));
+	if (!block_ends.empty())
+		memcpy(stored.data(), block_ends.data(), stored.size());
+	stored.insert(stored.end(), blocks.begin(), blocks.end());
+}
+
+/**
+ * @brief      Writes zero bytes up to the offset.
+ *
+ * @param      file     The file
+ * @param[in]  current  The current offset
+ * @param[in]  offset   The target offset
+ *
+ * @return     True on success and false otherwise.
+ */
+static bool WritePadding(FILE * file, uint64_t current, uint64_t offset)
+{
+	static const char kZeros[scythe::kPackageAlignment] = {};
+	while (current < offset)
+	{
+		const size_t size = static_cast<size_t>(std::min<uint64_t>(offset - current, sizeof(kZeros)));
+		if (fwrite(kZeros, 1, size, file) != size)
+			return false;
+		current += size;
+	}
+	return true;
+}
+
+int main(int argc, char const** argv)
+{
+	const bool compress = argc > 1 && strcmp(argv[1], "-c") == 0;
+	if (compress)
+	{
+		--argc;
+		++argv;
+	}
+	if (argc < 3)
+	{
+		printf("Usage: package_builder [-c] <output package> <[name=]file>...\n");
+		return 1;
+	}
+	if (!scythe::IsLittleEndian())
+	{
+		fprintf(stderr, "Big endian platforms aren't supported\n");
+		return 1;
+	}
+
+	std::vector<Input> inputs(static_cast<size_t>(argc - 2));
+	for (int i = 2; i < argc; ++i)
+	{
+		Input& input = inputs[i - 2];
+		const char* separator = strchr(argv[i], '=');
+		input.name = (separator != nullptr) ? std::string(argv[i], separator) : std::string(argv[i]);
+		input.filename = (separator != nullptr) ? std::string(separator + 1) : std::string(argv[i]);
+		input.string_id = RuntimeStringId(input.name.c_str());
+		if (!ReadFile(input.filename.c_str(), input.data))
+		{
+			fprintf(stderr, "Can't read file '%s'\n", input.filename.c_str());
+			return 1;
+		}
+		if (compress)
+		{
+			Compress(input.data, scythe::kPackageBlockSize, input.stored);
+			if (input.stored.size() >= input.data.size())
+				input.stored.clear();
+		}
+	}
+
+	// Table of contents is sorted for binary search
+	std::sort(inputs.begin(), inputs.end(), [](const Input& a, const Input& b) {
+		return a.string_id < b.string_id;
+	});
+	for (size_t i = 1; i < inputs.size(); ++i)
+	{
+		if (inputs[i - 1].string_id == inputs[i].string_id)
+		{
+			fprintf(stderr, "Names '%s' and '%s' have the same string id\n", inputs[i - 1].name.c_str(), inputs[i].name.c_str());
+			return 1;
+		}
+	}
+
+	// Blobs follow the table of contents and are aligned
+	const uint64_t kAlignment = scythe::kPackageAlignment;
+	scythe::PackageHeader header;
+	header.magic = scythe::kPackageMagic;
+	header.version = scythe::kPackageVersion;
+	header.entries_count = static_cast<uint32_t>(inputs.size());
+	header.alignment = scythe::kPackageAlignment;
+	header.block_size = scythe::kPackageBlockSize;
+	header.reserved = 0;
+	std::vector<scythe::PackageEntry> entries(inputs.size());
+	uint64_t offset = sizeof(scythe::PackageHeader) + sizeof(scythe::PackageEntry) * entries.size();
+	for (size_t i = 0; i < inputs.size(); ++i)
+	{
+		offset = (offset + kAlignment - 1) & ~(kAlignment - 1);
+		const bool compressed = !inputs[i].stored.empty();
+		entries[i].string_id = inputs[i].string_id;
+		entries[i].flags = compressed ? static_cast<uint32_t>(scythe::kPackageEntryCompressed) : 0u;
+		entries[i].offset = offset;
+		entries[i].size = inputs[i].data.size();
+		entries[i].stored_size = compressed ? inputs[i].stored.size() : inputs[i].data.size();
+		offset += entries[i].stored_size;
+	}
+
+	FILE * file = fopen(argv[1], "wb");
+	if (file == nullptr)
+	{
+		fprintf(stderr, "Can't open file '%s' for writing\n", argv[1]);
+		return 1;
+	}
+	bool result = fwrite(&header, sizeof(header), 1, file) == 1 &&
+		(entries.empty() || fwrite(entries.data(), sizeof(scythe::PackageEntry), entries.size(), file) == entries.size());
+	uint64_t current = sizeof(scythe::PackageHeader) + sizeof(scythe::PackageEntry) * entries.size();
+	for (size_t i = 0; result && i < inputs.size(); ++i)
+	{
+		const std::vector<char>& data = inputs[i].stored.empty() ? inputs[i].data : inputs[i].stored;
+		result = WritePadding(file, current, entries[i].offset) &&
+			(data.empty() || fwrite(data.data(), 1, data.size(), file) == data.size());
+		current = entries[i].offset + entries[i].stored_size;
+	}
+	result = (fclose(file) == 0) && result;
+	if (!result)
+	{
+		fprintf(stderr, "Can't write file '%s'\n", argv[1]);
+		return 1;
+	}
+	printf("%zu blobs, %llu bytes\n", inputs.size(), static_cast<unsigned long long>(current));
+	return 0;
+}
\ No newline at end of file